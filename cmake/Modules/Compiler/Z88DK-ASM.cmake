@@ -15,3 +15,12 @@ set(CMAKE_C_LINK_EXECUTABLE
     set(CMAKE_ASM_LINK_EXECUTABLE "<CMAKE_ASM_COMPILER> <LINK_FLAGS> <LINK_LIBRARIES> -b -o<TARGET> <OBJECTS>")
 
 set(CMAKE_EXECUTABLE_SUFFIX ".bin")
+
+# Libraries are archives of object files, only the modules referenced by a program get linked
+set(CMAKE_ASM_CREATE_STATIC_LIBRARY
+      "\"${CMAKE_COMMAND}\" -E remove <TARGET>"
+      "<CMAKE_ASM_COMPILER> -x<TARGET> <OBJECTS>")
+set(CMAKE_STATIC_LIBRARY_PREFIX "")
+set(CMAKE_STATIC_LIBRARY_SUFFIX ".lib")
+# Libraries built by CMake are given to the linker with their full path
+set(CMAKE_LINK_LIBRARY_FILE_FLAG "-l")
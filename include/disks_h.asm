@@ -21,14 +21,23 @@
         EXTERN zos_disk_read
         EXTERN zos_disk_write
         EXTERN zos_disk_seek
+        EXTERN zos_disk_preallocate
         EXTERN zos_disk_stat
         EXTERN zos_disk_close
         EXTERN zos_disk_is_opnfile
         EXTERN zos_disk_is_opndir
         EXTERN zos_disk_is_opn_filedir
         EXTERN zos_disks_mount
+        EXTERN zos_disks_mount_lazy
         EXTERN zos_disk_opendir
         EXTERN zos_disk_allocate_opndir
+    IF CONFIG_KERNEL_OPENED_FILES_POOL
+        EXTERN zos_disks_pool_trim
+        ; Maximum number of opened files, including the pool, only known at link time
+        EXTERN DISKS_MAX_OPENED_FILES
+    ELSE
+        DEFC DISKS_MAX_OPENED_FILES = CONFIG_KERNEL_MAX_OPENED_FILES
+    ENDIF
         EXTERN zos_disk_allocate_opnfile
         EXTERN zos_disk_readdir
         EXTERN zos_disk_mkdir
@@ -39,6 +48,11 @@
         EXTERN zos_disk_stat_is_dir
         EXTERN zos_disk_stat_fill_root
 
+        ; Flag set in the file system byte of a disk that was mounted lazily and
+        ; that has not been probed yet (see zos_disks_mount_lazy)
+        DEFC DISKS_FS_PROBE_PENDING_BIT = 7
+        DEFC DISKS_FS_PROBE_PENDING     = 1 << DISKS_FS_PROBE_PENDING_BIT
+
         ; Structure of an opened file (and directory)
         ; The first field, the magic will also be used to determine
         ; whether an opened "dev" is a file or not.
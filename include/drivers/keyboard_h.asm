@@ -15,6 +15,12 @@
         ;   E - New mode
         KB_CMD_SET_MODE = 0,
 
+        ; Get the number of bytes received from the keyboard that were lost because the
+        ; FIFO was full, and reset that number.
+        ; Parameters:
+        ;   DE - Address of a 16-bit value to fill
+        KB_CMD_GET_OVERFLOW,
+
         ; Number of commands above
         KB_CMD_COUNT
     }
@@ -68,6 +74,25 @@
         KB_READ_NON_BLOCK = 1 << 2
     }
 
+    ; kb_events_t: Can be ORed with KB_MODE_RAW and the blocking modes above
+    DEFGROUP {
+        ; In raw mode, `read` fills the buffer with kb_event_t structures instead of bytes.
+        ; All the pending events that fit in the buffer are returned at once, the buffer
+        ; must be big enough for at least one event.
+        KB_READ_EVENTS = 1 << 3
+    }
+
+    ; kb_event_t structure, filled by `read` when KB_READ_EVENTS is set
+    DEFVARS 0 {
+        kb_event_key_t   DS.B 1  ; Key pressed or released, same codes as in raw mode
+        kb_event_state_t DS.B 1  ; KB_EVENT_PRESSED or KB_EVENT_RELEASED
+        kb_event_time_t  DS.B 2  ; Time the key was received at, in milliseconds, same clock as `gettime`
+        kb_event_end_t   DS.B 0
+    }
+
+    DEFC KB_EVENT_PRESSED  = 0
+    DEFC KB_EVENT_RELEASED = 1
+
     ; kb_flags_t: Flags for the keyboard modifiers
     DEFGROUP {
         KB_FLAG_CTRL_BIT  = 0,
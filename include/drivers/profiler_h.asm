@@ -0,0 +1,42 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    IFNDEF DRIVERS_PROFILER_H
+    DEFINE DRIVERS_PROFILER_H
+
+    ; This file represents the interface of the PC-sampling profiler driver.
+
+    ; prof_cmd_t: IOCTL commands of the profiler driver
+    DEFGROUP {
+        ; Clear the histogram and start sampling. The histogram page is allocated if necessary.
+        PROF_CMD_START = 0,
+        ; Stop sampling, the histogram can still be read
+        PROF_CMD_STOP,
+        ; Stop sampling and free the histogram page
+        PROF_CMD_FREE,
+
+        ; Number of commands above
+        PROF_CMD_COUNT
+    }
+
+    ; Layout of the histogram, as read from the driver
+    DEFC PROF_BUCKET_SHIFT = 4      ; Each counter covers 16 bytes of the virtual address space
+    DEFC PROF_BUCKETS_OFF  = 0
+    DEFC PROF_PAGES_OFF    = PROF_BUCKETS_OFF + (0x10000 >> PROF_BUCKET_SHIFT) * 2
+    DEFC PROF_HEADER_OFF   = PROF_PAGES_OFF + 256 * 2
+
+    DEFC PROF_MAGIC   = 0x505a      ; "ZP" in little-endian
+    DEFC PROF_VERSION = 1
+
+    DEFVARS 0 {
+        prof_hdr_magic_t    DS.B 2
+        prof_hdr_version_t  DS.B 1
+        prof_hdr_shift_t    DS.B 1
+        prof_hdr_samples_t  DS.B 4  ; Total number of samples, little-endian
+        prof_hdr_end_t      DS.B 0
+    }
+
+    DEFC PROF_DUMP_SIZE = PROF_HEADER_OFF + prof_hdr_end_t
+
+    ENDIF ; DRIVERS_PROFILER_H
@@ -57,6 +57,20 @@
         ; Resets the screen to the same state as on boot up
         CMD_RESET_SCREEN, 
 
+        ; Copy a rectangle of characters, and optionally their colors, to the screen, without
+        ; interpreting them and without moving the cursor. The coordinates are relative to the
+        ; visible screen.
+        ; Parameters:
+        ;   DE - Address of a blit_t structure (defined below). The structure and the buffers
+        ;        it points to must not cross a page boundary.
+        CMD_BLIT,
+
+        ; Scroll the content of the screen by a number of lines, the lines revealed are cleared
+        ; and the cursor keeps its position on screen.
+        ; Parameters:
+        ;   E - Signed number of lines, positive to move the content up, negative to move it down
+        CMD_SCROLL,
+
         ; Number of commands above
         CMD_COUNT
     }
@@ -89,5 +103,19 @@
         count_t  DS.B 2  ; Number of entities on-screen (usually, width * height)
     }
 
+    ; blit_t structure, used by the CMD_BLIT command
+    DEFVARS 0 {
+        blit_x_t      DS.B 1  ; Coordinates of the top-left corner of the rectangle
+        blit_y_t      DS.B 1
+        blit_w_t      DS.B 1  ; Width and height of the rectangle, not 0
+        blit_h_t      DS.B 1
+        blit_fill_t   DS.B 1  ; Character to fill the rectangle with when blit_chars_t is NULL
+        blit_color_t  DS.B 1  ; Color to fill the rectangle with when blit_colors_t is NULL,
+                              ; background in the upper nibble, foreground in the lower one
+        blit_chars_t  DS.B 2  ; w * h characters, row after row, or NULL
+        blit_colors_t DS.B 2  ; w * h colors, row after row, or NULL
+        blit_end_t    DS.B 0
+    }
+
 
-    ENDIF ; DRIVERS_VIDEO_TEXT_H
\ No newline at end of file
+    ENDIF ; DRIVERS_VIDEO_TEXT_H
@@ -10,6 +10,7 @@
     IF CONFIG_ENABLE_EMULATION_HOSTFS
 
     ; Public routines. The descriptions are given in the implementation file.
+    EXTERN zos_fs_hostfs_probe
     EXTERN zos_fs_hostfs_open
     EXTERN zos_fs_hostfs_read
     EXTERN zos_fs_hostfs_write
@@ -44,6 +45,45 @@
     DEFC OP_MKDIR   = 8
     DEFC OP_RM      = 9
 
+    ; Value returned in IO_STATUS by the host for OP_WHOAMI
+    DEFC HOSTFS_WHOAMI_MAGIC = 0xd3
+
+    ; Protocol versions. Before OP_WHOAMI, the kernel writes the version it supports in ARG0
+    ; and 0 in ARG1. A host supporting the second version writes HOSTFS_VERSION_2 in ARG1.
+    DEFC HOSTFS_VERSION_1 = 1
+    DEFC HOSTFS_VERSION_2 = 2
+
+    ; With the second version, the operations are ORed with OP_V2 and their parameters
+    ; are passed in a parameter block in memory, its address is written in ARG0 (lowest
+    ; byte) and ARG1 before the operation. The block is also used to return the results.
+    ; OP_CLOSE, OP_OPENDIR, OP_MKDIR and OP_RM keep the form of the first version.
+    DEFC OP_V2 = 0x80
+
+    ; A vector is made of a 16-bit buffer address followed by a 16-bit length.
+    ; A read or a write goes through all the vectors, in order, from the file offset.
+    DEFC HOSTFS_IOV_SIZE = 4
+    ; Number of vectors the kernel block can hold, the buffers given by the disk layer never cross
+    ; a page boundary, so a single one is used.
+    DEFC HOSTFS_IOV_MAX  = 1
+
+    DEFVARS 0 {
+        hostfs_blk_fd_t     DS.B 1  ; Host descriptor, returned by OP_OPEN
+        hostfs_blk_flags_t  DS.B 1  ; Flags of OP_OPEN and OP_READDIR. OP_OPEN returns non-zero for a directory
+        hostfs_blk_addr_t   DS.B 2  ; Path for OP_OPEN, buffer for OP_STAT and OP_READDIR
+        hostfs_blk_off_t    DS.B 4  ; Offset for OP_READ and OP_WRITE, index of the first entry for OP_READDIR.
+                                    ; OP_OPEN returns the size of the file
+        hostfs_blk_count_t  DS.B 1  ; Number of vectors for OP_READ and OP_WRITE, maximum number of entries
+                                    ; for OP_READDIR, which returns the number of entries filled
+        hostfs_blk_len_t    DS.B 2  ; Returned by OP_READ and OP_WRITE: total number of bytes transferred
+        hostfs_blk_iov_t    DS.B HOSTFS_IOV_MAX * HOSTFS_IOV_SIZE
+        hostfs_blk_end_t    DS.B 1
+    }
+    DEFC HOSTFS_BLOCK_SIZE = hostfs_blk_end_t
+
+    ; OP_STAT fills the structure from the `file_size_t` field, OP_READDIR fills DISKS_DIR_ENTRY
+    ; entries, or STAT_STRUCT entries (flags, size, date and name) if this flag is set.
+    DEFC HOSTFS_READDIR_STAT = 1 << 0
+
     ENDIF ; CONFIG_ENABLE_EMULATION_HOSTFS
 
 
@@ -39,6 +39,14 @@
     DEFC zos_fs_zealfs_mkdir   = zos_zealfs_mkdir
     DEFC zos_fs_zealfs_rm      = zos_zealfs_rm
 
+    IF CONFIG_KERNEL_ZEALFS_V2
+    EXTERN zos_zealfs_preallocate
+    DEFC zos_fs_zealfs_preallocate = zos_zealfs_preallocate
+    ELSE
+    ; Only ZealFS v2 can reserve the pages of a file in advance
+    DEFC zos_fs_zealfs_preallocate = zos_disk_fs_not_supported
+    ENDIF
+
     ELSE ; !CONFIG_KERNEL_ENABLE_ZEALFS_SUPPORT
 
     DEFC zos_fs_zealfs_open    = zos_disk_fs_not_supported
@@ -50,6 +58,7 @@
     DEFC zos_fs_zealfs_close   = zos_disk_fs_not_supported
     DEFC zos_fs_zealfs_mkdir   = zos_disk_fs_not_supported
     DEFC zos_fs_zealfs_rm      = zos_disk_fs_not_supported
+    DEFC zos_fs_zealfs_preallocate = zos_disk_fs_not_supported
 
     ENDIF ; CONFIG_KERNEL_ENABLE_ZEALFS_SUPPORT
 
@@ -0,0 +1,51 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+        IFNDEF JOBS_H
+        DEFINE JOBS_H
+
+        ; Mode of the exec syscall to start a program as a background job
+        DEFC LOADER_BACKGROUND_PROGRAM = 2
+
+        ; Job 0 is the foreground job, it is never freed and owns the nested programs stack
+        DEFC JOB_FOREGROUND = 0
+
+        ; States of a job entry
+        DEFC JOB_FREE  = 0
+        DEFC JOB_READY = 1
+
+        DEFC JOB_NAME_LEN = 16
+
+        ; Job entry definition. The first fields, up to `job_ksp_t`, are copied as-is to the
+        ; user buffer by the `jobstat` syscall, they must match the public structure.
+        DEFVARS 0 {
+                job_state_t     DS.B 1
+                job_slices_t    DS.B 2  ; Number of times the job was scheduled
+                job_cpu_t       DS.B 4  ; CPU time in milliseconds, little-endian
+                job_name_t      DS.B JOB_NAME_LEN ; NULL-terminated if shorter
+                job_ksp_t       DS.B 2  ; Saved kernel stack pointer, 0 if the job hasn't started yet
+                job_user_t      DS.B 6  ; Syscall context: user A, user pages 1 to 3 and user SP
+                job_pages_t     DS.B 3  ; Pages the program was loaded in (`_allocate_pages`)
+                job_parent_t    DS.B 1  ; Job that started this one
+                job_spawn_t     DS.B 1  ; Result of the last background exec performed by this job
+                job_path_t      DS.B 2  ; Program to load and its parameter, only valid until the
+                job_param_t     DS.B 2  ; job starts
+                job_end_t       DS.B 1
+        }
+
+        DEFC JOB_STAT_SIZE = job_ksp_t
+        DEFC JOB_ENTRY_SIZE = job_end_t
+
+        ; Public routines to export
+        EXTERN zos_job_init
+        EXTERN zos_job_yield
+        EXTERN zos_job_spawn
+        EXTERN zos_job_exit
+        EXTERN zos_job_msleep
+        EXTERN zos_job_sys_yield
+        EXTERN zos_job_stat
+        EXTERN _zos_job_current
+        EXTERN _zos_job_kstack
+
+        ENDIF
@@ -30,6 +30,9 @@
     EXTERN strncat
     EXTERN strtolower
     EXTERN strtoupper
+    EXTERN memset
+    EXTERN memcpy
+    EXTERN memcmp
     EXTERN parse_int
     EXTERN parse_hex
     EXTERN parse_dec
@@ -47,10 +47,12 @@
         EXTERN zos_time_msleep
         EXTERN zos_time_settime
         EXTERN zos_time_gettime
+        EXTERN zos_time_get_timestamp
 
         EXTERN zos_date_init
         EXTERN zos_time_is_available
         EXTERN zos_date_setdate
         EXTERN zos_date_getdate
+        EXTERN zos_date_cache_invalidate
 
         ENDIF
\ No newline at end of file
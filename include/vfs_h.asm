@@ -95,5 +95,6 @@
         EXTERN zos_vfs_mount
         EXTERN zos_vfs_dup
         EXTERN zos_vfs_swap
+        EXTERN zos_vfs_preallocate
 
         ENDIF
\ No newline at end of file
@@ -0,0 +1,237 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+        INCLUDE "osconfig.asm"
+        INCLUDE "errors_h.asm"
+
+        EXTERN zos_syscalls_table
+    IF CONFIG_KERNEL_TARGET_HAS_MMU
+        EXTERN zos_sys_remap_de_page_2
+        EXTERN zos_sys_remap_user_pages
+    ENDIF
+
+        ; Descriptor of a batched operation, as stored in the user memory
+        DEFVARS 0 {
+                batch_op_t      DS.B 1  ; Syscall number
+                batch_dev_t     DS.B 1  ; Parameter passed in H
+                batch_flags_t   DS.B 1  ; Parameter passed in A (whence for seek)
+                batch_ret_t     DS.B 1  ; Value returned in A
+                batch_buf_t     DS.B 2  ; Parameter passed in DE
+                batch_len_t     DS.B 2  ; Parameter passed in BC, number of bytes transferred for read and write
+                batch_off_t     DS.B 4  ; Offset for seek, BCDE, filled with the new offset
+                batch_end_t     DS.B 1
+        }
+        DEFC BATCH_ENTRY_SIZE = batch_end_t
+
+        ; Local variables of the batch syscall, allocated on the kernel stack
+        DEFVARS 0 {
+                local_entry     DS.B BATCH_ENTRY_SIZE   ; Copy of the current descriptor
+                local_ptr       DS.B 2  ; User address of the current descriptor
+                local_left      DS.B 1  ; Number of descriptors left
+                local_done      DS.B 1  ; Number of descriptors executed
+                local_flags     DS.B 1
+                local_err       DS.B 1  ; First error encountered
+                local_end       DS.B 1
+        }
+
+        ; Flags of the batch syscall
+        DEFC BATCH_STOP_ON_ERROR_BIT = 0
+
+        ; Only the file and directory syscalls can be batched: from read (0) to mount (14)
+        DEFC BATCH_OP_READ    = 0
+        DEFC BATCH_OP_WRITE   = 1
+        DEFC BATCH_OP_OPEN    = 2
+        DEFC BATCH_OP_SEEK    = 6
+        DEFC BATCH_OP_OPENDIR = 11
+        DEFC BATCH_OP_LAST    = 14
+
+        SECTION KERNEL_TEXT
+
+        ; Execute an array of file and directory operations in a single syscall.
+        ; Each operation is described by a descriptor giving the syscall number and the
+        ; values of its parameters. The result of each operation is written back in its
+        ; descriptor.
+        ; Parameters:
+        ;   DE - Array of descriptors, must not cross a page boundary
+        ;   B  - Number of descriptors in the array
+        ;   C  - Flags, bit 0 set to stop at the first operation that fails
+        ; Returns:
+        ;   A - ERR_SUCCESS if all the operations succeeded, error of the first
+        ;       operation that failed else
+        ;   B - Number of descriptors executed
+        ; Alters:
+        ;   A, B, HL
+        PUBLIC zos_sys_batch
+zos_sys_batch:
+        push de
+        push ix
+        ; Allocate the local variables on the stack
+        ld hl, -local_end
+        add hl, sp
+        ld sp, hl
+        push hl
+        pop ix
+        ld (ix + local_ptr), e
+        ld (ix + local_ptr + 1), d
+        ld (ix + local_left), b
+        ld (ix + local_flags), c
+        xor a
+        ld (ix + local_done), a
+        ld (ix + local_err), a
+_zos_sys_batch_loop:
+        ld a, (ix + local_left)
+        or a
+        jr z, _zos_sys_batch_end
+        ; Copy the descriptor to the kernel stack, the previous operation may have
+        ; changed the mapping of the user memory
+        call _zos_sys_batch_map_entry
+        push ix
+        pop de
+        ld bc, BATCH_ENTRY_SIZE
+        ldir
+    IF CONFIG_KERNEL_TARGET_HAS_MMU
+        ; The descriptor may have been in user page 3, mapped in page 2, restore the user
+        ; mapping so that the buffers and paths of the operation point to the right pages
+        call zos_sys_remap_user_pages
+    ENDIF
+        call _zos_sys_batch_execute
+        ; Write the results back to the user memory
+        push af
+        call _zos_sys_batch_map_entry
+        ex de, hl
+        push ix
+        pop hl
+        ld bc, BATCH_ENTRY_SIZE
+        ldir
+    IF CONFIG_KERNEL_TARGET_HAS_MMU
+        call zos_sys_remap_user_pages
+    ENDIF
+        ; Go to the next descriptor, DE may point to the remapped address, don't use it
+        ld l, (ix + local_ptr)
+        ld h, (ix + local_ptr + 1)
+        ld bc, BATCH_ENTRY_SIZE
+        add hl, bc
+        ld (ix + local_ptr), l
+        ld (ix + local_ptr + 1), h
+        pop af
+        dec (ix + local_left)
+        inc (ix + local_done)
+        or a
+        jr z, _zos_sys_batch_loop
+        ; Keep the first error only
+        ld b, a
+        ld a, (ix + local_err)
+        or a
+        jr nz, _zos_sys_batch_error_set
+        ld (ix + local_err), b
+_zos_sys_batch_error_set:
+        bit BATCH_STOP_ON_ERROR_BIT, (ix + local_flags)
+        jr z, _zos_sys_batch_loop
+_zos_sys_batch_end:
+        ld a, (ix + local_err)
+        ld b, (ix + local_done)
+        ld hl, local_end
+        add hl, sp
+        ld sp, hl
+        pop ix
+        pop de
+        ret
+
+
+        ; Get the address of the current descriptor, mapping the user pages if necessary
+        ; Parameters:
+        ;   IX - Local variables
+        ; Returns:
+        ;   HL - Address of the descriptor
+        ; Alters:
+        ;   A, DE, HL
+_zos_sys_batch_map_entry:
+        ld e, (ix + local_ptr)
+        ld d, (ix + local_ptr + 1)
+    IF CONFIG_KERNEL_TARGET_HAS_MMU
+        call zos_sys_remap_user_pages
+        call zos_sys_remap_de_page_2
+    ENDIF
+        ex de, hl
+        ret
+
+
+        ; Execute the descriptor copied in the local variables
+        ; Parameters:
+        ;   IX - Local variables, starting with the descriptor
+        ; Returns:
+        ;   A - ERR_SUCCESS on success, error code else
+        ; Alters:
+        ;   A, BC, DE, HL
+_zos_sys_batch_execute:
+        ld a, (ix + batch_op_t)
+        cp BATCH_OP_LAST + 1
+        jr nc, _zos_sys_batch_invalid
+        ; Get the routine to call from the syscall table
+        ld l, a
+        ld h, 0
+        add hl, hl
+        ld de, zos_syscalls_table
+        add hl, de
+        ld e, (hl)
+        inc hl
+        ld d, (hl)
+        ; The routine may alter IX, save it. Push the return address and the routine address
+        ; so that a `ret` jumps to the routine with all the parameters loaded.
+        push ix
+        ld hl, _zos_sys_batch_execute_ret
+        push hl
+        push de
+        ld h, (ix + batch_dev_t)
+        ld e, (ix + batch_buf_t)
+        ld d, (ix + batch_buf_t + 1)
+        ld c, (ix + batch_len_t)
+        ld b, (ix + batch_len_t + 1)
+        cp BATCH_OP_SEEK
+        jr nz, _zos_sys_batch_execute_call
+        ld e, (ix + batch_off_t)
+        ld d, (ix + batch_off_t + 1)
+        ld c, (ix + batch_off_t + 2)
+        ld b, (ix + batch_off_t + 3)
+_zos_sys_batch_execute_call:
+        ld a, (ix + batch_flags_t)
+        ret
+_zos_sys_batch_execute_ret:
+        pop ix
+        ld (ix + batch_ret_t), a
+        ld l, a
+        ; Store the values returned in registers for the operations that have any
+        ld a, (ix + batch_op_t)
+        cp BATCH_OP_SEEK
+        jr z, _zos_sys_batch_execute_seek
+        cp BATCH_OP_WRITE + 1
+        jr nc, _zos_sys_batch_execute_check
+        ld (ix + batch_len_t), c
+        ld (ix + batch_len_t + 1), b
+        jr _zos_sys_batch_execute_check
+_zos_sys_batch_execute_seek:
+        ld (ix + batch_off_t), e
+        ld (ix + batch_off_t + 1), d
+        ld (ix + batch_off_t + 2), c
+        ld (ix + batch_off_t + 3), b
+_zos_sys_batch_execute_check:
+        ; Open and opendir return a descriptor, which is negative on error
+        cp BATCH_OP_OPEN
+        jr z, _zos_sys_batch_execute_dev
+        cp BATCH_OP_OPENDIR
+        ld a, l
+        ret nz
+_zos_sys_batch_execute_dev:
+        ld a, l
+        or a
+        jp m, _zos_sys_batch_execute_dev_err
+        xor a
+        ret
+_zos_sys_batch_execute_dev_err:
+        neg
+        ret
+_zos_sys_batch_invalid:
+        ld a, ERR_INVALID_SYSCALL
+        ld (ix + batch_ret_t), a
+        ret
@@ -10,6 +10,7 @@
         INCLUDE "log_h.asm"
         INCLUDE "vfs_h.asm"
         INCLUDE "strutils_h.asm"
+        INCLUDE "time_h.asm"
 
         ; Forward declaration of symbols used below
         EXTERN zos_drivers_init
@@ -100,6 +101,19 @@ _zos_boot_time_ok:
         ld hl, zos_date_warning
         call zos_log_warning
 _zos_boot_date_ok:
+    IF CONFIG_KERNEL_LOG_BOOT_TIMESTAMPS
+        ; Report the time it took to reach this point, as measured by the timer
+        call zos_time_get_timestamp
+        ld a, e
+        push af
+        ld a, d
+        push af
+        ld hl, zos_boot_time_msg
+        ld de, _vfs_work_buffer
+        call strformat
+        ex de, hl
+        call zos_log_info
+    ENDIF
         ; Load the init file from the default disk drive
         ld hl, zos_kernel_ready
         xor a
@@ -138,6 +152,9 @@ zos_boilerplate:
         DEFB "\n", 0
 zos_timer_warning: DEFM "Timer unavailable\n", 0
 zos_date_warning: DEFM "Date unavailable\n", 0
+    IF CONFIG_KERNEL_LOG_BOOT_TIMESTAMPS
+zos_boot_time_msg: DEFM "Boot time: $", FORMAT_U8_HEX, FORMAT_U8_HEX, " ms\n", 0
+    ENDIF
 zos_kernel_ready:
         DEFM "Kernel ready.\nLoading "
         CONFIG_KERNEL_INIT_EXECUTABLE
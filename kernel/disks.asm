@@ -12,11 +12,28 @@
         INCLUDE "fs/zealfs_h.asm"
         INCLUDE "fs/hostfs_h.asm"
         INCLUDE "log_h.asm"
+        INCLUDE "time_h.asm"
 
         SECTION KERNEL_TEXT
 
         EXTERN _vfs_work_buffer
         EXTERN boot_ready
+    IF CONFIG_KERNEL_OPENED_FILES_POOL
+        EXTERN __KERNEL_POOL_head
+
+        ; Number of opened file structures allocated at once from the pool
+        DEFC DISKS_POOL_SLAB_ENTRIES = 8
+        DEFC DISKS_POOL_SLAB_SIZE = DISKS_POOL_SLAB_ENTRIES * DISKS_OPN_FILE_STRUCT_SIZE
+        ; First address the pool must not reach, the rest is kept for the kernel stack
+        DEFC DISKS_POOL_END = CONFIG_KERNEL_STACK_ADDR + 1 - CONFIG_KERNEL_OPENED_FILES_POOL_STACK
+        ; Number of slabs that fit in the pool, the number of structures allocated from it
+        ; is kept in a byte, so it can't go beyond 248 (31 slabs)
+        DEFC DISKS_POOL_SLABS = __KERNEL_POOL_head >= DISKS_POOL_END ? 0 : (DISKS_POOL_END - __KERNEL_POOL_head) / DISKS_POOL_SLAB_SIZE
+        DEFC DISKS_POOL_CAPACITY = DISKS_POOL_SLABS > 31 ? 248 : DISKS_POOL_SLABS * DISKS_POOL_SLAB_ENTRIES
+        ; Total number of opened files, reported in the kernel configuration structure
+        PUBLIC DISKS_MAX_OPENED_FILES
+        DEFC DISKS_MAX_OPENED_FILES = CONFIG_KERNEL_MAX_OPENED_FILES + DISKS_POOL_CAPACITY > 255 ? 255 : CONFIG_KERNEL_MAX_OPENED_FILES + DISKS_POOL_CAPACITY
+    ENDIF
 
         PUBLIC zos_disks_init
 zos_disks_init:
@@ -32,6 +49,10 @@ _zos_disks_init_opened_files:
         ld (hl), a      ; Mark the first field to EMPTY
         add hl, de      ; Go to the next structure
         djnz _zos_disks_init_opened_files
+    IF CONFIG_KERNEL_OPENED_FILES_POOL
+        xor a
+        ld (_disk_pool_count), a
+    ENDIF
         ; Initialize ZealFS if compiled
     IF CONFIG_KERNEL_ENABLE_ZEALFS_SUPPORT
         jp zos_zealfs_init
@@ -106,6 +127,54 @@ _zos_disks_mount_already_mounted:
         jr _zos_disks_mount_ex_pop_ret
 
 
+    IF CONFIG_KERNEL_LAZY_DISK_PROBE
+        ; Mount a disk (driver) to the given letter without probing the underlying device.
+        ; The given probe routine will be called by the kernel the first time the disk is
+        ; accessed. If it returns an error, the disk will be unmounted.
+        ; Parameters:
+        ;       A  - Letter to mount the disk on
+        ;       E  - File system (taken from vfs_h.asm)
+        ;       HL - Pointer to the driver structure. Guaranteed valid by the caller.
+        ;       BC - Address of the probe routine. It takes no parameter, returns ERR_SUCCESS
+        ;            in A if the device is usable, and can alter any register.
+        ; Returns:
+        ;       A - ERR_SUCCESS on success
+        ;           ERR_ALREADY_MOUNTED if the letter has already on disk mounted on
+        ;           ERR_INVALID_PARAMETER if the pointer or the letter passed is wrong
+        ; Alters:
+        ;       A
+        PUBLIC zos_disks_mount_lazy
+zos_disks_mount_lazy:
+        push de
+        push hl
+        ; Mark the disk as not probed yet in its file system byte
+        ld d, a
+        ld a, e
+        or DISKS_FS_PROBE_PENDING
+        ld e, a
+        ld a, d
+        call zos_disks_mount
+        or a
+        jr nz, _zos_disks_mount_lazy_ret
+        ; The letter is valid, save the probe routine in the disk's entry
+        ld a, d
+        call to_upper
+        sub 'A'
+        add a
+        ld hl, _disks_probe
+        ADD_HL_A()
+        ld (hl), c
+        inc hl
+        ld (hl), b
+        ; Optimization for ERR_SUCCESS
+        xor a
+_zos_disks_mount_lazy_ret:
+        pop hl
+        pop de
+        ret
+    ENDIF
+
+
     IF CONFIG_KERNEL_LOG_BOOT_MOUNTED_DISKS
         ; Print the name of the mounted disk on boot
         ; Parameters:
@@ -229,10 +298,122 @@ zos_disks_get_driver_and_fs:
         ADD_HL_A()
         ; Put the FS number in C and exit with success
         ld c, (hl)
+    IF CONFIG_KERNEL_LAZY_DISK_PROBE
+        ; Probe the device if this is the first access to the disk
+        bit DISKS_FS_PROBE_PENDING_BIT, c
+        jr nz, _zos_disks_probe
+    ENDIF
         xor a           ; Optimization for ERR_SUCCESS
         pop hl
         ret
 
+    IF CONFIG_KERNEL_LAZY_DISK_PROBE
+        ; Jumped to from the routine above when the disk has not been probed yet
+        ; Parameters:
+        ;       A  - Index of the disk
+        ;       DE - Driver of the disk
+        ;       HL - Address of the disk's entry in _disks_fs
+        ;       [SP] - HL to restore
+_zos_disks_probe:
+        ; B, DE and HL must be preserved, the probe routine can alter any register
+        push bc
+        push de
+        push hl
+    IF CONFIG_KERNEL_LOG_BOOT_TIMESTAMPS
+        ; Keep the time at which the probe started on the stack
+        ld c, a
+        call zos_time_get_timestamp
+        push de
+        ld a, c
+    ENDIF
+        ; Get the probe routine out of the disk index
+        add a
+        ld hl, _disks_probe
+        ADD_HL_A()
+        ld a, (hl)
+        inc hl
+        ld h, (hl)
+        ld l, a
+        CALL_HL()
+    IF CONFIG_KERNEL_LOG_BOOT_TIMESTAMPS
+        ; Get the start time in DE and the disk's _disks_fs entry in HL
+        pop de
+        pop hl
+        push hl
+        push af
+        call _zos_disks_log_probe
+        pop af
+    ENDIF
+        pop hl
+        pop de
+        pop bc
+        or a
+        jr nz, _zos_disks_probe_failed
+        ; The device is ready, the disk doesn't need to be probed anymore
+        res DISKS_FS_PROBE_PENDING_BIT, (hl)
+        ld c, (hl)
+        pop hl
+        ret
+_zos_disks_probe_failed:
+        ; The device is absent or unusable, unmount the disk so that the next
+        ; accesses fail right away. Keep the error in C.
+        ld c, a
+        ld de, _disks_fs
+        xor a
+        ld (hl), a
+        sbc hl, de
+        ; L contains the index of the disk, clear its driver
+        ld a, l
+        add a
+        ld hl, _disks
+        ADD_HL_A()
+        xor a
+        ld (hl), a
+        inc hl
+        ld (hl), a
+        ld a, c
+        pop hl
+        ret
+
+    IF CONFIG_KERNEL_LOG_BOOT_TIMESTAMPS
+        ; Log the time it took to probe a disk
+        ; Parameters:
+        ;       HL - Address of the disk's entry in _disks_fs
+        ;       DE - Time at which the probe started
+        ; Alters:
+        ;       A, BC, DE, HL
+_zos_disks_log_probe:
+        ; Convert the entry address to a disk letter in B
+        ld bc, _disks_fs
+        or a
+        sbc hl, bc
+        ld a, l
+        add 'A'
+        ld b, a
+        ; Calculate the elapsed time in HL
+        push de
+        call zos_time_get_timestamp
+        pop hl
+        ex de, hl
+        or a
+        sbc hl, de
+        ld a, l
+        push af
+        ld a, h
+        push af
+        ld a, b
+        push af
+        ; The VFS work buffer may contain the path being accessed, use our own buffer
+        ld hl, _probe_msg
+        ld de, _disks_probe_log
+        call strformat
+        ex de, hl
+        jp zos_log_info
+_probe_msg:
+        DEFM "Disk ", FORMAT_CHAR, " probed in $", FORMAT_U8_HEX, FORMAT_U8_HEX, " ms\n", 0
+    ENDIF
+    ENDIF
+
         ; Open a file on a disk with the given flags
         ; Parameters:
         ;       B - Flags, can be O_RDWR, O_RDONLY, O_WRONLY, O_NONBLOCK, O_CREAT, O_APPEND, etc...
@@ -871,6 +1052,76 @@ _zos_disk_seek_set_beginning:
         xor a
         ret
 
+        ; Reserve room on the disk for the given number of bytes in an opened file, so
+        ; that writing them doesn't need to allocate anything on the disk. If the given
+        ; size is smaller than the file size, the file is truncated and its cursor moved
+        ; back to the new end of the file if it was further. Else, the file size is not
+        ; modified.
+        ; Parameters:
+        ;       HL - Address of the opened file/directory
+        ;       BCDE - 32-bit size to reserve
+        ; Returns:
+        ;       A - ERR_SUCCESS on success, error code else.
+        ; Alters:
+        ;       A, BC, DE, HL
+        PUBLIC zos_disk_preallocate
+zos_disk_preallocate:
+        call zos_disk_is_opnfile
+        ret nz
+        ; The file must have been opened in WRITE mode
+        inc hl
+        ld a, (hl)
+        and O_WRITE_MASK << 4
+        jp z, _zos_disk_bad_mode
+        ld a, (hl)
+        DISKS_OPN_FILE_GET_FS()
+        dec hl
+        ; Only ZealFS can reserve pages for a file
+        cp FS_ZEALFS
+        jp nz, zos_disk_fs_not_supported
+        push hl
+        push bc
+        push de
+        call zos_fs_zealfs_preallocate
+        pop de
+        pop bc
+        pop hl
+        or a
+        ret nz
+        ; Truncate the file if the new size is smaller than the current one, compare
+        ; them starting from the highest byte
+        push hl
+        ld a, opn_file_size_t + 3
+        ADD_HL_A()
+        REPTI reg, b, c, d, e
+        ld a, (hl)
+        cp reg
+        jr c, _zos_disk_preallocate_keep_size
+        jr nz, _zos_disk_preallocate_truncate
+        dec hl
+        ENDR
+_zos_disk_preallocate_keep_size:
+        pop hl
+        xor a
+        ret
+_zos_disk_preallocate_truncate:
+        pop hl
+        push hl
+        ld a, opn_file_size_t
+        ADD_HL_A()
+        REPTI reg, e, d, c, b
+        ld (hl), reg
+        inc hl
+        ENDR
+        pop hl
+        ; Seeking from the current position clamps the cursor to the new size
+        ld bc, 0
+        ld d, b
+        ld e, b
+        ld a, SEEK_CUR
+        jp zos_disk_seek
+
+
         ; Routine testing whether -BCDE is greater than the 32-bit value
         ; pointed by HL.
         ; Parameters:
@@ -1049,16 +1300,8 @@ zos_disk_allocate_opnfile:
         ; Save the driver address
         push bc
         push af ; Save the filesystem
-        ld b, CONFIG_KERNEL_MAX_OPENED_FILES
-        ld de, DISKS_OPN_FILE_STRUCT_SIZE
-        ld hl, _disk_file_slot
-_zos_disks_allocate_loop:
-        ; Check if structure's first field reference count is 0
-        ld a, (hl)
-        and DISKS_OPN_ENTITY_REF
+        call _zos_disks_find_free_slot
         jr z, _zos_disks_allocate_found
-        add hl, de      ; Go to the next structure
-        djnz _zos_disks_allocate_loop
         ; Could not find any empty entry, send an error
         pop af
         pop bc
@@ -1120,6 +1363,113 @@ _zos_disks_allocate_found:
         ret
 
 
+        ; Look for a free opened file or directory structure. When they are all used and the
+        ; pool is enabled, the pool is browsed and grown if necessary.
+        ; Parameters:
+        ;       None
+        ; Returns:
+        ;       HL - Address of the free structure
+        ;       Z flag - Set on success, not set if no structure is free
+        ; Alters:
+        ;       A, B, DE, HL
+_zos_disks_find_free_slot:
+        ld b, CONFIG_KERNEL_MAX_OPENED_FILES
+        ld de, DISKS_OPN_FILE_STRUCT_SIZE
+        ld hl, _disk_file_slot
+_zos_disks_find_free_slot_loop:
+        ; Check if structure's first field reference count is 0
+        ld a, (hl)
+        and DISKS_OPN_ENTITY_REF
+        ret z
+        add hl, de      ; Go to the next structure
+        djnz _zos_disks_find_free_slot_loop
+    IF CONFIG_KERNEL_OPENED_FILES_POOL
+        ; Browse the structures allocated from the pool, DE is still the size of a structure
+        ld hl, __KERNEL_POOL_head
+        ld a, (_disk_pool_count)
+        or a
+        jr z, _zos_disks_pool_grow
+        ld b, a
+_zos_disks_pool_loop:
+        ld a, (hl)
+        and DISKS_OPN_ENTITY_REF
+        ret z
+        add hl, de
+        djnz _zos_disks_pool_loop
+_zos_disks_pool_grow:
+        ; HL points right after the last slab, make sure a new one doesn't reach the kernel stack
+        push hl
+        ld de, DISKS_POOL_SLAB_SIZE
+        add hl, de
+        ex de, hl
+        ld hl, DISKS_POOL_END
+        or a
+        sbc hl, de
+        pop hl
+        jr c, _zos_disks_find_free_slot_full
+        ; The number of structures must fit in a byte
+        ld a, (_disk_pool_count)
+        add DISKS_POOL_SLAB_ENTRIES
+        jr c, _zos_disks_find_free_slot_full
+        ld (_disk_pool_count), a
+        ; Mark all the structures of the new slab as free, return the first one
+        push hl
+        ld b, DISKS_POOL_SLAB_ENTRIES
+        ld de, DISKS_OPN_FILE_STRUCT_SIZE
+_zos_disks_pool_grow_loop:
+        ld (hl), DISKS_OPN_FILE_MAGIC_FREE
+        add hl, de
+        djnz _zos_disks_pool_grow_loop
+        pop hl
+        xor a
+        ret
+_zos_disks_find_free_slot_full:
+    ENDIF
+        ; No free structure, Z flag must not be set
+        ld a, ERR_CANNOT_REGISTER_MORE
+        or a
+        ret
+
+
+    IF CONFIG_KERNEL_OPENED_FILES_POOL
+        ; Give back to the pool the slabs, at the end of it, whose structures are all free.
+        ; This is called once all the opened devices have been closed, so usually the whole
+        ; pool is freed.
+        ; Parameters:
+        ;       None
+        ; Returns:
+        ;       None
+        ; Alters:
+        ;       A, BC, DE, HL
+        PUBLIC zos_disks_pool_trim
+zos_disks_pool_trim:
+        ld a, (_disk_pool_count)
+        or a
+        ret z
+        ld b, a
+        ; C will contain the number of structures to keep
+        ld c, 0
+        ld de, DISKS_OPN_FILE_STRUCT_SIZE
+        ld hl, __KERNEL_POOL_head
+_zos_disks_pool_trim_loop:
+        ld a, (hl)
+        and DISKS_OPN_ENTITY_REF
+        jr z, _zos_disks_pool_trim_next
+        ; The structure is used, keep all the slabs up to its own: (index + SLAB_ENTRIES) & ~(SLAB_ENTRIES - 1)
+        ld a, (_disk_pool_count)
+        sub b
+        add DISKS_POOL_SLAB_ENTRIES
+        and -DISKS_POOL_SLAB_ENTRIES
+        ld c, a
+_zos_disks_pool_trim_next:
+        add hl, de
+        djnz _zos_disks_pool_trim_loop
+        ld a, c
+        ld (_disk_pool_count), a
+        ret
+    ENDIF
+
+
         ; Routine checking if the opened dev address passed is an opened file.
         ; To do so, the first byte will be dereferenced and compared to the "magic" value.
         ; Parameters:
@@ -1256,16 +1606,8 @@ zos_disk_allocate_opndir:
         ; Save the driver address and the filesystem in C
         push bc
         ld c, a
-        ld b, CONFIG_KERNEL_MAX_OPENED_FILES
-        ld de, DISKS_OPN_DIR_STRUCT_SIZE
-        ld hl, _disk_file_slot
-_zos_disks_allocatedir_loop:
-        ; Check if structure's first field reference count is 0
-        ld a, (hl)
-        and DISKS_OPN_ENTITY_REF
+        call _zos_disks_find_free_slot
         jr z, _zos_disks_allocatedir_found
-        add hl, de      ; Go to the next structure
-        djnz _zos_disks_allocatedir_loop
         ; Could not find any empty entry, send an error
         pop bc
         ld a, ERR_CANNOT_REGISTER_MORE
@@ -1432,9 +1774,20 @@ zos_disk_add_offset_bc:
 _disks_default: DEFS 1
 _disks: DEFS DISKS_MAX_COUNT * 2
 _disks_fs: DEFS DISKS_MAX_COUNT
+    IF CONFIG_KERNEL_LAZY_DISK_PROBE
+        ; Probe routine of each lazily mounted disk
+_disks_probe: DEFS DISKS_MAX_COUNT * 2
+    IF CONFIG_KERNEL_LOG_BOOT_TIMESTAMPS
+_disks_probe_log: DEFS 32
+    ENDIF
+    ENDIF
         ; Store the type of file that is being stat-ed
 _disks_stat_type: DEFS 1
         ; Structure containing the opened file structure.
         ; Check disk_h.asm file for more info about this
         ; structure.
-_disk_file_slot: DEFS CONFIG_KERNEL_MAX_OPENED_FILES * DISKS_OPN_FILE_STRUCT_SIZE
\ No newline at end of file
+_disk_file_slot: DEFS CONFIG_KERNEL_MAX_OPENED_FILES * DISKS_OPN_FILE_STRUCT_SIZE
+    IF CONFIG_KERNEL_OPENED_FILES_POOL
+        ; Number of structures allocated from the pool, right after `__KERNEL_POOL_head`
+_disk_pool_count: DEFS 1
+    ENDIF
\ No newline at end of file
@@ -10,6 +10,7 @@
         INCLUDE "vfs_h.asm"
         INCLUDE "log_h.asm"
         INCLUDE "strutils_h.asm"
+        INCLUDE "time_h.asm"
 
         ; Forward declaration of symbols used below
         EXTERN zos_drivers_init
@@ -63,7 +64,11 @@ _zos_next_driver:
         ; Log finished registering drivers
         ret
 
+    IF CONFIG_KERNEL_LOG_BOOT_TIMESTAMPS
+_driver_log_success: DEFM "[$", FORMAT_U8_HEX, FORMAT_U8_HEX, "] Driver: ", FORMAT_4_CHAR , " init success\n", 0
+    ELSE
 _driver_log_success: DEFM "Driver: ", FORMAT_4_CHAR , " init success\n", 0
+    ENDIF
 _driver_log_failed:  DEFM "Driver: ", FORMAT_4_CHAR , " init error $", FORMAT_U8_HEX ,"\n", 0
 _driver_log_end:
 
@@ -91,10 +96,20 @@ _zos_driver_log_error:
         pop hl
         ret
         ; Same as above but with a success
+        ; Alters:
+        ;       A, C, DE
 _zos_driver_log_success:
         ; HL must not be altered
         push hl
         push hl
+    IF CONFIG_KERNEL_LOG_BOOT_TIMESTAMPS
+        ; Timestamp of the end of the driver's init
+        call zos_time_get_timestamp
+        ld a, e
+        push af
+        ld a, d
+        push af
+    ENDIF
         ld hl, _driver_log_success
         ld de, _vfs_work_buffer
         call strformat
@@ -13,6 +13,59 @@
 
     SECTION KERNEL_TEXT
 
+    ; Check whether the host file system layer is present and negotiate the version
+    ; of the protocol.
+    ; Parameters:
+    ;       None
+    ; Returns:
+    ;       A - ERR_SUCCESS if the host file system is present, error code else
+    ; Alters:
+    ;       A
+    PUBLIC zos_fs_hostfs_probe
+zos_fs_hostfs_probe:
+    ld a, HOSTFS_VERSION_2
+    out (IO_ARG0_REG), a
+    ; Hosts that only support the first version leave ARG1 untouched
+    xor a
+    ld (hostfs_v2), a
+    ld (hostfs_dir_count), a
+    out (IO_ARG1_REG), a
+    ld a, OP_WHOAMI
+    out (IO_OPERATION), a
+    in a, (IO_STATUS)
+    ; Arbitrary value returned by the host FS layer
+    cp HOSTFS_WHOAMI_MAGIC
+    ld a, ERR_NOT_SUPPORTED
+    ret nz
+    in a, (IO_ARG1_REG)
+    cp HOSTFS_VERSION_2
+    jr nz, _zos_fs_hostfs_probe_v1
+    ld (hostfs_v2), a
+_zos_fs_hostfs_probe_v1:
+    xor a
+    ret
+
+
+    ; Start an operation of the second version of the protocol, the parameter block
+    ; must have been filled.
+    ; Parameters:
+    ;       A - Operation, OP_*
+    ; Returns:
+    ;       A - ERR_SUCCESS on success, error code else
+    ;       Z flag on success, NZ on error
+    ; Alters:
+    ;       A
+_hostfs_v2_call:
+    or OP_V2
+    push af
+    ld a, hostfs_block & 0xff
+    out (IO_ARG0_REG), a
+    ld a, hostfs_block >> 8
+    out (IO_ARG1_REG), a
+    pop af
+    out (IO_OPERATION), a
+    ; Fall-through
+
 
 wait_for_completion:
     in a, (IO_STATUS)
@@ -36,6 +89,9 @@ wait_for_completion:
     ;       A, BC, DE, HL
     PUBLIC zos_fs_hostfs_open
 zos_fs_hostfs_open:
+    ld a, (hostfs_v2)
+    or a
+    jr nz, _zos_fs_hostfs_open_v2
     ; Give the parameters to the host
     ld a, b
     out (IO_ARG0_REG), a
@@ -48,8 +104,29 @@ zos_fs_hostfs_open:
     out (IO_OPERATION), a
     call wait_for_completion
     ret nz
-    ; Check if we have to allocate a file or a directory
+    ; Store the results in the parameter block, as the second version does
+    in a, (IO_ARG0_REG)
+    ld (hostfs_block + hostfs_blk_off_t), a
+    in a, (IO_ARG1_REG)
+    ld (hostfs_block + hostfs_blk_off_t + 1), a
+    in a, (IO_ARG2_REG)
+    ld (hostfs_block + hostfs_blk_off_t + 2), a
+    in a, (IO_ARG3_REG)
+    ld (hostfs_block + hostfs_blk_off_t + 3), a
+    in a, (IO_ARG4_REG)
+    ld (hostfs_block + hostfs_blk_fd_t), a
     in a, (IO_ARG5_REG)
+    jr _open_allocate
+_zos_fs_hostfs_open_v2:
+    ld a, b
+    ld (hostfs_block + hostfs_blk_flags_t), a
+    ld (hostfs_block + hostfs_blk_addr_t), hl
+    ld a, OP_OPEN
+    call _hostfs_v2_call
+    ret nz
+    ld a, (hostfs_block + hostfs_blk_flags_t)
+_open_allocate:
+    ; Check if we have to allocate a file or a directory
     or a
     jr z, _open_file
     ; Open a directory, put driver address in BC
@@ -74,21 +151,15 @@ _open_file:
     ld b, d
     ld c, e
     ; File size in DEHL (returned by the host)
-    in a, (IO_ARG0_REG)
-    ld l, a
-    in a, (IO_ARG1_REG)
-    ld h, a
-    in a, (IO_ARG2_REG)
-    ld e, a
-    in a, (IO_ARG3_REG)
-    ld d, a
+    ld hl, (hostfs_block + hostfs_blk_off_t)
+    ld de, (hostfs_block + hostfs_blk_off_t + 2)
     pop af
     call zos_disk_allocate_opnfile
     or a
     ret nz  ; If error, return directly
 open_end:
     ; Fill the user field with the abstract value got from the host
-    in a, (IO_ARG4_REG)
+    ld a, (hostfs_block + hostfs_blk_fd_t)
     ld (de), a
     ; Success
     xor a
@@ -108,6 +179,9 @@ open_end:
     ;       A, BC, DE, HL (Can alter any of the fields)
     PUBLIC zos_fs_hostfs_stat
 zos_fs_hostfs_stat:
+    ld a, (hostfs_v2)
+    or a
+    jr nz, _zos_fs_hostfs_stat_v2
     ld a, e
     out (IO_ARG0_REG), a
     ld a, d
@@ -118,6 +192,20 @@ zos_fs_hostfs_stat:
     ld a, OP_STAT
     out (IO_OPERATION), a
     jp wait_for_completion
+_zos_fs_hostfs_stat_v2:
+    ; The host fills the structure from the size field, for files, the disk layer already
+    ; filled the size and gives the date field. In both cases, HL points to the host fd.
+    call zos_disk_stat_is_dir
+    jr nz, _zos_fs_hostfs_stat_v2_call
+    REPT file_date_t - file_size_t
+    dec de
+    ENDR
+_zos_fs_hostfs_stat_v2_call:
+    ld (hostfs_block + hostfs_blk_addr_t), de
+    ld a, (hl)
+    ld (hostfs_block + hostfs_blk_fd_t), a
+    ld a, OP_STAT
+    jp _hostfs_v2_call
 
 
     ; Read bytes of an opened file.
@@ -144,6 +232,9 @@ zos_fs_hostfs_read:
     push af
     ; Fall-through
 _zos_fs_hostfs_read_write:
+    ld a, (hostfs_v2)
+    or a
+    jr nz, _zos_fs_hostfs_read_write_v2
     ld a, l
     out (IO_ARG0_REG), a
     ld a, h
@@ -167,6 +258,25 @@ _zos_fs_hostfs_read_write:
     ld b, a
     xor a
     ret
+_zos_fs_hostfs_read_write_v2:
+    ; Single vector: the buffer and its size
+    ld (hostfs_block + hostfs_blk_iov_t), de
+    ld (hostfs_block + hostfs_blk_iov_t + 2), bc
+    ld a, 1
+    ld (hostfs_block + hostfs_blk_count_t), a
+    ; Give the offset and the descriptor to the host, the user field follows the offset
+    ld de, opn_file_off_t
+    add hl, de
+    ld de, hostfs_block + hostfs_blk_off_t
+    ld bc, 4
+    ldir
+    ld a, (hl)
+    ld (hostfs_block + hostfs_blk_fd_t), a
+    pop af
+    call _hostfs_v2_call
+    ret nz
+    ld bc, (hostfs_block + hostfs_blk_len_t)
+    ret
 
 
     ; Perform a write on an opened file, which is located on a
@@ -206,6 +316,13 @@ zos_fs_hostfs_close:
     ; Get the abstract value from the user field
     ld a, (hl)
     out (IO_ARG0_REG), a
+    ; Drop the cached entries if they belong to this directory, the host may reuse the value
+    ld hl, hostfs_dir_fd
+    cp (hl)
+    jr nz, _zos_fs_hostfs_close_start
+    xor a
+    ld (hostfs_dir_count), a
+_zos_fs_hostfs_close_start:
     ; Start the operation
     ld a, OP_CLOSE
     out (IO_OPERATION), a
@@ -274,6 +391,9 @@ zos_fs_hostfs_opendir:
     ;       A, BC, DE, HL (can alter any)
     PUBLIC zos_fs_hostfs_readdir
 zos_fs_hostfs_readdir:
+    ld a, (hostfs_v2)
+    or a
+    jr nz, _zos_fs_hostfs_readdir_v2
     ; Provide the structure to fill to the host
     ld a, e
     out (IO_ARG0_REG), a
@@ -286,6 +406,96 @@ zos_fs_hostfs_readdir:
     ld a, OP_READDIR
     out (IO_OPERATION), a
     jp wait_for_completion
+_zos_fs_hostfs_readdir_v2:
+    ; The user field contains the host descriptor followed by the 16-bit index of the next
+    ; entry. The entries are read by batch of CONFIG_EMULATION_HOSTFS_READDIR_BATCH in the
+    ; cache, giving the index to the host lets several directories be read at the same time.
+    push de
+    push hl
+    ld a, (hl)
+    inc hl
+    ld e, (hl)
+    inc hl
+    ld d, (hl)
+    ; Check if the entry is in the cache: same directory and first <= index < first + count
+    ld hl, hostfs_dir_fd
+    cp (hl)
+    jr nz, _zos_fs_hostfs_readdir_fetch
+    ld hl, (hostfs_dir_first)
+    ex de, hl
+    or a
+    sbc hl, de
+    jr c, _zos_fs_hostfs_readdir_restore
+    ld a, h
+    or a
+    jr nz, _zos_fs_hostfs_readdir_restore
+    ld a, l
+    ld hl, hostfs_dir_count
+    cp (hl)
+    jr c, _zos_fs_hostfs_readdir_cached
+    ld h, 0
+    ld l, a
+_zos_fs_hostfs_readdir_restore:
+    ; Get the index back in DE and the descriptor in A
+    add hl, de
+    ex de, hl
+    ld a, (hostfs_dir_fd)
+_zos_fs_hostfs_readdir_fetch:
+    ld (hostfs_dir_fd), a
+    ld (hostfs_block + hostfs_blk_fd_t), a
+    ld (hostfs_dir_first), de
+    ld (hostfs_block + hostfs_blk_off_t), de
+    xor a
+    ld (hostfs_dir_count), a
+    ld (hostfs_block + hostfs_blk_flags_t), a
+    ld h, a
+    ld l, a
+    ld (hostfs_block + hostfs_blk_off_t + 2), hl
+    ld hl, hostfs_dir_cache
+    ld (hostfs_block + hostfs_blk_addr_t), hl
+    ld a, CONFIG_EMULATION_HOSTFS_READDIR_BATCH
+    ld (hostfs_block + hostfs_blk_count_t), a
+    ld a, OP_READDIR
+    call _hostfs_v2_call
+    jr nz, _zos_fs_hostfs_readdir_pop
+    ld a, (hostfs_block + hostfs_blk_count_t)
+    ld (hostfs_dir_count), a
+    or a
+    ld a, ERR_NO_MORE_ENTRIES
+    jr z, _zos_fs_hostfs_readdir_pop
+    xor a
+_zos_fs_hostfs_readdir_cached:
+    ; A is the index of the entry in the cache, calculate its address
+    ASSERT(DISKS_DIR_ENTRY_SIZE == 17)
+    ld l, a
+    ld h, 0
+    ld d, h
+    ld e, l
+    add hl, hl
+    add hl, hl
+    add hl, hl
+    add hl, hl
+    add hl, de
+    ld de, hostfs_dir_cache
+    add hl, de
+    ; Increment the index of the next entry in the user field
+    ex (sp), hl
+    inc hl
+    inc (hl)
+    jr nz, _zos_fs_hostfs_readdir_copy
+    inc hl
+    inc (hl)
+_zos_fs_hostfs_readdir_copy:
+    pop hl
+    pop de
+    ld bc, DISKS_DIR_ENTRY_SIZE
+    ldir
+    xor a
+    ret
+_zos_fs_hostfs_readdir_pop:
+    pop hl
+    pop de
+    ret
 
 
     ; Create a directory on a disk
@@ -329,4 +539,16 @@ zos_fs_hostfs_rm:
     ; Start the operation
     ld a, OP_RM
     out (IO_OPERATION), a
-    jp wait_for_completion
\ No newline at end of file
+    jp wait_for_completion
+
+
+    SECTION KERNEL_BSS
+    ; Non-zero if the host supports the second version of the protocol
+hostfs_v2: DEFS 1
+hostfs_block: DEFS HOSTFS_BLOCK_SIZE
+    ; Directory entries read in advance: `hostfs_dir_count` entries of the directory
+    ; `hostfs_dir_fd`, starting at index `hostfs_dir_first`
+hostfs_dir_fd: DEFS 1
+hostfs_dir_count: DEFS 1
+hostfs_dir_first: DEFS 2
+hostfs_dir_cache: DEFS CONFIG_EMULATION_HOSTFS_READDIR_BATCH * DISKS_DIR_ENTRY_SIZE
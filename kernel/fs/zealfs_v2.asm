@@ -16,8 +16,10 @@
     DEFC FS_NAME_LENGTH   = 16
     DEFC FS_OCCUPIED_BIT  = 7
     DEFC FS_ISDIR_BIT     = 0
+    DEFC FS_INDEX_BIT     = 6
     DEFC FS_OCCUPIED_MASK = 1 << FS_OCCUPIED_BIT
     DEFC FS_ISDIR_MASK    = 1 << FS_ISDIR_BIT
+    DEFC FS_INDEX_MASK    = 1 << FS_INDEX_BIT
 
     DEFC RESERVED_SIZE = 28
 
@@ -42,6 +44,27 @@
         ; The root entries come after the bitmap, it needs to be calculated dynamically
     }
 
+    IF CONFIG_KERNEL_ZEALFS_FIXED_PAGE_SIZE
+    ; The driver only supports disks with the page size selected in the menuconfig, all the
+    ; values derived from it are known at build time.
+    DEFC ZEALFS_PAGE_SIZE_CODE = CONFIG_KERNEL_ZEALFS_PAGE_SIZE_CODE
+    DEFC ZEALFS_PAGE_SIZE      = 256 << ZEALFS_PAGE_SIZE_CODE
+    ; Mask to apply to the second byte of an offset to get the upper byte of the offset in a page
+    DEFC ZEALFS_PAGE_MASK_HIGH = (1 << ZEALFS_PAGE_SIZE_CODE) - 1
+    ENDIF
+
+    IF CONFIG_KERNEL_ZEALFS_DIR_INDEX
+    ; An indexed directory has, as its first entry, an entry flagged with FS_OCCUPIED_MASK and
+    ; FS_INDEX_MASK, with an empty name, which start page is the index. Each byte of the index is
+    ; the hash of the entry at the same slot in the directory, slots being counted across all the
+    ; pages of the directory. A hash of 0 marks a free entry, the index entry itself is marked with
+    ; ZEALFS_INDEX_SELF. The index covers as many slots as a page has bytes, the entries after
+    ; these are browsed without the index.
+    DEFC ZEALFS_INDEX_SELF = 0xff
+    ; Number of bytes of the index read at once while browsing a directory
+    DEFC ZEALFS_INDEX_CACHE_SIZE = 32
+    ENDIF
+
     ; Number of bytes the `zealfs_entry_size` field takes
     DEFC FS_SIZE_WIDTH = 4
 
@@ -95,6 +118,13 @@
     ; Remaining buffer
     DEFC RAM_BUFFER = RAM_FS_HEADER + 6 ; Reserve 6 bytes for RAM_FS_HEADER
     DEFC RAM_BUFFER_SIZE = VFS_WORK_BUFFER_SIZE - 30
+    ASSERT(RAM_BUFFER_SIZE < 256)
+
+    ; Variables used while preallocating a file, the browse variables above are free at that time
+    DEFC RAM_PREALLOC_COUNT = RAM_CUR_CONTEXT       ; Number of pages to allocate
+    DEFC RAM_PREALLOC_NEED  = RAM_CUR_CONTEXT + 2   ; Number of pages left to find/mark/link
+    DEFC RAM_PREALLOC_LAST  = RAM_CUR_PAGE          ; Last page of the file
+    DEFC RAM_PREALLOC_START = RAM_FREE_ENTRY        ; First page of the run of free pages
 
 
     ; Used to create self-modifying code in RAM
@@ -146,6 +176,10 @@ _zos_zealfs_header_size:
     ; Alters:
     ;   A, HL
 _zos_zealfs_page_size:
+    IF CONFIG_KERNEL_ZEALFS_FIXED_PAGE_SIZE
+    ld hl, ZEALFS_PAGE_SIZE & 0xffff
+    ret
+    ELSE
     ld a, (RAM_FS_HEADER + zealfs_page_size_t - zealfs_bitmap_size_t)
     ; The minimum page size is 256 bytes
     ld hl, 256
@@ -162,6 +196,7 @@ _zos_zealfs_page_size_loop:
     ; L is 0, no need to set it again
     ld h, a
     ret
+    ENDIF
 
     ; Same as above, but returns the upper bytes in BC
     ; Parameters:
@@ -171,6 +206,10 @@ _zos_zealfs_page_size_loop:
     ; Alters:
     ;   A, BC, HL
 _zos_zealfs_page_size_upper:
+    IF CONFIG_KERNEL_ZEALFS_FIXED_PAGE_SIZE
+    ld bc, ZEALFS_PAGE_SIZE >> 8
+    ret
+    ELSE
     call _zos_zealfs_page_size
     ld c, h
     ; Check if the result is 0 (64K)
@@ -180,6 +219,7 @@ _zos_zealfs_page_size_upper:
     ret nz
     inc b
     ret
+    ENDIF
 
 
     ; Get the offset (address on the disk) of the root directories entries.
@@ -235,6 +275,10 @@ _zos_zealfs_rootdir_max_entries:
 _zos_zealfs_reg_dir_max_entries:
     ; We could calculate the formula: (_zos_zealfs_page_size() - _zos_zealfs_header_size()) / ZEALFS_ENTRY_SIZE
     ; But we can optimize by reading page size S from the header and calculate (256 / 32) << S.
+    IF CONFIG_KERNEL_ZEALFS_FIXED_PAGE_SIZE
+    ld hl, 8 << ZEALFS_PAGE_SIZE_CODE
+    ret
+    ELSE
     ld a, (RAM_FS_HEADER + zealfs_page_size_t - zealfs_bitmap_size_t)
     ld hl, 8
     or a
@@ -245,6 +289,7 @@ _zos_zealfs_dir_max_entries_loop:
     dec a
     jp nz, _zos_zealfs_dir_max_entries_loop
     ret
+    ENDIF
 
 
     ; Get the maximum number of entries in a directory
@@ -266,6 +311,25 @@ _zos_zealfs_get_dir_max_entries:
     ; Alters:
     ;   A, DE, HL
 _zos_zealfs_phys_from_page:
+    IF CONFIG_KERNEL_ZEALFS_FIXED_PAGE_SIZE
+    IF ZEALFS_PAGE_SIZE_CODE == 8
+    ; 64KB pages, the page number is the upper 16-bit of the address
+    ld hl, 0
+    ret
+    ELSE
+    ex de, hl
+    xor a
+    REPT ZEALFS_PAGE_SIZE_CODE
+    add hl, hl
+    rla
+    ENDR
+    ld d, a
+    ld e, h
+    ld h, l
+    ld l, 0
+    ret
+    ENDIF
+    ELSE
     ; Calculate the 32-bit physical address of the page
     ld a, (RAM_FS_HEADER + zealfs_page_size_t - zealfs_bitmap_size_t) ; Page size
     ex de, hl
@@ -286,6 +350,7 @@ _zos_zealfs_phys_from_page_ret:
     ld h, l
     ld l, 0
     ret
+    ENDIF
 
     ; Like the routine below, browse the absolute path given in HL until the last name is reached.
     ; It will check that all the names on the path corresponds to folders that actually exist on
@@ -297,6 +362,10 @@ zos_zealfs_load_and_check_next_name:
     call zos_zealfs_prepare_driver_read
     call zos_zealfs_prepare_header
     pop hl
+    IF CONFIG_KERNEL_ZEALFS_FIXED_PAGE_SIZE
+    call zos_zealfs_check_page_size
+    ret nz
+    ENDIF
     ; Fall-through
 
     ; Browse the absolute path given in HL and check whether they exist in the filesystem.
@@ -315,6 +384,11 @@ zos_zealfs_load_and_check_next_name:
     ;   A, HL, BC, DE
 _zos_zealfs_check_next_name:
     ; First slash in path MUST BE SKIPPED BY CALLER
+    IF CONFIG_KERNEL_ZEALFS_DIR_INDEX
+    ; No index found out of date yet for this path
+    ld de, 0
+    ld (index_stale), de
+    ENDIF
     ; Iterate over the path, checking each directory existence
     ld c, 1                 ; Marks root directory
     ; The first context to pass to the function is the offset of the root directory,
@@ -416,6 +490,9 @@ _zos_zealfs_check_name_start_search:
     ; right now as the driver's read function parameter instead of setting it at each iteration
     ld hl, RAM_BUFFER
     ld (DRIVER_DE_PARAM), hl
+    IF CONFIG_KERNEL_ZEALFS_DIR_INDEX
+    call _zos_zealfs_index_prepare
+    ENDIF
     call _zos_zealfs_get_dir_max_entries
     ld b, h
     ld c, l
@@ -433,6 +510,12 @@ _zos_zealfs_check_name_driver_read_loop:
     ; Keep DEHL on the stack
     push de
     push hl
+    IF CONFIG_KERNEL_ZEALFS_DIR_INDEX
+    ; Check the index of the directory first, the entry doesn't need to be read if it is
+    ; free or if its hash doesn't match the name's one.
+    call _zos_zealfs_index_probe
+    jr c, _zos_zealfs_check_name_next_offset
+    ENDIF
     ; Get the offset from the context variable, HL is the lowest 16-bit, DE the upper 16-bit
     call RAM_EXE_READ
     ; ; In all cases we will need to pop the name out of the stack
@@ -460,6 +543,14 @@ _zos_zealfs_check_name_next_offset:
     jr nz, _zos_zealfs_no_set
     ld (RAM_FREE_ENTRY), hl
     ld (RAM_FREE_ENTRY + 2), de
+    IF CONFIG_KERNEL_ZEALFS_DIR_INDEX
+    ; Keep the slot of that entry too, its index byte will be set if the entry gets used
+    push hl
+    ld hl, (index_slot)
+    dec hl
+    ld (index_free), hl
+    pop hl
+    ENDIF
 _zos_zealfs_no_set:
     ld bc, ZEALFS_ENTRY_SIZE
     add hl, bc
@@ -876,6 +967,205 @@ _zos_zealfs_close_no_carry:
     jp (hl)
 
 
+    ; Reserve the pages of an opened file so that the given number of bytes can be written to it
+    ; without allocating any page. The missing pages are taken from the first run of free pages
+    ; big enough to hold them all, in which case the bitmap, the FAT and the header are updated
+    ; at once. If no run is big enough, the pages are allocated one by one.
+    ; If the file already has more pages than required, the extra ones are freed.
+    ; The size of the file is not modified by this routine.
+    ; Parameters:
+    ;   HL - Address of the opened file. Guaranteed by the caller to be a valid opened file,
+    ;        opened with write flags.
+    ;   BCDE - 32-bit size to reserve
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+    PUBLIC zos_zealfs_preallocate
+zos_zealfs_preallocate:
+    ; Keep the size on the stack while preparing the driver's routines and the header
+    push bc
+    push de
+    inc hl
+    inc hl
+    ld e, (hl)
+    inc hl
+    ld d, (hl)
+    push hl
+    push de
+    call zos_zealfs_prepare_driver_read
+    pop de
+    call zos_zealfs_prepare_driver_write
+    call zos_zealfs_prepare_header
+    ; The user field contains the address of the file entry on the disk, read its start page
+    pop hl
+    ld bc, opn_file_usr_t - opn_file_driver_t - 1
+    add hl, bc
+    call _zos_helper_offset_from_user_field
+    ; Carry can never occur since the entries are always aligned on the entry size (32 bytes)
+    ld bc, zealfs_entry_start
+    add hl, bc
+    ld bc, RAM_BUFFER
+    ld (DRIVER_DE_PARAM), bc
+    ld bc, 2
+    call RAM_EXE_READ
+    pop de
+    pop bc
+    or a
+    ret nz
+    ; Number of 256-byte blocks needed to store BCDE bytes, rounded up, in AHL
+    ld a, e
+    or a
+    ld a, b
+    ld h, c
+    ld l, d
+    jr z, _zos_zealfs_preallocate_blocks
+    ld bc, 1
+    add hl, bc
+    adc b
+    jp c, _zos_zealfs_preallocate_no_memory
+_zos_zealfs_preallocate_blocks:
+    ; Convert it to a number of pages, rounded up too
+    IF CONFIG_KERNEL_ZEALFS_FIXED_PAGE_SIZE
+    IF ZEALFS_PAGE_SIZE_CODE != 0
+    ld bc, (1 << ZEALFS_PAGE_SIZE_CODE) - 1
+    add hl, bc
+    adc 0
+    jp c, _zos_zealfs_preallocate_no_memory
+    REPT ZEALFS_PAGE_SIZE_CODE
+    srl a
+    rr h
+    rr l
+    ENDR
+    ENDIF
+    ELSE
+    push af
+    push hl
+    call _zos_zealfs_page_size_upper
+    dec bc
+    pop hl
+    pop af
+    add hl, bc
+    adc 0
+    jp c, _zos_zealfs_preallocate_no_memory
+    ld e, a
+    ld a, (RAM_FS_HEADER + zealfs_page_size_t - zealfs_bitmap_size_t)
+    or a
+    jr z, _zos_zealfs_preallocate_pages
+    ld b, a
+_zos_zealfs_preallocate_shift:
+    srl e
+    rr h
+    rr l
+    djnz _zos_zealfs_preallocate_shift
+_zos_zealfs_preallocate_pages:
+    ld a, e
+    ENDIF
+    ; The number of pages must fit in 16 bits
+    or a
+    jp nz, _zos_zealfs_preallocate_no_memory
+    ; A file always keeps its first page
+    or h
+    or l
+    jr nz, _zos_zealfs_preallocate_walk
+    inc l
+_zos_zealfs_preallocate_walk:
+    ; Browse the pages of the file until HL pages are browsed or the end of the file is reached
+    ld de, (RAM_BUFFER)
+_zos_zealfs_preallocate_walk_loop:
+    dec hl
+    ld a, h
+    or l
+    jr z, _zos_zealfs_preallocate_trim
+    push de
+    call zos_zealfs_get_fat_entry
+    ld a, d
+    or e
+    jr z, _zos_zealfs_preallocate_extend
+    ; Pop the previous page without altering DE
+    inc sp
+    inc sp
+    jr _zos_zealfs_preallocate_walk_loop
+_zos_zealfs_preallocate_trim:
+    ; The file already has enough pages, free the ones after page DE, if any
+    push de
+    call zos_zealfs_get_fat_entry
+    pop hl
+    ld a, d
+    or e
+    ret z
+    ; Unlink the extra pages from the file before freeing them
+    push de
+    ex de, hl
+    call zos_zealfs_clear_fat_entry
+    pop de
+    or a
+    ret nz
+    ; Prepare the self-modifying code used by `zos_zealfs_free_page`, as `rm` does
+    ld a, ARITH_OP
+    ld (RAM_EXE_PAGE_0), a
+    ld a, RET_OP
+    ld (RAM_EXE_PAGE_0 + 2), a
+    jp zos_zealfs_remove_page_list
+_zos_zealfs_preallocate_extend:
+    ; The last page of the file is on the top of the stack, HL pages are missing
+    pop de
+    ld (RAM_PREALLOC_LAST), de
+    ld (RAM_PREALLOC_COUNT), hl
+    ; Make sure the disk has enough free pages before modifying anything
+    ex de, hl
+    ld hl, (RAM_FS_HEADER + zealfs_free_pages_t - zealfs_bitmap_size_t)
+    or a
+    sbc hl, de
+    jr c, _zos_zealfs_preallocate_no_memory
+    call _zos_zealfs_prealloc_find_run
+    or a
+    jr z, _zos_zealfs_preallocate_run
+    cp ERR_NO_MORE_MEMORY
+    ret nz
+    ; No run is big enough, allocate the pages one by one, like the writes would do
+_zos_zealfs_preallocate_page_loop:
+    call zos_zealfs_new_page
+    or a
+    ret nz
+    ld hl, (RAM_PREALLOC_LAST)
+    ld (RAM_PREALLOC_LAST), de
+    call zos_zealfs_set_fat_entry
+    or a
+    ret nz
+    ld hl, (RAM_PREALLOC_COUNT)
+    dec hl
+    ld (RAM_PREALLOC_COUNT), hl
+    ld a, h
+    or l
+    jr nz, _zos_zealfs_preallocate_page_loop
+    ret
+_zos_zealfs_preallocate_run:
+    ; The run starts at [RAM_PREALLOC_START], mark its pages as used and chain them
+    call _zos_zealfs_prealloc_mark_bitmap
+    or a
+    ret nz
+    call _zos_zealfs_prealloc_write_fat
+    or a
+    ret nz
+    ; Link the run to the last page of the file
+    ld hl, (RAM_PREALLOC_LAST)
+    ld de, (RAM_PREALLOC_START)
+    call zos_zealfs_set_fat_entry
+    or a
+    ret nz
+    ; Update the number of free pages in the header once for the whole run
+    ld de, (RAM_PREALLOC_COUNT)
+    ld hl, 0
+    sbc hl, de
+    ld b, h
+    ld c, l
+    jp _zos_zealfs_add_free_pages_count
+_zos_zealfs_preallocate_no_memory:
+    ld a, ERR_NO_MORE_MEMORY
+    ret
+
+
     ; Remove a file or an empty directory on the disk.
     ; Parameters:
     ;   HL - Absolute path of the file/dir to remove, without the disk letter (without X:),
@@ -947,8 +1237,14 @@ _zos_zealfs_rm_isdir_loop:
     ret nz
     ; Check that the current entry is empty
     ld a, (RAM_BUFFER)
+    IF CONFIG_KERNEL_ZEALFS_DIR_INDEX
+    ; The index of the directory is not one of its entries
+    bit FS_INDEX_BIT, a
+    jr nz, _zos_zealfs_rm_isdir_next
+    ENDIF
     and FS_OCCUPIED_MASK
     jr nz, _zos_zealfs_rm_isdir_notempty
+_zos_zealfs_rm_isdir_next:
     ; Check if we still have to test any entry
     dec bc
     ld a, b
@@ -982,6 +1278,11 @@ _zos_zealfs_rm_is_empty:
     call _zos_zealfs_rm_mark_as_free
     ; Get the first page of the directory
     ld de, (RAM_BUFFER + zealfs_entry_start)
+    IF CONFIG_KERNEL_ZEALFS_DIR_INDEX
+    push de
+    call _zos_zealfs_index_remove
+    pop de
+    ENDIF
     ; Tail-call, the stack is clean already
     jp zos_zealfs_remove_page_list
 _zos_zealfs_rm_isdir_notempty:
@@ -1000,7 +1301,18 @@ _zos_zealfs_rm_mark_as_free:
     ; Load the offset from RAM_CUR_CONTEXT
     ld hl, (RAM_CUR_CONTEXT)
     ld de, (RAM_CUR_CONTEXT + 2)
+    IF CONFIG_KERNEL_ZEALFS_DIR_INDEX
+    call RAM_EXE_WRITE
+    or a
+    ret nz
+    ; Free the entry in the index of the directory too, its slot is the last one browsed
+    ld hl, (index_slot)
+    dec hl
+    ld (index_free), hl
+    jp _zos_zealfs_index_set
+    ELSE
     jp RAM_EXE_WRITE
+    ENDIF
 
 
     ;============= D I R E C T O R I E S   R O U T I N E S ================;
@@ -1111,6 +1423,14 @@ _zos_zealfs_opendir_root:
     ld c, e
     push bc
     call zos_zealfs_prepare_driver_read
+    IF CONFIG_KERNEL_ZEALFS_FIXED_PAGE_SIZE
+    ; Reject the disk before allocating a descriptor
+    call zos_zealfs_prepare_header
+    call zos_zealfs_check_page_size
+    pop bc
+    ret nz
+    push bc
+    ENDIF
     ld a, FS_ZEALFS
     call zos_disk_allocate_opndir
     pop bc
@@ -1257,6 +1577,11 @@ zos_zealfs_readdir_no_carry:
     ; Check if the entry we read was empty or not, if A's bit 7 is not 0, an entry has been found!
     bit 7, a
     jp z, zos_zealfs_readdir_next
+    IF CONFIG_KERNEL_ZEALFS_DIR_INDEX
+    ; The index is always the first entry of a page, never the last one, skip it
+    bit FS_INDEX_BIT, a
+    jp nz, zos_zealfs_readdir_next
+    ENDIF
     ; -----------------------------
     ; An entry has been found! Update the opened dir entry structure with the offset reached (HL)
     ; and the remaining number of entries to scan.
@@ -1431,6 +1756,12 @@ zos_zealfs_mkdir:
     ; Set the first byte of the buffer to 0, it will clean the directories entries.
     ld hl, (RAM_CUR_CONTEXT + 0)
     ld de, (RAM_CUR_CONTEXT + 2)
+    IF CONFIG_KERNEL_ZEALFS_DIR_INDEX
+    call zos_zealfs_clear_dir
+    or a
+    ret nz
+    jp _zos_zealfs_index_create
+    ENDIF
     ; Parameters:
     ;   DEHL - Physical address of the directory to clear?
 zos_zealfs_clear_dir:
@@ -1493,6 +1824,31 @@ _zos_zealfs_mkdir_already_exists:
     ; Alters:
     ;   A, BC, DE, HL
 zos_zealfs_get_page_addr_in_fat:
+    IF CONFIG_KERNEL_ZEALFS_FIXED_PAGE_SIZE
+    IF ZEALFS_PAGE_SIZE_CODE == 0
+    ; Pages are 256 bytes big, the FAT is page 1 and each entry is 1 byte, D is 0 (guaranteed)
+    ld l, e
+    ld h, 1
+    xor a
+    ld e, a
+    ; DEHL (0x000001xx) points to the entry, Z flag is set
+    ret
+    ELSE
+    ; The FAT starts at the second page, each entry is 2 bytes: AHL = page * 2 + page size
+    ex de, hl
+    xor a
+    add hl, hl
+    rla
+    ld de, ZEALFS_PAGE_SIZE & 0xffff
+    add hl, de
+    adc ZEALFS_PAGE_SIZE >> 16
+    ld e, a
+    ld d, 0
+    ; A is 0, 1 or 2, incrementing it will never be 0, so the Z flag is not set
+    inc a
+    ret
+    ENDIF
+    ELSE
     ld b, d
     ld c, e
     ; Get the size of a single page on the disk
@@ -1532,6 +1888,7 @@ zos_zealfs_get_entry_addr_256:
     ; DEHL (0x000001xx) points to the address on disk of the next page of the given page
     ; Z flag is still set!
     ret
+    ENDIF
 
 
     ; Get the next page of a given page from the FAT
@@ -1912,6 +2269,25 @@ zos_zealfs_seek:
     call RAM_EXE_READ
     or a
     jr nz, _zos_zealfs_seek_read_error
+    IF CONFIG_KERNEL_ZEALFS_FIXED_PAGE_SIZE
+    ; Put the offset in DEHL
+    pop de
+    pop hl
+    ; The remainder is made of L and the lowest bits of H
+    ld c, l
+    ld a, h
+    and ZEALFS_PAGE_MASK_HIGH
+    ld b, a
+    ; EHL will be the result, shift by 8 directly, and then by the page size
+    ld l, h
+    ld h, e
+    ld e, d
+    REPT ZEALFS_PAGE_SIZE_CODE
+    srl e
+    rr h
+    rr l
+    ENDR
+    ELSE
     ; Get the page size from the header, this represents the number of right
     ; shift to perform to divide the address with the page size:
     ;   0 - 256
@@ -1953,6 +2329,7 @@ _zos_zealfs_seek_mirror:
 _zos_zealfs_seek_no_shift:
     ; Remainder in BC instead of AC
     ld b, a
+    ENDIF
     ; Keep the remainder on the stack
     push bc
     ; We have to get the next page EHL times, put it in CHL
@@ -2226,62 +2603,408 @@ _zos_zealfs_free_page_error:
     ret
 
 
-    ; Create a new entry at the last known FREE_ENTRY location.
-    ; This routine allocates a new page, update the entry, the disk header, the bitmap
-    ; and returns the new page allocated.
-    ; In case of a directory, the size will be set to a page size (256). In case of a
-    ; file, it will be set to 0.
+    ; Look for the first run of free pages big enough to hold the pages to allocate
     ; Parameters:
-    ;   HL - Name of the entry
-    ;   DE - Disk driver address
-    ;   B - 1 for a directory, 0 for a regular file
-    ;   [RAM_EXE_READ]   - Must be preloaded with the driver's read routine address.
-    ;   [RAM_FS_HEADER]  - Filled with FS header
-    ;   [RAM_FREE_ENTRY] - Last known free entry address (32-bit)
+    ;   [RAM_PREALLOC_COUNT] - Number of pages to allocate, not 0
+    ;   [RAM_FS_HEADER] - Must be already populated with FS header
+    ;   [RAM_EXE_READ]  - Must be already populated with driver's read routine
     ; Returns:
-    ;   A - ERR_SUCCESS on success, error code else
-    ;   [RAM_CUR_CONTEXT] - 32-bit physical address of the new allocated page
-    ;   [RAM_FREE_ENTRY] - 32-bit physical address of the new entry
+    ;   A - ERR_SUCCESS if a run was found, ERR_NO_MORE_MEMORY if no run is big enough,
+    ;       error code else
+    ;   [RAM_PREALLOC_START] - First page of the run
     ; Alters:
     ;   A, BC, DE, HL
-zos_zealfs_new_entry:
-    ; Prepare the write routine from the driver to the buffer
-    push hl
-    call zos_zealfs_prepare_driver_write
-    pop hl
-    ; We won't need the driver address anymore, re-use it
-    ; Check if a free entry was found or not
-    ld de, (RAM_FREE_ENTRY)
-    ld a, d
-    or e
-    ld de, (RAM_FREE_ENTRY + 2)
-    or d
-    or e
-    jr z, _zos_zealfs_new_entry_full
-_zos_zealfs_new_entry_resume:
+_zos_zealfs_prealloc_find_run:
+    ld hl, (RAM_PREALLOC_COUNT)
+    ld (RAM_PREALLOC_NEED), hl
+    ; Read the bitmap by chunks, HL is the offset of the chunk on the disk, BC the number of
+    ; bytes left in the bitmap and DE the index of the page of the chunk's first bit
+    ld de, 0
+    ld hl, zealfs_pages_bitmap
+    ld bc, (RAM_FS_HEADER + zealfs_bitmap_size_t - zealfs_bitmap_size_t)
+_zos_zealfs_prealloc_find_chunk:
     push hl
     push bc
-    ; Allocate a page from the header
-    call zos_zealfs_new_page
-    or a
-    jr nz, _zos_zealfs_pop_all_ret
-    ; Index of the new page is in DE, calculate the new page address, do not alter DE
     push de
-    call _zos_zealfs_phys_from_page
-    ; Save DEHL (physical address) as the return value
-    ld (RAM_CUR_CONTEXT), hl
-    ld (RAM_CUR_CONTEXT + 2), de
+    ; Size of the chunk: min(BC, RAM_BUFFER_SIZE)
+    ld h, b
+    ld l, c
+    ld bc, RAM_BUFFER_SIZE
+    or a
+    sbc hl, bc
+    jr nc, _zos_zealfs_prealloc_find_read
+    add hl, bc
+    ld b, h
+    ld c, l
+_zos_zealfs_prealloc_find_read:
+    ; Get the offset back, the bitmap is always in the first 64KB of the disk
+    ld hl, 4
+    add hl, sp
+    ld a, (hl)
+    inc hl
+    ld h, (hl)
+    ld l, a
+    push bc
+    ld de, RAM_BUFFER
+    ld (DRIVER_DE_PARAM), de
+    ld de, 0
+    call RAM_EXE_READ
+    pop bc
     pop de
-    ; The header (w/ bitmap) has been updated, now, create a new file entry in the RAM_BUFFER
-    ; that will be used to flash the free entry found.
-    ; Clean up the structure first
-    call _zealfs_clear_buffer
-    ; Populate the flags first, we will need BC for this (we have to pop first...)
+    or a
+    jr nz, _zos_zealfs_prealloc_find_pop_ret
+    ; Browse the bytes of the chunk, the size is smaller than 256
+    ld b, c
+    ld hl, RAM_BUFFER
+_zos_zealfs_prealloc_find_byte:
+    ld a, (hl)
+    inc a
+    jr nz, _zos_zealfs_prealloc_find_bits
+    ; All the 8 pages are used, the current run is broken
+    scf
+    call _zos_zealfs_prealloc_find_page
+    ld a, 8
+    add e
+    ld e, a
+    adc d
+    sub e
+    ld d, a
+    jr _zos_zealfs_prealloc_find_next
+_zos_zealfs_prealloc_find_bits:
+    dec a
+    push bc
+    ld c, a
+    ld b, 8
+_zos_zealfs_prealloc_find_bits_loop:
+    rr c
+    call _zos_zealfs_prealloc_find_page
+    inc de
+    djnz _zos_zealfs_prealloc_find_bits_loop
     pop bc
+_zos_zealfs_prealloc_find_next:
+    ; Stop as soon as the run is big enough
+    ld a, (RAM_PREALLOC_NEED)
+    push hl
+    ld hl, RAM_PREALLOC_NEED + 1
+    or (hl)
     pop hl
-    ; Start page is in DE, store it in the buffer directly
-    ld (RAM_BUFFER + zealfs_entry_start), de
-    ld a, b
+    jr z, _zos_zealfs_prealloc_find_pop_ret
+    inc hl
+    djnz _zos_zealfs_prealloc_find_byte
+    ; End of the chunk, C still contains its size, go to the next one
+    ld b, 0
+    pop hl
+    or a
+    sbc hl, bc
+    ex (sp), hl
+    add hl, bc
+    pop bc
+    ld a, b
+    or c
+    jp nz, _zos_zealfs_prealloc_find_chunk
+    ld a, ERR_NO_MORE_MEMORY
+    ret
+_zos_zealfs_prealloc_find_pop_ret:
+    pop hl
+    pop hl
+    ret
+
+    ; Account for a page in the current run of free pages
+    ; Parameters:
+    ;   DE - Index of the page
+    ;   Carry - Set if the page is used, not set if it is free
+    ; Returns:
+    ;   [RAM_PREALLOC_NEED] - Pages still needed, 0 once the run is big enough
+    ;   [RAM_PREALLOC_START] - First page of the run
+    ; Alters:
+    ;   A
+_zos_zealfs_prealloc_find_page:
+    push hl
+    ld hl, (RAM_PREALLOC_NEED)
+    jr nc, _zos_zealfs_prealloc_find_page_free
+    ; Used page, start over, unless the run is already big enough
+    ld a, h
+    or l
+    jr z, _zos_zealfs_prealloc_find_page_end
+    ld hl, (RAM_PREALLOC_COUNT)
+    jr _zos_zealfs_prealloc_find_page_save
+_zos_zealfs_prealloc_find_page_free:
+    ; Once the run is big enough, it must not be altered anymore
+    ld a, h
+    or l
+    jr z, _zos_zealfs_prealloc_find_page_end
+    ; If no page was found yet, this page starts the run
+    push de
+    ld de, (RAM_PREALLOC_COUNT)
+    sbc hl, de
+    add hl, de
+    pop de
+    jr nz, _zos_zealfs_prealloc_find_page_dec
+    ld (RAM_PREALLOC_START), de
+_zos_zealfs_prealloc_find_page_dec:
+    dec hl
+_zos_zealfs_prealloc_find_page_save:
+    ld (RAM_PREALLOC_NEED), hl
+_zos_zealfs_prealloc_find_page_end:
+    pop hl
+    ret
+
+
+    ; Mark the pages of the run as used in the bitmap, each byte of the bitmap is written once
+    ; Parameters:
+    ;   [RAM_PREALLOC_START] - First page of the run
+    ;   [RAM_PREALLOC_COUNT] - Number of pages in the run, not 0
+    ;   [RAM_EXE_READ]  - Must be already populated with driver's read routine
+    ;   [RAM_EXE_WRITE] - Must be already populated with driver's write routine
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+_zos_zealfs_prealloc_mark_bitmap:
+    ld hl, (RAM_PREALLOC_COUNT)
+    ld (RAM_PREALLOC_NEED), hl
+    ld de, (RAM_PREALLOC_START)
+_zos_zealfs_prealloc_mark_chunk:
+    ; DE is the next page to mark. Index of the byte containing the last page in HL
+    ld hl, (RAM_PREALLOC_NEED)
+    dec hl
+    add hl, de
+    REPT 3
+    srl h
+    rr l
+    ENDR
+    ; Index of the byte containing page DE in BC
+    ld b, d
+    ld c, e
+    REPT 3
+    srl b
+    rr c
+    ENDR
+    ; Number of bytes to update: min(HL - BC + 1, RAM_BUFFER_SIZE)
+    or a
+    sbc hl, bc
+    inc hl
+    push bc
+    ld bc, RAM_BUFFER_SIZE
+    or a
+    sbc hl, bc
+    jr nc, _zos_zealfs_prealloc_mark_read
+    add hl, bc
+    ld b, h
+    ld c, l
+_zos_zealfs_prealloc_mark_read:
+    ; Offset of the chunk on the disk, always in the first 64KB
+    pop hl
+    push de
+    ld de, zealfs_pages_bitmap
+    add hl, de
+    push hl
+    push bc
+    ld de, RAM_BUFFER
+    ld (DRIVER_DE_PARAM), de
+    ld de, 0
+    call RAM_EXE_READ
+    pop bc
+    pop hl
+    pop de
+    or a
+    ret nz
+    ; Keep the offset and the size to write the chunk back
+    push hl
+    push bc
+    ; Mask of page DE's bit in C, number of bytes in the chunk in B
+    ld a, e
+    and 7
+    inc a
+    ld b, a
+    ld a, 0x80
+_zos_zealfs_prealloc_mark_mask:
+    rlca
+    djnz _zos_zealfs_prealloc_mark_mask
+    ld b, c
+    ld c, a
+    ld hl, RAM_BUFFER
+_zos_zealfs_prealloc_mark_loop:
+    ld a, (hl)
+    or c
+    ld (hl), a
+    inc de
+    push hl
+    ld hl, (RAM_PREALLOC_NEED)
+    dec hl
+    ld (RAM_PREALLOC_NEED), hl
+    ld a, h
+    or l
+    pop hl
+    jr z, _zos_zealfs_prealloc_mark_write
+    ; Go to the next byte when the mask wraps around
+    rlc c
+    jr nc, _zos_zealfs_prealloc_mark_loop
+    inc hl
+    djnz _zos_zealfs_prealloc_mark_loop
+_zos_zealfs_prealloc_mark_write:
+    pop bc
+    pop hl
+    push de
+    ld de, 0
+    call RAM_EXE_WRITE
+    pop de
+    or a
+    ret nz
+    ; Continue with the next chunk if any page is left to mark
+    ld hl, (RAM_PREALLOC_NEED)
+    ld a, h
+    or l
+    jp nz, _zos_zealfs_prealloc_mark_chunk
+    ret
+
+
+    ; Chain the pages of the run in the FAT, the entries are contiguous so they are written
+    ; by chunks. The last page of the run has no next page.
+    ; Parameters:
+    ;   [RAM_PREALLOC_START] - First page of the run
+    ;   [RAM_PREALLOC_COUNT] - Number of pages in the run, not 0
+    ;   [RAM_EXE_WRITE] - Must be already populated with driver's write routine
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+_zos_zealfs_prealloc_write_fat:
+    ld hl, (RAM_PREALLOC_COUNT)
+    ld (RAM_PREALLOC_NEED), hl
+    ld hl, RAM_BUFFER
+    ld (DRIVER_DE_PARAM), hl
+    ld de, (RAM_PREALLOC_START)
+_zos_zealfs_prealloc_fat_chunk:
+    ; Get the address of page DE's entry, keep it on the stack
+    push de
+    call zos_zealfs_get_page_addr_in_fat
+    ; Size of an entry in C
+    ld c, 1
+    jr z, _zos_zealfs_prealloc_fat_width
+    inc c
+_zos_zealfs_prealloc_fat_width:
+    ex (sp), hl
+    push de
+    push hl
+    ; Number of entries in this chunk in B: min([RAM_PREALLOC_NEED], RAM_BUFFER_SIZE / 2)
+    ld hl, (RAM_PREALLOC_NEED)
+    ld de, RAM_BUFFER_SIZE / 2
+    or a
+    sbc hl, de
+    ld b, e
+    jr nc, _zos_zealfs_prealloc_fat_count
+    add hl, de
+    ld b, l
+    ld hl, 0
+_zos_zealfs_prealloc_fat_count:
+    ld (RAM_PREALLOC_NEED), hl
+    ; Fill the buffer, each page of the run is linked to the next one
+    pop de
+    ld hl, RAM_BUFFER
+_zos_zealfs_prealloc_fat_fill:
+    inc de
+    ld (hl), e
+    inc hl
+    bit 1, c
+    jr z, _zos_zealfs_prealloc_fat_fill_next
+    ld (hl), d
+    inc hl
+_zos_zealfs_prealloc_fat_fill_next:
+    djnz _zos_zealfs_prealloc_fat_fill
+    ; If the run ends in this chunk, its last page has no next page
+    ld a, (RAM_PREALLOC_NEED)
+    ld b, a
+    ld a, (RAM_PREALLOC_NEED + 1)
+    or b
+    jr nz, _zos_zealfs_prealloc_fat_write
+    dec hl
+    ld (hl), a
+    dec c
+    jr z, _zos_zealfs_prealloc_fat_last
+    dec hl
+    ld (hl), a
+    inc hl
+_zos_zealfs_prealloc_fat_last:
+    inc hl
+_zos_zealfs_prealloc_fat_write:
+    ; Number of bytes to write in BC
+    ld bc, RAM_BUFFER
+    or a
+    sbc hl, bc
+    ld b, h
+    ld c, l
+    ; Address of the entries in DEHL, keep the next page to process on the stack
+    ex de, hl
+    pop de
+    ex (sp), hl
+    call RAM_EXE_WRITE
+    pop de
+    or a
+    ret nz
+    ld hl, (RAM_PREALLOC_NEED)
+    ld a, h
+    or l
+    jr nz, _zos_zealfs_prealloc_fat_chunk
+    ret
+
+
+    ; Create a new entry at the last known FREE_ENTRY location.
+    ; This routine allocates a new page, update the entry, the disk header, the bitmap
+    ; and returns the new page allocated.
+    ; In case of a directory, the size will be set to a page size (256). In case of a
+    ; file, it will be set to 0.
+    ; Parameters:
+    ;   HL - Name of the entry
+    ;   DE - Disk driver address
+    ;   B - 1 for a directory, 0 for a regular file
+    ;   [RAM_EXE_READ]   - Must be preloaded with the driver's read routine address.
+    ;   [RAM_FS_HEADER]  - Filled with FS header
+    ;   [RAM_FREE_ENTRY] - Last known free entry address (32-bit)
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ;   [RAM_CUR_CONTEXT] - 32-bit physical address of the new allocated page
+    ;   [RAM_FREE_ENTRY] - 32-bit physical address of the new entry
+    ; Alters:
+    ;   A, BC, DE, HL
+zos_zealfs_new_entry:
+    ; Prepare the write routine from the driver to the buffer
+    push hl
+    call zos_zealfs_prepare_driver_write
+    pop hl
+    ; We won't need the driver address anymore, re-use it
+    ; Check if a free entry was found or not
+    ld de, (RAM_FREE_ENTRY)
+    ld a, d
+    or e
+    ld de, (RAM_FREE_ENTRY + 2)
+    or d
+    or e
+    jr z, _zos_zealfs_new_entry_full
+_zos_zealfs_new_entry_resume:
+    push hl
+    push bc
+    ; Allocate a page from the header
+    call zos_zealfs_new_page
+    or a
+    jr nz, _zos_zealfs_pop_all_ret
+    ; Index of the new page is in DE, calculate the new page address, do not alter DE
+    push de
+    call _zos_zealfs_phys_from_page
+    ; Save DEHL (physical address) as the return value
+    ld (RAM_CUR_CONTEXT), hl
+    ld (RAM_CUR_CONTEXT + 2), de
+    pop de
+    ; The header (w/ bitmap) has been updated, now, create a new file entry in the RAM_BUFFER
+    ; that will be used to flash the free entry found.
+    ; Clean up the structure first
+    call _zealfs_clear_buffer
+    ; Populate the flags first, we will need BC for this (we have to pop first...)
+    pop bc
+    pop hl
+    ; Start page is in DE, store it in the buffer directly
+    ld (RAM_BUFFER + zealfs_entry_start), de
+    ld a, b
     or 0x80
     ; Fill the RAM_BUFFER with the new entry
     ld de, RAM_BUFFER
@@ -2312,8 +3035,17 @@ _zos_zealfs_new_entry_resume:
     ld hl, (RAM_FREE_ENTRY)
     ld de, (RAM_FREE_ENTRY + 2)
     ld bc, ZEALFS_ENTRY_SIZE
+    IF CONFIG_KERNEL_ZEALFS_DIR_INDEX
+    call RAM_EXE_WRITE
+    or a
+    ret nz
+    ; Register the new entry in the index of the directory, the name is the last one looked for
+    ld a, (index_hash)
+    jp _zos_zealfs_index_set
+    ELSE
     ; Tail-call
     jp RAM_EXE_WRITE
+    ENDIF
 _zos_zealfs_new_entry_full:
     ; Save the entry name and its flag
     push hl
@@ -2338,6 +3070,11 @@ _zos_zealfs_new_entry_full:
     ; Physical address in DEHL
     ld (RAM_FREE_ENTRY), hl
     ld (RAM_FREE_ENTRY + 2), de
+    IF CONFIG_KERNEL_ZEALFS_DIR_INDEX
+    ; All the slots of the directory were browsed, the first one of the new page comes next
+    ld hl, (index_slot)
+    ld (index_free), hl
+    ENDIF
     ; New page allocate in the bitmap and FAT table! We need to clear the first bytes of every entry (except the
     ; first one since we are going to re-use it anyway)
     call zos_zealfs_clear_dir
@@ -2377,6 +3114,414 @@ _zealfs_clear_buffer:
     pop hl
     ret
 
+    IF CONFIG_KERNEL_ZEALFS_DIR_INDEX
+
+    ; Calculate the hash of an entry name, as stored in the directories indexes
+    ; Parameters:
+    ;   HL - Name of the entry, ending with a NULL-byte or FS_NAME_LENGTH characters long
+    ; Returns:
+    ;   A - Hash of the name, never 0 nor ZEALFS_INDEX_SELF
+    ; Alters:
+    ;   A, BC, HL
+_zos_zealfs_index_hash:
+    ld b, FS_NAME_LENGTH
+    xor a
+_zos_zealfs_index_hash_loop:
+    ld c, (hl)
+    inc c
+    dec c
+    jr z, _zos_zealfs_index_hash_end
+    rlca
+    xor c
+    inc hl
+    djnz _zos_zealfs_index_hash_loop
+_zos_zealfs_index_hash_end:
+    ; 0 and ZEALFS_INDEX_SELF are reserved
+    or a
+    jr z, _zos_zealfs_index_hash_reserved
+    cp ZEALFS_INDEX_SELF
+    ret nz
+_zos_zealfs_index_hash_reserved:
+    ld a, 1
+    ret
+
+
+    ; Prepare the index of the directory about to be browsed by `_zos_zealfs_check_next_name_nested`
+    ; Parameters:
+    ;   C - 1 if root directory, 0 else
+    ;   [RAM_CUR_NAME] - Name to look for
+    ;   [RAM_CUR_CONTEXT] - Physical address of the first entry of the directory
+    ;   [DRIVER_DE_PARAM] - RAM_BUFFER
+    ; Returns:
+    ;   [index_page] - Index of the directory, 0 if it has none
+    ; Alters:
+    ;   A, DE, HL
+_zos_zealfs_index_prepare:
+    ld hl, 0
+    ld (index_page), hl
+    ld (index_slot), hl
+    dec hl
+    ld (index_base), hl
+    ; The root directory has no index
+    bit 0, c
+    ret nz
+    push bc
+    ld hl, (RAM_CUR_NAME)
+    call _zos_zealfs_index_hash
+    ld (index_hash), a
+    ; The index, if any, is described by the first entry of the directory
+    ld hl, (RAM_CUR_CONTEXT)
+    ld de, (RAM_CUR_CONTEXT + 2)
+    ld bc, zealfs_entry_start + 2
+    call RAM_EXE_READ
+    pop bc
+    ; On error, browse the directory without index, the error will be caught again
+    or a
+    ret nz
+    ld a, (RAM_BUFFER + zealfs_entry_flags)
+    and FS_OCCUPIED_MASK | FS_INDEX_MASK
+    cp FS_OCCUPIED_MASK | FS_INDEX_MASK
+    ret nz
+    ld hl, (RAM_BUFFER + zealfs_entry_start)
+    ld (index_page), hl
+    ; Keep the address of the index entry in case the index turns out to be out of date
+    ld hl, (RAM_CUR_CONTEXT)
+    ld (index_dir), hl
+    ld hl, (RAM_CUR_CONTEXT + 2)
+    ld (index_dir + 2), hl
+    ret
+
+
+    ; Check the index of the directory being browsed to know whether its next entry has to be read.
+    ; Kernels built without the index and other tools can add entries to an indexed directory
+    ; without updating its index, so the flags of an entry marked as free are read to make sure
+    ; it really is free. If it isn't, the index is not used anymore and is dropped on the next
+    ; write to the disk, see `_zos_zealfs_index_set`.
+    ; Parameters:
+    ;   DEHL - Physical address of the entry
+    ;   [index_page] - Index of the directory, 0 if it has none
+    ;   [index_slot] - Slot of the entry in the directory, incremented by this routine
+    ;   [DRIVER_DE_PARAM] - RAM_BUFFER
+    ; Returns:
+    ;   Carry - Set if the entry doesn't need to be read, in that case:
+    ;       Z flag - Set if the entry is free, not set if it is used by another name
+    ;   [index_stale] - Index of the directory if it was found out of date
+    ; Alters:
+    ;   A
+_zos_zealfs_index_probe:
+    push hl
+    push de
+    push bc
+    ld hl, (index_page)
+    ld a, h
+    or l
+    ; Carry is not set, the entry has to be read
+    jr z, _zos_zealfs_index_probe_ret
+    ld hl, (index_slot)
+    ld b, h
+    ld c, l
+    inc hl
+    ld (index_slot), hl
+    ; The index only covers as many slots as a page has bytes, 0 means 64KB
+    call _zos_zealfs_page_size
+    ld a, h
+    or l
+    jr z, _zos_zealfs_index_probe_covered
+    ; Carry is set if the slot is covered
+    ld a, c
+    sub l
+    ld a, b
+    sbc h
+    jr nc, _zos_zealfs_index_probe_ret
+_zos_zealfs_index_probe_covered:
+    ; Check if the slot is in the cache
+    ld a, c
+    and -ZEALFS_INDEX_CACHE_SIZE
+    ld l, a
+    ld h, b
+    ld de, (index_base)
+    or a
+    sbc hl, de
+    add hl, de
+    ; On error, the index is dropped and the entry is read
+    call nz, _zos_zealfs_index_load
+    jr nz, _zos_zealfs_index_probe_ret
+    ld a, c
+    and ZEALFS_INDEX_CACHE_SIZE - 1
+    ld hl, index_cache
+    ADD_HL_A()
+    ld a, (hl)
+    or a
+    jr z, _zos_zealfs_index_probe_free
+    ld hl, index_hash
+    cp (hl)
+    ; Carry is not set if the hashes are equal
+    jr z, _zos_zealfs_index_probe_ret
+    ; Z flag is not set, the entry is used by another name
+    scf
+_zos_zealfs_index_probe_ret:
+    pop bc
+    pop de
+    pop hl
+    ret
+_zos_zealfs_index_probe_free:
+    ; Read the flags of the entry, its address is still on the stack
+    pop bc
+    pop de
+    pop hl
+    push hl
+    push de
+    push bc
+    ld bc, 1
+    call RAM_EXE_READ
+    or a
+    jr nz, _zos_zealfs_index_probe_unused
+    ld a, (RAM_BUFFER + zealfs_entry_flags)
+    and FS_OCCUPIED_MASK
+    ; Z flag is set if the entry is free, `scf` doesn't alter it
+    scf
+    jr z, _zos_zealfs_index_probe_ret
+    ; The entry is used, the index is out of date
+    ld hl, (index_page)
+    ld (index_stale), hl
+    ld hl, (index_dir)
+    ld (index_stale_dir), hl
+    ld hl, (index_dir + 2)
+    ld (index_stale_dir + 2), hl
+_zos_zealfs_index_probe_unused:
+    ; Browse the rest of the directory without the index, A is not 0, clear the carry
+    ld hl, 0
+    ld (index_page), hl
+    or a
+    jr _zos_zealfs_index_probe_ret
+
+
+    ; Load the index bytes starting at the given slot in the cache
+    ; Parameters:
+    ;   HL - First slot to load, aligned on ZEALFS_INDEX_CACHE_SIZE
+    ;   [index_page] - Index to read
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else, the index is dropped in that case
+    ;   Z flag - Set on success
+    ;   [DRIVER_DE_PARAM] - RAM_BUFFER
+    ; Alters:
+    ;   A, DE, HL
+_zos_zealfs_index_load:
+    push bc
+    ld (index_base), hl
+    push hl
+    ld de, (index_page)
+    call _zos_zealfs_phys_from_page
+    ; The slot is smaller than the page size, no carry can occur
+    pop bc
+    add hl, bc
+    ld bc, index_cache
+    ld (DRIVER_DE_PARAM), bc
+    ld bc, ZEALFS_INDEX_CACHE_SIZE
+    call RAM_EXE_READ
+    ld hl, RAM_BUFFER
+    ld (DRIVER_DE_PARAM), hl
+    pop bc
+    or a
+    ret z
+    ld hl, 0
+    ld (index_page), hl
+    ld (index_base), hl
+    ret
+
+
+    ; Write the index byte of the entry at slot [index_free] in the index of the directory
+    ; that was browsed last. If an index was found out of date while browsing, it is dropped
+    ; first.
+    ; Parameters:
+    ;   A - Byte to write, the hash of the entry name, 0 if the entry is freed
+    ;   [index_page] - Index of the directory, nothing is done if 0
+    ;   [index_free] - Slot of the entry
+    ;   [index_stale] - Index found out of date, 0 if none
+    ;   [RAM_EXE_WRITE] - Must be populated already with driver's write routine
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+_zos_zealfs_index_set:
+    ld (index_byte), a
+    ld hl, (index_stale)
+    ld a, h
+    or l
+    call nz, _zos_zealfs_index_drop
+    ld de, (index_page)
+    ld a, d
+    or e
+    ret z
+    ; Slots that are not covered by the index have nothing to update
+    call _zos_zealfs_page_size
+    ld bc, (index_free)
+    ld a, h
+    or l
+    jr z, _zos_zealfs_index_set_covered
+    ld a, c
+    sub l
+    ld a, b
+    sbc h
+    ld a, ERR_SUCCESS
+    ret nc
+_zos_zealfs_index_set_covered:
+    push bc
+    call _zos_zealfs_phys_from_page
+    pop bc
+    add hl, bc
+    ld bc, index_byte
+    ld (DRIVER_DE_PARAM), bc
+    ld bc, 1
+    jp RAM_EXE_WRITE
+
+
+    ; Drop the index of a directory that was found out of date: its index entry is marked as
+    ; free and its page is freed, the directory is then browsed entry by entry.
+    ; Parameters:
+    ;   HL - Index to drop, [index_stale]
+    ;   [index_stale_dir] - Physical address of the index entry of the directory
+    ;   [RAM_EXE_WRITE] - Must be populated already with driver's write routine
+    ; Returns:
+    ;   None, the directory is still usable if the index can't be dropped
+    ; Alters:
+    ;   A, BC, DE, HL
+_zos_zealfs_index_drop:
+    push hl
+    ld hl, 0
+    ld (index_stale), hl
+    ; Clear the flags of the index entry, `index_stale` is now a zero byte to write
+    ld hl, index_stale
+    ld (DRIVER_DE_PARAM), hl
+    ld hl, (index_stale_dir)
+    ld de, (index_stale_dir + 2)
+    ld bc, 1
+    call RAM_EXE_WRITE
+    pop de
+    or a
+    ret nz
+    ; `zos_zealfs_free_page` reads the bitmap in RAM_BUFFER, which still holds the entry
+    ; the caller is working on, keep its first byte
+    ld a, ARITH_OP
+    ld (RAM_EXE_PAGE_0), a
+    ld a, RET_OP
+    ld (RAM_EXE_PAGE_0 + 2), a
+    ld a, (RAM_BUFFER)
+    push af
+    call zos_zealfs_free_page
+    pop af
+    ld (RAM_BUFFER), a
+    ret
+
+
+    ; Give an index to a directory that was just created. If no page can be allocated for
+    ; it, the directory is left without an index. If the index can't be written, its page
+    ; is freed and the directory is left without an index too.
+    ; Parameters:
+    ;   [RAM_CUR_CONTEXT] - Physical address of the new directory, which must be empty
+    ;   [RAM_EXE_READ]  - Must be populated already with driver's read routine
+    ;   [RAM_EXE_WRITE] - Must be populated already with driver's write routine
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+_zos_zealfs_index_create:
+    call zos_zealfs_new_page
+    or a
+    jr nz, _zos_zealfs_index_create_none
+    push de
+    ; Clear the index ZEALFS_ENTRY_SIZE bytes at a time, the first byte is the index entry itself
+    call _zealfs_clear_buffer
+    ld hl, RAM_BUFFER
+    ld (DRIVER_DE_PARAM), hl
+    ld (hl), ZEALFS_INDEX_SELF
+    call _zos_zealfs_phys_from_page
+    push de
+    push hl
+    ; Number of writes to perform: page size / ZEALFS_ENTRY_SIZE = (page size / 256) * 8
+    call _zos_zealfs_page_size_upper
+    sla c
+    rl b
+    sla c
+    rl b
+    sla c
+    rl b
+    pop hl
+    pop de
+_zos_zealfs_index_create_loop:
+    push bc
+    push de
+    push hl
+    ld bc, ZEALFS_ENTRY_SIZE
+    call RAM_EXE_WRITE
+    ld hl, RAM_BUFFER
+    ld (hl), 0
+    pop hl
+    ld bc, ZEALFS_ENTRY_SIZE
+    add hl, bc
+    pop de
+    jr nc, _zos_zealfs_index_create_no_carry
+    inc de
+_zos_zealfs_index_create_no_carry:
+    pop bc
+    or a
+    jr nz, _zos_zealfs_index_create_error
+    dec bc
+    ld a, b
+    or c
+    jr nz, _zos_zealfs_index_create_loop
+    ; Write the entry describing the index as the first entry of the directory
+    pop de
+    call _zealfs_clear_buffer
+    ld a, FS_OCCUPIED_MASK | FS_INDEX_MASK
+    ld (RAM_BUFFER + zealfs_entry_flags), a
+    ld (RAM_BUFFER + zealfs_entry_start), de
+    ld hl, (RAM_CUR_CONTEXT)
+    ld de, (RAM_CUR_CONTEXT + 2)
+    ld bc, ZEALFS_ENTRY_SIZE
+    jp RAM_EXE_WRITE
+_zos_zealfs_index_create_error:
+    ; Give the index page back and leave the directory without an index, the error is kept in A
+    pop de
+    push af
+    ld a, ARITH_OP
+    ld (RAM_EXE_PAGE_0), a
+    ld a, RET_OP
+    ld (RAM_EXE_PAGE_0 + 2), a
+    call zos_zealfs_free_page
+    pop af
+    ret
+_zos_zealfs_index_create_none:
+    xor a
+    ret
+
+
+    ; Free the index of a directory that is being removed, if it has any
+    ; Parameters:
+    ;   DE - First page of the directory
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+_zos_zealfs_index_remove:
+    call _zos_zealfs_phys_from_page
+    ld bc, index_cache
+    ld (DRIVER_DE_PARAM), bc
+    ld bc, zealfs_entry_start + 2
+    call RAM_EXE_READ
+    or a
+    ret nz
+    ld a, (index_cache + zealfs_entry_flags)
+    and FS_OCCUPIED_MASK | FS_INDEX_MASK
+    cp FS_OCCUPIED_MASK | FS_INDEX_MASK
+    ld a, ERR_SUCCESS
+    ret nz
+    ld de, (index_cache + zealfs_entry_start)
+    jp zos_zealfs_free_page
+
+    ENDIF ; CONFIG_KERNEL_ZEALFS_DIR_INDEX
+
+
     ; ZealFS function called to initialize the functions in RAM
 zos_zealfs_init:
     ld hl, zos_zealfs_trampoline_start
@@ -2457,6 +3602,28 @@ zos_zealfs_prepare_header:
     jp RAM_EXE_READ
 
 
+    IF CONFIG_KERNEL_ZEALFS_FIXED_PAGE_SIZE
+    ; Make sure the disk uses the page size the driver was built for
+    ; Parameters:
+    ;   [RAM_FS_HEADER] - Filled with FS header
+    ; Returns:
+    ;   A - ERR_SUCCESS if the page size matches, ERR_INVALID_FILESYSTEM else
+    ;   B / Z flag - Z flag set on success, B is not 0 and Z flag is not set on error
+    ; Alters:
+    ;   A, B
+zos_zealfs_check_page_size:
+    ld a, (RAM_FS_HEADER + zealfs_page_size_t - zealfs_bitmap_size_t)
+    cp ZEALFS_PAGE_SIZE_CODE
+    ; Do not alter the flags
+    ld a, ERR_SUCCESS
+    ret z
+    ld a, ERR_INVALID_FILESYSTEM
+    ld b, a
+    or a
+    ret
+    ENDIF
+
+
     ; Allocate a page in the bitmap. The bitmap will be altered as the free page (bit 0)
     ; will be marked as allocated (bit 1)
     ; Parameters:
@@ -2512,4 +3679,16 @@ _allocate_page_bit_found:
 read_trampoline:    DEFS zos_zealfs_trampoline_end - zos_zealfs_trampoline_start
 read_trampoline_end:
 write_trampoline:   DEFS zos_zealfs_trampoline_end - zos_zealfs_trampoline_start
-write_trampoline_end:
\ No newline at end of file
+write_trampoline_end:
+    IF CONFIG_KERNEL_ZEALFS_DIR_INDEX
+index_page:  DEFS 2  ; Index of the directory being browsed, 0 if it has none
+index_slot:  DEFS 2  ; Slot of the next entry to browse in that directory
+index_free:  DEFS 2  ; Slot of the free entry saved in RAM_FREE_ENTRY
+index_dir:   DEFS 4  ; Physical address of the index entry of the directory being browsed
+index_stale: DEFS 2  ; Index found out of date during the last lookup, 0 if none
+index_stale_dir: DEFS 4  ; Physical address of the index entry of that directory
+index_base:  DEFS 2  ; First slot in the cache, 0xffff if the cache is empty
+index_hash:  DEFS 1  ; Hash of the name being looked for
+index_byte:  DEFS 1  ; Byte to write to the index
+index_cache: DEFS ZEALFS_INDEX_CACHE_SIZE
+    ENDIF
\ No newline at end of file
@@ -0,0 +1,574 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+        INCLUDE "osconfig.asm"
+        INCLUDE "errors_h.asm"
+        INCLUDE "mmu_h.asm"
+        INCLUDE "utils_h.asm"
+        INCLUDE "time_h.asm"
+        INCLUDE "jobs_h.asm"
+
+        EXTERN zos_loader_exec_job
+        EXTERN zos_loader_free_job_pages
+        EXTERN zos_sys_remap_de_page_2
+        EXTERN _allocate_pages
+        EXTERN _zos_user_a
+
+        ; Size of the syscall context saved for each job: user A, user pages 1 to 3 and user SP.
+        ; These are contiguous in the syscall dispatcher (check syscalls.asm)
+        DEFC JOB_USER_SIZE = 6
+        DEFC JOB_PAGES_SIZE = 3
+
+        ; Jobs are scheduled cooperatively: a job keeps the CPU until it performs a syscall that
+        ; would block (keyboard or UART read, msleep) or until it explicitly yields. Each job has
+        ; its own kernel stack, switching from one job to another is done by saving the registers
+        ; and the mapped pages on the current job's kernel stack and restoring the ones of the
+        ; next job. As switching only occurs during a syscall, page 3 always contains the kernel RAM.
+
+        SECTION KERNEL_TEXT
+
+        ; Initialize the jobs, the program loaded at boot becomes the foreground job.
+        ; Called at system startup, BSS is cleaned when called.
+        ; Parameters:
+        ;   None
+        ; Returns:
+        ;   None
+        ; Alters:
+        ;   A, DE, HL
+        PUBLIC zos_job_init
+zos_job_init:
+        ld a, JOB_READY
+        ld (_zos_jobs + job_state_t), a
+        ld hl, CONFIG_KERNEL_STACK_ADDR
+        ld (_zos_job_kstack), hl
+        ; Start accounting the CPU time now, if a timer is available
+        ld h, 0
+        call zos_time_gettime
+        or a
+        ret nz
+        ld (_zos_job_slice_start), de
+        ret
+
+
+        ; Give the CPU to the next ready job, if any. The current job will be resumed, with all its
+        ; registers and the mapping of pages 1 and 2 restored, the next time it is scheduled.
+        ; Must only be called from a syscall.
+        ; Parameters:
+        ;   None
+        ; Returns:
+        ;   None
+        ; Alters:
+        ;   None
+        PUBLIC zos_job_yield
+zos_job_yield:
+        push af
+        push bc
+        push de
+        push hl
+        push ix
+        push iy
+        call _zos_job_next
+        jp nc, _zos_job_pop_registers
+        jr _zos_job_switch
+
+        ; Same as above, but switch to the job given as a parameter.
+        ; Parameters:
+        ;   A - Job to switch to, must be ready
+_zos_job_switch_to:
+        push af
+        push bc
+        push de
+        push hl
+        push ix
+        push iy
+_zos_job_switch:
+        ; Save the mapping of pages 1 and 2 on the stack, they may have been remapped by the
+        ; syscall (user buffer in page 3 for example)
+        ld c, a
+        MMU_GET_PAGE_NUMBER(MMU_PAGE_1)
+        ld h, a
+        MMU_GET_PAGE_NUMBER(MMU_PAGE_2)
+        ld l, a
+        push hl
+        call _zos_job_save
+        ld a, c
+        jp _zos_job_resume
+
+
+        ; Save the context of the current job: its kernel stack pointer, the syscall context and the
+        ; program pages. Account the CPU time of the current slice.
+        ; Parameters:
+        ;   None
+        ; Returns:
+        ;   None
+        ; Alters:
+        ;   A, DE, HL, IX
+_zos_job_save:
+        ld a, (_zos_job_current)
+        call _zos_job_entry
+        ; When the job is resumed, the stack must point right after the return address of this routine
+        ld hl, 2
+        add hl, sp
+        ld (ix + job_ksp_t), l
+        ld (ix + job_ksp_t + 1), h
+        push bc
+        push ix
+        pop hl
+        ld de, job_user_t
+        add hl, de
+        ex de, hl
+        ld hl, _zos_user_a
+        ld bc, JOB_USER_SIZE
+        ldir
+        ; DE points to job_pages_t
+        ASSERT(job_pages_t == job_user_t + JOB_USER_SIZE)
+        ld hl, _allocate_pages
+        ld c, JOB_PAGES_SIZE
+        ldir
+        pop bc
+        ; Fall-through
+
+
+        ; Add the time elapsed since the beginning of the current slice to the CPU time of the job
+        ; Parameters:
+        ;   IX - Job entry
+        ; Returns:
+        ;   None
+        ; Alters:
+        ;   A, DE, HL
+_zos_job_account:
+        push bc
+        push ix
+        ld h, 0
+        call zos_time_gettime
+        pop ix
+        pop bc
+        or a
+        ret nz
+        ; DE contains the current time, compute the elapsed time in HL
+        ld hl, (_zos_job_slice_start)
+        ld (_zos_job_slice_start), de
+        ex de, hl
+        or a
+        sbc hl, de
+        ld a, (ix + job_cpu_t)
+        add l
+        ld (ix + job_cpu_t), a
+        ld a, (ix + job_cpu_t + 1)
+        adc h
+        ld (ix + job_cpu_t + 1), a
+        ret nc
+        inc (ix + job_cpu_t + 2)
+        ret nz
+        inc (ix + job_cpu_t + 3)
+        ret
+
+
+        ; Resume the given job. If the job hasn't started yet, its program is loaded.
+        ; This routine doesn't return to the caller.
+        ; Parameters:
+        ;   A - Job to resume
+_zos_job_resume:
+        ld (_zos_job_current), a
+        call _zos_job_entry
+        ; The foreground job uses the original kernel stack, the others use their own stack
+        ld hl, CONFIG_KERNEL_STACK_ADDR
+        or a
+        jr z, _zos_job_resume_stack
+        ld hl, _zos_job_stacks
+        ld de, CONFIG_KERNEL_JOB_STACK_SIZE
+        ld b, a
+_zos_job_resume_stack_loop:
+        add hl, de
+        djnz _zos_job_resume_stack_loop
+_zos_job_resume_stack:
+        ld (_zos_job_kstack), hl
+        ; Restore the syscall context and the program pages of the job
+        push ix
+        pop hl
+        ld de, job_user_t
+        add hl, de
+        ld de, _zos_user_a
+        ld bc, JOB_USER_SIZE
+        ldir
+        ld de, _allocate_pages
+        ld c, JOB_PAGES_SIZE
+        ldir
+        ; Count the new slice
+        ld l, (ix + job_slices_t)
+        ld h, (ix + job_slices_t + 1)
+        inc hl
+        ld (ix + job_slices_t), l
+        ld (ix + job_slices_t + 1), h
+        ; A job that hasn't started yet doesn't have any saved stack
+        ld l, (ix + job_ksp_t)
+        ld h, (ix + job_ksp_t + 1)
+        ld a, h
+        or l
+        jr z, _zos_job_start
+        ld sp, hl
+        pop hl
+        ld a, h
+        MMU_SET_PAGE_NUMBER(MMU_PAGE_1)
+        ld a, l
+        MMU_SET_PAGE_NUMBER(MMU_PAGE_2)
+_zos_job_pop_registers:
+        pop iy
+        pop ix
+        pop hl
+        pop de
+        pop bc
+        pop af
+        ret
+
+
+        ; Start the program of a new job, on its own kernel stack.
+        ; The pages 1 and 2 still map the parent's ones, so the path and the parameter are reachable.
+        ; Parameters:
+        ;   IX - Entry of the job to start
+_zos_job_start:
+        ld sp, (_zos_job_kstack)
+        ; The loader doesn't return on success, mark the exec as successful for the parent now
+        ld a, (ix + job_parent_t)
+        push ix
+        call _zos_job_entry
+        ld (ix + job_spawn_t), ERR_SUCCESS
+        pop ix
+        ld c, (ix + job_path_t)
+        ld b, (ix + job_path_t + 1)
+        ld e, (ix + job_param_t)
+        ld d, (ix + job_param_t + 1)
+        call zos_loader_exec_job
+        ; An error occurred, report it to the parent and release the job
+        ld e, a
+        ld a, (_zos_job_current)
+        call _zos_job_entry
+        ld a, (ix + job_parent_t)
+        push af
+        call _zos_job_entry
+        ld (ix + job_spawn_t), e
+        ld a, (_zos_job_current)
+        call _zos_job_release
+        ; Resume the parent directly, it is still ready
+        pop af
+        jp _zos_job_resume
+
+
+        ; Release a background job: free its pages and its entry
+        ; Parameters:
+        ;   A - Job to release, must not be the foreground one
+        ; Returns:
+        ;   None
+        ; Alters:
+        ;   A, BC, DE, HL, IX
+_zos_job_release:
+        call _zos_job_entry
+        ld (ix + job_state_t), JOB_FREE
+        jp zos_loader_free_job_pages
+
+
+        ; Look for the next job to run, in a round-robin fashion
+        ; Parameters:
+        ;   None
+        ; Returns:
+        ;   A - Index of the next job to run
+        ;   Carry - Set if a job other than the current one is ready
+        ; Alters:
+        ;   A, BC, IX
+_zos_job_next:
+        ld a, (_zos_job_current)
+        ld b, CONFIG_KERNEL_MAX_JOBS - 1
+_zos_job_next_loop:
+        inc a
+        cp CONFIG_KERNEL_MAX_JOBS
+        jr c, _zos_job_next_check
+        xor a
+_zos_job_next_check:
+        call _zos_job_entry
+        ld c, (ix + job_state_t)
+        dec c
+        ASSERT(JOB_READY == 1)
+        jr z, _zos_job_next_found
+        djnz _zos_job_next_loop
+        ; No other job is ready, clear the carry
+        or a
+        ret
+_zos_job_next_found:
+        scf
+        ret
+
+
+        ; Get the entry of a job
+        ; Parameters:
+        ;   A - Index of the job
+        ; Returns:
+        ;   IX - Address of the job entry
+        ; Alters:
+        ;   IX
+_zos_job_entry:
+        push bc
+        push de
+        ld ix, _zos_jobs
+        ld de, JOB_ENTRY_SIZE
+        ld b, a
+        inc b
+        jr _zos_job_entry_next
+_zos_job_entry_loop:
+        add ix, de
+_zos_job_entry_next:
+        djnz _zos_job_entry_loop
+        pop de
+        pop bc
+        ret
+
+
+        ; Load and execute a program in a new background job. The new job runs first, the caller is
+        ; resumed as soon as the new program yields, or if it couldn't be loaded.
+        ; Parameters:
+        ;   BC - File to load and execute, already remapped
+        ;   DE - String parameter, can be NULL
+        ; Returns:
+        ;   A - ERR_SUCCESS on success
+        ;       ERR_CANNOT_REGISTER_MORE if the maximum amount of jobs is reached
+        ;       error code else
+        ;   D - Index of the new job on success
+        ; Alters:
+        ;   A, DE, HL
+        PUBLIC zos_job_spawn
+zos_job_spawn:
+        push bc
+        push ix
+        ; Look for a free entry, the foreground one is never free
+        ld a, JOB_FOREGROUND
+_zos_job_spawn_find:
+        inc a
+        cp CONFIG_KERNEL_MAX_JOBS
+        jr z, _zos_job_spawn_full
+        call _zos_job_entry
+        ld l, (ix + job_state_t)
+        dec l
+        jr z, _zos_job_spawn_find
+        ; Entry found, clear it
+        push af
+        push bc
+        push ix
+        pop hl
+        ld (hl), JOB_READY
+        inc hl
+        ld b, JOB_ENTRY_SIZE - 1
+_zos_job_spawn_clear:
+        ld (hl), 0
+        inc hl
+        djnz _zos_job_spawn_clear
+        pop bc
+        ; The parameter is needed for the name, remap it now, the loader will not remap it again
+        call zos_sys_remap_de_page_2
+        ld (ix + job_path_t), c
+        ld (ix + job_path_t + 1), b
+        ld (ix + job_param_t), e
+        ld (ix + job_param_t + 1), d
+        ld a, (_zos_job_current)
+        ld (ix + job_parent_t), a
+        ; The new job inherits the syscall context of its parent until its program is loaded
+        push bc
+        push ix
+        pop hl
+        ld de, job_user_t
+        add hl, de
+        ex de, hl
+        ld hl, _zos_user_a
+        ld bc, JOB_USER_SIZE
+        ldir
+        pop bc
+        ; Name the job after its parameter, or after its path if it doesn't have any
+        push ix
+        pop hl
+        ld de, job_name_t
+        add hl, de
+        ex de, hl
+        ld l, (ix + job_param_t)
+        ld h, (ix + job_param_t + 1)
+        ld a, h
+        or l
+        jr nz, _zos_job_spawn_name
+        ld h, b
+        ld l, c
+_zos_job_spawn_name:
+        ld b, JOB_NAME_LEN - 1
+_zos_job_spawn_name_loop:
+        ld a, (hl)
+        or a
+        jr z, _zos_job_spawn_switch
+        ld (de), a
+        inc hl
+        inc de
+        djnz _zos_job_spawn_name_loop
+_zos_job_spawn_switch:
+        ; Switch to the new job, we will be resumed once it yields or fails to load
+        pop af
+        push af
+        call _zos_job_switch_to
+        ld a, (_zos_job_current)
+        call _zos_job_entry
+        pop de
+        ld a, (ix + job_spawn_t)
+        pop ix
+        pop bc
+        ret
+_zos_job_spawn_full:
+        ld a, ERR_CANNOT_REGISTER_MORE
+        pop ix
+        pop bc
+        ret
+
+
+        ; Exit the current background job, free its pages and switch to the next job.
+        ; The return code is discarded.
+        ; Parameters:
+        ;   H - Return code
+        ; Returns:
+        ;   Doesn't return
+        PUBLIC zos_job_exit
+zos_job_exit:
+        ; Account the CPU time of the job, this also starts the slice of the next job
+        ld a, (_zos_job_current)
+        call _zos_job_entry
+        call _zos_job_account
+        ld a, (_zos_job_current)
+        call _zos_job_release
+        ; The foreground job is always ready, so there is always a job to switch to
+        call _zos_job_next
+        jp _zos_job_resume
+
+
+        ; Sleep for a given amount of time, in milliseconds, while letting the other jobs run.
+        ; When no other job is ready, the regular sleep routine is used.
+        ; Parameters:
+        ;   DE - 16-bit duration (maximum 65 seconds)
+        ; Returns:
+        ;   A - ERR_SUCCESS on success, error code else
+        ; Alters:
+        ;   A, HL
+        PUBLIC zos_job_msleep
+zos_job_msleep:
+        push ix
+        push bc
+        push de
+        call _zos_job_next
+        jr nc, _zos_job_msleep_alone
+        ; Keep the duration in BC
+        pop bc
+        push bc
+        ld a, b
+        or c
+        jr z, _zos_job_msleep_end
+        ld h, 0
+        call zos_time_gettime
+        or a
+        jr nz, _zos_job_msleep_no_timer
+        ; Keep the start time on the stack
+        push de
+_zos_job_msleep_loop:
+        call zos_job_yield
+        ld h, 0
+        call zos_time_gettime
+        pop hl
+        push hl
+        ; Compute the elapsed time and compare it to the duration
+        ex de, hl
+        or a
+        sbc hl, de
+        or a
+        sbc hl, bc
+        jr c, _zos_job_msleep_loop
+        pop hl
+        jr _zos_job_msleep_end
+_zos_job_msleep_no_timer:
+        ; Without any timer, sleep 1ms at a time and let the other jobs run in between
+        ld de, 1
+_zos_job_msleep_no_timer_loop:
+        call zos_time_msleep
+        call zos_job_yield
+        dec bc
+        ld a, b
+        or c
+        jr nz, _zos_job_msleep_no_timer_loop
+_zos_job_msleep_end:
+        pop de
+        pop bc
+        pop ix
+        xor a
+        ret
+_zos_job_msleep_alone:
+        pop de
+        pop bc
+        pop ix
+        jp zos_time_msleep
+
+
+        ; Yield syscall, give the CPU to the next ready job, if any.
+        ; Parameters:
+        ;   None
+        ; Returns:
+        ;   A - ERR_SUCCESS
+        PUBLIC zos_job_sys_yield
+zos_job_sys_yield:
+        call zos_job_yield
+        xor a
+        ret
+
+
+        ; Get the statistics of a job: its state, number of slices, CPU time and name.
+        ; Parameters:
+        ;   H - Index of the job
+        ;   DE - Buffer to fill, must be at least JOB_STAT_SIZE bytes big
+        ; Returns:
+        ;   A - ERR_SUCCESS on success
+        ;       ERR_INVALID_PARAMETER if the index is not valid
+        ;       ERR_NO_SUCH_ENTRY if the job doesn't exist
+        ; Alters:
+        ;   A, HL
+        PUBLIC zos_job_stat
+zos_job_stat:
+        ld a, h
+        cp CONFIG_KERNEL_MAX_JOBS
+        jr nc, _zos_job_stat_invalid
+        push bc
+        push de
+        push ix
+        call zos_sys_remap_de_page_2
+        ld a, h
+        call _zos_job_entry
+        ld a, (ix + job_state_t)
+        ASSERT(JOB_FREE == 0)
+        or a
+        ld a, ERR_NO_SUCH_ENTRY
+        jr z, _zos_job_stat_end
+        push ix
+        pop hl
+        ld bc, JOB_STAT_SIZE
+        ldir
+        xor a
+_zos_job_stat_end:
+        pop ix
+        pop de
+        pop bc
+        ret
+_zos_job_stat_invalid:
+        ld a, ERR_INVALID_PARAMETER
+        ret
+
+
+        SECTION KERNEL_BSS
+        ; Index of the job currently running
+        PUBLIC _zos_job_current
+_zos_job_current: DEFS 1
+        ; Top of the kernel stack of the current job, used by the syscall dispatcher
+        PUBLIC _zos_job_kstack
+_zos_job_kstack: DEFS 2
+        ; Timestamp, in milliseconds, of the beginning of the current slice
+_zos_job_slice_start: DEFS 2
+_zos_jobs: DEFS CONFIG_KERNEL_MAX_JOBS * JOB_ENTRY_SIZE
+        ; Kernel stacks of the background jobs, the foreground job uses the original kernel stack
+_zos_job_stacks: DEFS (CONFIG_KERNEL_MAX_JOBS - 1) * CONFIG_KERNEL_JOB_STACK_SIZE
@@ -10,9 +10,14 @@
         INCLUDE "vfs_h.asm"
         INCLUDE "log_h.asm"
         INCLUDE "target_h.asm"
+        INCLUDE "jobs_h.asm"
 
         EXTERN zos_vfs_open_internal
         EXTERN zos_vfs_read_internal
+    IF CONFIG_KERNEL_SWAP
+        EXTERN zos_vfs_write_internal
+        EXTERN _vfs_work_buffer
+    ENDIF
         EXTERN zos_vfs_dstat_internal
         EXTERN zos_sys_remap_bc_page_2
         EXTERN zos_sys_remap_de_page_2
@@ -27,10 +32,17 @@
         DEFC LOADER_KEEP_PROGRAM_IN_MEM  = 1
         DEFC LOADER_BIN_MAX_SIZE         = 0xC000 ; (48KB)
 
+    IF CONFIG_KERNEL_JOBS
+        ; The background jobs own their pages too, their owner value comes after the nested programs ones
+        MACRO CURRENT_OWNER _
+            call _zos_current_owner
+        ENDM
+    ELSE
         MACRO CURRENT_OWNER _
             ld a, (_stack_entries)
             inc a
         ENDM
+    ENDIF
 
         SECTION KERNEL_TEXT
 
@@ -206,6 +218,10 @@ _zos_load_file_loop:
         djnz _zos_load_file_loop
         ; The program is ready, close the file as we don't need it anymore
         call zos_vfs_close
+    IF CONFIG_KERNEL_SWAP_EAGER
+        ; The suspended programs won't run before this one exits, give their pages back
+        call zos_swap_out_all
+    ENDIF
         ; Get the parameters out of the stack before mapping the user program stack
         ld hl, (_file_stats)
         ld sp, hl
@@ -243,13 +259,29 @@ _zos_load_failed_h_dev:
         ;       H  - Save the current program in RAM
         ;            0: Do not save, override the current program
         ;            1: Save the current program
+        ;            2: Execute the program in a new background job (CONFIG_KERNEL_JOBS)
         ; Returns:
         ;       A - Nothing on success, the new program is executed.
         ;           ERR_FAILURE on failure.
+        ;       D - Index of the new job when H is 2
         ; Alters:
         ;       HL
         PUBLIC zos_loader_exec
 zos_loader_exec:
+    IF CONFIG_KERNEL_JOBS
+        call zos_sys_remap_bc_page_2
+        ld a, h
+        cp LOADER_BACKGROUND_PROGRAM
+        jp z, zos_job_spawn
+        ; Background jobs cannot keep a program in memory, they don't have a programs stack
+        dec a
+        jr nz, zos_loader_exec_fg
+        ld a, (_zos_job_current)
+        or a
+        ld a, ERR_NOT_SUPPORTED
+        ret nz
+zos_loader_exec_fg:
+    ENDIF
         push bc
         push de
         call zos_sys_remap_bc_page_2
@@ -339,6 +371,12 @@ zos_loader_exit:
     IF CONFIG_KERNEL_EXIT_HOOK
         ; target_exit must not alter H (return code)
         call target_exit
+    ENDIF
+    IF CONFIG_KERNEL_JOBS
+        ; Background jobs are not part of the programs stack
+        ld a, (_zos_job_current)
+        or a
+        jp nz, zos_job_exit
     ENDIF
         ; If the first program is exiting, reset the VFS and re-launch the init program
         ld a, (_stack_entries)
@@ -351,6 +389,12 @@ zos_loader_exit:
         ; Not exiting from the init program, pop the previous program
         call zos_loader_free_user_pages
         ; TODO: check the errors Should not occur, should be a dynamic assert
+    IF CONFIG_KERNEL_SWAP
+        ; The previous program may have been swapped out, its index is the number of entries left
+        ld a, (_stack_entries)
+        call zos_swap_in
+        jr nz, zos_loader_exit_swap_error
+    ENDIF
         ; Copy pages from _allocate_pages and user stack pointer into the syscall dispatcher
         ; HL points to the entry we just popped (previous program to load), copy it raw to _zos_user_page_1
         ; _zos_user_page_1 must be followed by _zos_user_page_2, _zos_user_page_3 AND _zos_user_sp!
@@ -367,6 +411,18 @@ zos_loader_exit_from_first:
         ; Load the init file name again
         ld hl, _zos_default_init
         jp zos_load_file
+    IF CONFIG_KERNEL_SWAP
+zos_loader_exit_swap_error:
+        ; The previous program cannot be resumed, make it exit too, with the error as the return code
+        pop hl
+        ld h, a
+        push hl
+        ld hl, _zos_swap_error
+        call zos_log_error
+        pop hl
+        jp zos_loader_exit
+_zos_swap_error: DEFM "Could not swap in the previous program\n", 0
+    ENDIF
 
 
         ; Push the current pages to the stack and allocate new pages to _allocate_pages
@@ -390,8 +446,12 @@ zos_loader_allocate_user_pages:
         ; Update the current owner to simplify the code in `zos_load_allocate_page_to_de`
         inc (hl)
         ; Driectly allocate in `_allocate_pages` since we will use `_zos_user_page_1` to backup the current pages
+    IF CONFIG_KERNEL_SWAP
+        call _zos_loader_allocate_swap
+    ELSE
         ld de, _allocate_pages
         call zos_load_allocate_page_to_de
+    ENDIF
         jr nz, zos_loader_allocate_user_pages_err
         ; Copy the current pages to the stack_head
         ld de, _zos_user_page_1
@@ -442,8 +502,28 @@ zos_loader_free_user_pages:
         inc a
         ; Decrement owner
         dec (hl)
-        ; Free the current user program's pages, browse the whole page owner array
-        ; and look for all the apges allocated to the program
+        call _zos_free_owner_pages
+        ; Pages have been freed and marked as not owned.
+        ; Pop the current entry from the stack
+        ld hl, (_stack_head)
+        ld bc, -KERNEL_STACK_ENTRY_SIZE
+        add hl, bc
+        ; HL points to the previous entry's SPh, increment it to make it point to
+        ; the value we just popped
+        ld (_stack_head), hl
+        ; Success
+        xor a
+        ret
+
+        ; Free the pages that belong to the given owner: browse the whole page owner array
+        ; and look for all the pages allocated to it
+        ; Parameters:
+        ;   A - Owner
+        ; Returns:
+        ;   None
+        ; Alters:
+        ;   BC, HL
+_zos_free_owner_pages:
         ld b, MMU_RAM_PHYS_PAGES
         ld c, MMU_RAM_PHYS_START_IDX
         ld hl, _page_owners
@@ -453,18 +533,306 @@ _free_pages_loop:
         inc c
         inc hl
         djnz _free_pages_loop
-        ; Pages have been freed and marked as not owned.
-        ; Pop the current entry from the stack
-        ld hl, (_stack_head)
-        ld bc, -KERNEL_STACK_ENTRY_SIZE
+        ret
+
+
+    IF CONFIG_KERNEL_JOBS
+
+        ; Get the owner of the pages allocated by the current program
+        ; Parameters:
+        ;   None
+        ; Returns:
+        ;   A - Current owner
+        ; Alters:
+        ;   A
+_zos_current_owner:
+        ld a, (_zos_job_current)
+        or a
+        jr nz, _zos_current_owner_job
+        ld a, (_stack_entries)
+        inc a
+        ret
+_zos_current_owner_job:
+        add CONFIG_KERNEL_MAX_NESTED_PROGRAMS
+        ret
+
+
+        ; Free all the pages owned by the given background job
+        ; Parameters:
+        ;   A - Index of the job
+        ; Returns:
+        ;   None
+        ; Alters:
+        ;   A, BC, HL
+        PUBLIC zos_loader_free_job_pages
+zos_loader_free_job_pages:
+        add CONFIG_KERNEL_MAX_NESTED_PROGRAMS
+        jr _zos_free_owner_pages
+
+
+        ; Load and execute a program in the current background job, which doesn't have any page yet.
+        ; Parameters:
+        ;   BC - File to load and execute, already remapped
+        ;   DE - String parameter, can be NULL
+        ; Returns:
+        ;   A - error code on failure, doesn't return on success. The pages that were
+        ;       allocated must be freed by the caller.
+        PUBLIC zos_loader_exec_job
+zos_loader_exec_job:
+        push bc
+        push de
+        ld de, _allocate_pages
+        call zos_load_allocate_page_to_de
+        pop de
+        pop bc
+        ret nz
+        jp zos_loader_exec_internal
+
+    ENDIF ; CONFIG_KERNEL_JOBS
+
+
+    IF CONFIG_KERNEL_SWAP
+
+        ; Allocate the pages of a new program in `_allocate_pages`. When the memory is full,
+        ; swap out the suspended programs, one at a time, until the allocation succeeds.
+        ; Parameters:
+        ;   None
+        ; Returns:
+        ;   A - ERR_SUCCESS on success, error code else
+        ;   Z flag - set if A is ERR_SUCCESS
+        ; Alters:
+        ;   A, BC, DE, HL
+_zos_loader_allocate_swap:
+        ld de, _allocate_pages
+        call zos_load_allocate_page_to_de
+        ret z
+        cp ERR_NO_MORE_MEMORY
+        ret nz
+        ; Give back the pages that were allocated before retrying
+        CURRENT_OWNER()
+        call _zos_free_owner_pages
+        call zos_swap_out_oldest
+        jr z, _zos_loader_allocate_swap
+        ld a, ERR_NO_MORE_MEMORY
+        ret
+
+
+        ; Swap out all the suspended programs that are still in RAM
+        ; Parameters:
+        ;   None
+        ; Returns:
+        ;   None
+        ; Alters:
+        ;   A, BC, DE, HL
+zos_swap_out_all:
+        call zos_swap_out_oldest
+        jr z, zos_swap_out_all
+        ret
+
+
+        ; Swap out the suspended program that will be resumed last among the ones still in RAM,
+        ; in other words, the closest one to the bottom of the programs stack.
+        ; Only the KERNEL_PAGES_PER_PROGRAM pages the program was loaded in are swapped out, the
+        ; pages it allocated with `palloc` stay in RAM as the program knows their physical index.
+        ; Parameters:
+        ;   None
+        ; Returns:
+        ;   A - ERR_SUCCESS on success,
+        ;       ERR_NO_MORE_MEMORY if all the suspended programs are already swapped out,
+        ;       error code else
+        ;   Z flag - set if A is ERR_SUCCESS
+        ; Alters:
+        ;   A, BC, DE, HL
+zos_swap_out_oldest:
+        ld hl, _stack_user_pages
+        ld e, 0
+_zos_swap_out_oldest_loop:
+        ; Stop at the head of the stack
+        push hl
+        ld bc, (_stack_head)
+        or a
+        sbc hl, bc
+        pop hl
+        jr nc, _zos_swap_out_oldest_none
+        ; The first page of a swapped out entry is 0
+        ld a, (hl)
+        or a
+        jr nz, _zos_swap_out_oldest_found
+        ld bc, KERNEL_STACK_ENTRY_SIZE
         add hl, bc
-        ; HL points to the previous entry's SPh, increment it to make it point to
-        ; the value we just popped
-        ld (_stack_head), hl
-        ; Success
+        inc e
+        jr _zos_swap_out_oldest_loop
+_zos_swap_out_oldest_none:
+        ld a, ERR_NO_MORE_MEMORY
+        or a
+        ret
+_zos_swap_out_oldest_found:
+        ; HL points to the entry, E contains its index
+        push hl
+        ld d, O_WRONLY | O_CREAT | O_TRUNC
+        ld bc, zos_vfs_write_internal
+        call _zos_swap_transfer
+        pop hl
+        ret nz
+        ; The pages are on the disk, free them and mark the entry as swapped out
+        ASSERT(MMU_RAM_PHYS_START_IDX != 0)
+        ld b, KERNEL_PAGES_PER_PROGRAM
+_zos_swap_out_free_loop:
+        ld c, (hl)
+        ld (hl), 0
+        push hl
+        push bc
+        ld b, c
+        call _zos_page_owner_addr
+        pop bc
+        call free_page_c
+        pop hl
+        inc hl
+        djnz _zos_swap_out_free_loop
+        ld hl, (_swap_outs)
+        inc hl
+        ld (_swap_outs), hl
         xor a
         ret
 
+
+        ; Bring back in RAM the pages of a programs stack entry if it was swapped out.
+        ; The new pages belong to the current owner.
+        ; Parameters:
+        ;   HL - Programs stack entry
+        ;   A  - Index of the entry
+        ; Returns:
+        ;   A - ERR_SUCCESS on success, error code else
+        ;   Z flag - set if A is ERR_SUCCESS
+        ; Alters:
+        ;   A, BC, DE
+zos_swap_in:
+        ld c, a
+        ld a, (hl)
+        or a
+        jr z, _zos_swap_in_swapped
+        xor a
+        ret
+_zos_swap_in_swapped:
+        push hl
+        push bc
+        ld d, h
+        ld e, l
+        call zos_load_allocate_page_to_de
+        pop de
+        pop hl
+        ret nz
+        ; E contains the index of the entry
+        push hl
+        ld d, O_RDONLY
+        ld bc, zos_vfs_read_internal
+        call _zos_swap_transfer
+        pop hl
+        ret nz
+        ld bc, (_swap_ins)
+        inc bc
+        ld (_swap_ins), bc
+        ret
+
+
+        ; Read or write the pages of a programs stack entry from or to its swap file.
+        ; Each entry has its own file: CONFIG_KERNEL_SWAP_FILE followed by the index of the entry.
+        ; Parameters:
+        ;   HL - Programs stack entry
+        ;   D  - Flags to open the swap file with
+        ;   E  - Index of the entry
+        ;   BC - Routine to transfer a page: zos_vfs_read_internal or zos_vfs_write_internal
+        ; Returns:
+        ;   A - ERR_SUCCESS on success, error code else
+        ;   Z flag - set if A is ERR_SUCCESS
+        ; Alters:
+        ;   A, BC, DE, HL
+_zos_swap_transfer:
+        ld (_swap_routine), bc
+        push hl
+        push de
+        ; The work buffer is not used by the VFS before the path is copied
+        ld hl, _zos_swap_file
+        ld de, _vfs_work_buffer
+        ld bc, _zos_swap_file_end - _zos_swap_file
+        ldir
+        pop bc
+        ld a, c
+        add '0'
+        ld (de), a
+        inc de
+        xor a
+        ld (de), a
+        ld h, b
+        ld bc, _vfs_work_buffer
+        call zos_vfs_open_internal
+        pop hl
+        ; Descriptor in A, negated error if negative
+        or a
+        jp m, _zos_swap_transfer_open_error
+        ; Keep the descriptor and the page currently mapped in virtual page 1 on the stack
+        ld d, a
+        MMU_GET_PAGE_NUMBER(MMU_PAGE_1)
+        ld e, a
+        push de
+        ld b, KERNEL_PAGES_PER_PROGRAM
+_zos_swap_transfer_loop:
+        ld a, (hl)
+        MMU_SET_PAGE_NUMBER(MMU_PAGE_1)
+        push hl
+        push bc
+        ; Push the return address and the routine to call, `ret` will jump to it
+        ld hl, _zos_swap_transfer_ret
+        push hl
+        ld hl, (_swap_routine)
+        push hl
+        ld h, d
+        ld de, KERN_MMU_PAGE1_VIRT_ADDR
+        ld bc, KERN_MMU_VIRT_PAGES_SIZE
+        ret
+_zos_swap_transfer_ret:
+        or a
+        jr nz, _zos_swap_transfer_next
+        ; The whole page must have been transferred
+        ASSERT((KERN_MMU_VIRT_PAGES_SIZE & 0xff) == 0)
+        ld a, b
+        xor KERN_MMU_VIRT_PAGES_SIZE >> 8
+        or c
+        jr z, _zos_swap_transfer_next
+        ld a, ERR_FAILURE
+_zos_swap_transfer_next:
+        pop bc
+        pop hl
+        pop de
+        push de
+        or a
+        jr nz, _zos_swap_transfer_end
+        inc hl
+        djnz _zos_swap_transfer_loop
+_zos_swap_transfer_end:
+        ; Restore the virtual page 1 and close the file, keep the error in B
+        pop de
+        ld b, a
+        ld a, e
+        MMU_SET_PAGE_NUMBER(MMU_PAGE_1)
+        ld h, d
+        call zos_vfs_close
+        ld a, b
+        or a
+        ret
+_zos_swap_transfer_open_error:
+        neg
+        ret
+
+_zos_swap_file:
+        CONFIG_KERNEL_SWAP_FILE
+_zos_swap_file_end:
+        ; The swap file prefix has no default value, it must be chosen in the configuration
+        ASSERT(_zos_swap_file_end - _zos_swap_file > 0)
+
+    ENDIF ; CONFIG_KERNEL_SWAP
+
+
         ; Make the page C, pointed by HL, free (not owned)
         ; Parameters:
         ;   HL - Address of page C int he owner array
@@ -533,8 +901,22 @@ _zos_page_set_current_owner:
 zos_loader_palloc:
         MMU_ALLOC_PAGE()
         or a
+    IF CONFIG_KERNEL_SWAP
+        jp z, _zos_page_set_current_owner
+        ; Make room by swapping out a suspended program and try again. The caller expects
+        ; BC (apart from the returned B) and DE to be preserved across the syscall.
+        push bc
+        push de
+        call zos_swap_out_oldest
+        pop de
+        pop bc
+        jr z, zos_loader_palloc
+        ld a, ERR_NO_MORE_MEMORY
+        ret
+    ELSE
         ret nz
         jp _zos_page_set_current_owner
+    ENDIF
 
 
         ; Free a previously allocated page.
@@ -569,6 +951,7 @@ _page_owners: DEFS MMU_RAM_PHYS_PAGES
         ; Small array to store freshly allocated user pages
         ; _allocate_pages[i] represents is page i + 1
         ; (page 0 is always the kernel)
+        PUBLIC _allocate_pages
 _allocate_pages: DEFS KERNEL_PAGES_PER_PROGRAM
 
         ; Stack storing the pages allocated for the user programs that are waiting for
@@ -582,3 +965,13 @@ _stack_entries: DEFS 1
 
         ; Buffer used to get the stats of the file to load.
 _file_stats: DEFS STAT_STRUCT_SIZE
+
+    IF CONFIG_KERNEL_SWAP
+        ; Number of programs swapped out and swapped in since boot
+        PUBLIC _swap_outs
+        PUBLIC _swap_ins
+_swap_outs: DEFS 2
+_swap_ins: DEFS 2
+        ; Routine used by `_zos_swap_transfer` to read or write a page
+_swap_routine: DEFS 2
+    ENDIF
@@ -115,7 +115,7 @@ kernel_config_t:
     DEFB DISK_DEFAULT_LETTER
     DEFB CONFIG_KERNEL_MAX_LOADED_DRIVERS
     DEFB CONFIG_KERNEL_MAX_OPENED_DEVICES
-    DEFB CONFIG_KERNEL_MAX_OPENED_FILES
+    DEFB DISKS_MAX_OPENED_FILES
     DEFW CONFIG_KERNEL_PATH_MAX
     DEFW CONFIG_KERNEL_INIT_EXECUTABLE_ADDR
     DEFW _zos_default_init
@@ -2,12 +2,22 @@
 ;
 ; SPDX-License-Identifier: Apache-2.0
 
+    INCLUDE "osconfig.asm"
     INCLUDE "errors_h.asm"
+    INCLUDE "utils_h.asm"
     INCLUDE "strutils_h.asm"
 
     EXTERN _vfs_work_buffer_end
     DEFC WORK_BUFFER = _vfs_work_buffer_end - 4
 
+    ; Number of times the loops are unrolled, the memcpy and memcmp ones must be powers of 2
+    DEFC STRCMP_UNROLL = 4
+    DEFC STRCPY_UNROLL = 4
+    DEFC MEMCPY_UNROLL = 16
+    DEFC MEMCMP_UNROLL = 8
+    ; Copies smaller than this are done with LDIR
+    DEFC MEMCPY_MIN_UNROLLED = 32
+
     SECTION KERNEL_STRLIB
 
     ; Format the given string with parameters passed on the stack.
@@ -172,6 +182,7 @@ _strrtrim_end:
     ret
 
     ; Compare two NULL-terminated strings.
+    ; The loop is unrolled STRCMP_UNROLL times to save the branch back.
     ; Parameters:
     ;   HL - First NULL-terminated string address
     ;   DE - Second NULL-terminated string address
@@ -185,19 +196,21 @@ _strrtrim_end:
 strcmp:
     push hl
     push de
-    dec hl
-    dec de
 _strcmp_compare:
+    REPT STRCMP_UNROLL
+    ld a, (de)
+    cp (hl)
+    jr nz, _strcmp_diff
+    ; Both characters are identical, stop if we reached the end of the strings
+    or a
+    jr z, _strcmp_end
     inc hl
     inc de
-    ld a, (de)
+    ENDR
+    jp _strcmp_compare
+_strcmp_diff:
+    ; A still contains the character from DE
     sub (hl)
-    jr nz, _strcmp_end
-    ; Check if both strings have reached the end
-    ; If this is the case, or (hl) will reset in zero flag to be set
-    ; In that case, no need to continue, we can return, with flag Z set
-    or (hl)
-    jr nz, _strcmp_compare
 _strcmp_end:
     pop de
     pop hl
@@ -205,6 +218,7 @@ _strcmp_end:
 
 
     ; Same as strcmp, but at most BC bytes will be read.
+    ; CPI is used to compare, increment HL and decrement BC in a single instruction.
     ; Parameters:
     ;   HL - First NULL-terminated string address
     ;   DE - Second NULL-terminated string address
@@ -217,27 +231,28 @@ _strcmp_end:
     ;       A
     PUBLIC strncmp
 strncmp:
+    ld a, b
+    or c
+    ret z
     push hl
     push de
     push bc
-    dec hl
-    dec de
-    inc bc
 _strncmp_compare:
-    dec bc
-    inc hl
-    inc de
-    ld a, b
-    or c
-    jr z, _strncmp_end
     ld a, (de)
+    cpi
+    jr nz, _strncmp_diff
+    inc de
+    ; P/V flag is reset when BC reaches 0, test it before `or a` overwrites it
+    jp po, _strncmp_equal
+    or a
+    jp nz, _strncmp_compare
+_strncmp_equal:
+    xor a
+    jr _strncmp_end
+_strncmp_diff:
+    ; CPI already incremented HL, A still contains the character from DE
+    dec hl
     sub (hl)
-    jr nz, _strncmp_end
-    ; Check if both strings have reached the end
-    ; If this is the case, or (hl) will reset in zero flag to be set
-    ; In that case, no need to continue, we can return, with flag Z set
-    or (hl)
-    jr nz, _strncmp_compare
 _strncmp_end:
     pop bc
     pop de
@@ -353,32 +368,42 @@ strlen:
     PUBLIC strcpy
 strcpy:
     push hl
-    push bc
     push de
-    ld bc, 0xffff
-_strcpy_loop:
-    ld a, (hl)
-    ; Copy byte into de, even if it's null-byte
-    ldi
-    ; Test null-byte here
-    or a
-    jp nz, _strcpy_loop
+    call strcpy_unsaved
     pop de
-    pop bc
     pop hl
     ret
 
 
+    ; Same as strcpy, but HL and DE are not saved.
+    ; Parameters:
+    ;       HL - Source string address
+    ;       DE - Destination address
+    ; Returns:
+    ;       HL - Address following the source NULL-byte
+    ;       DE - Address following the destination NULL-byte
+    ; Alters
+    ;       A, HL, DE
     PUBLIC strcpy_unsaved
 strcpy_unsaved:
+    ; LDI is faster than loading and storing the byte, BC is decremented but its
+    ; value doesn't matter
+    push bc
+_strcpy_loop:
+    REPT STRCPY_UNROLL
     ld a, (hl)
-    ld (de), a
-    inc hl
-    inc de
+    ; Copy byte into de, even if it's null-byte
+    ldi
+    ; Test null-byte here
     or a
-    jp nz, strcpy_unsaved
+    jr z, _strcpy_end
+    ENDR
+    jp _strcpy_loop
+_strcpy_end:
+    pop bc
     ret
 
+
     ; Same as strcpy but if the source address is smaller than the given size,
     ; the destination buffer will be filled with NULL (\0) byte.
     ; Parameters:
@@ -398,32 +423,31 @@ strncpy:
     push de
     push bc
 _strncpy_loop:
+    REPT STRCPY_UNROLL
     ; Read the src byte, to check null-byte
     ld a, (hl)
-    ; We cannot use ldir here as we need to check the null-byte in src
+    ; We cannot use ldir here as we need to check the null-byte in src.
+    ; P/V flag is reset by LDI when BC reaches 0.
     ldi
+    jp po, _strncpy_end
     or a
-    jp z, _strncpy_zero
-    ld a, b
-    or c
-    jp nz, _strncpy_loop
+    jr z, _strncpy_zero
+    ENDR
+    jp _strncpy_loop
 _strncpy_end:
     pop bc
     pop de
     pop hl
     ret
 _strncpy_zero:
-    ; Here too, we have to test whether BC is 0 or not
-    ld a, b
-    or c
-    jp z, _strncpy_end
-    ; 0 has just been copied to dst (DE), we can reuse this null byte to fill
-    ; the end of the buffer using LDIR
-    ld hl, de
+    ; 0 has just been copied to dst (DE), BC is not 0, we can reuse this null byte
+    ; to fill the end of the buffer
+    ld h, d
+    ld l, e
     ; Make hl point to the null-byte we just copied
     dec hl
     ; Perform the copy
-    ldir
+    call memcpy
     jp _strncpy_end
 
 
@@ -444,11 +468,9 @@ strncat:
     push bc
     xor a
     cpir
-    ; Test is BC is 0!
-    ld a, b
-    or c
+    ; Test is BC is 0, CPIR resets P/V flag in that case
     ld a, 1 ; In case of an error
-    jp z, _strncat_src_null
+    jp po, _strncat_src_null
     ; HL points to the address past the NULL-byte.
     ; Similarly, BC has counted the NULL-byte
     dec hl
@@ -456,23 +478,25 @@ strncat:
     ; We should now copy bytes until BC is 0 or [DE] is 0
     ex de, hl
 _strncat_copy:
-    xor a
-    or (hl)
+    ld a, (hl)
     ldi
-    jp z, _strncat_pop_de
-    ; Check if BC is 0
-    ld a, b
-    or c
+    ; Check if BC is 0 before `or a` overwrites P/V flag
+    jp po, _strncat_full
+    or a
     jp nz, _strncat_copy
-    ; BC is 0, terminate dst and return
+    ; We've met a null byte in src, which was copied successfully, A is 0
+    jr _strncat_pop_de
+_strncat_full:
+    ; BC is 0, success if the last byte copied was the null byte
+    or a
+    jr z, _strncat_pop_de
+    ; Terminate dst and return A > 0
+    xor a
     ld (de), a
-    ; We have to return A > 0 so increment
     inc a
 _strncat_pop_de:
     pop de
 _strncat_src_null:
-    ; We've met a null pointer in src, which was copied successfully
-    ; A is already 0, we can return
     pop bc
     pop hl
     ret
@@ -521,10 +545,14 @@ _strtoupper_end:
 
 
     ; Initialize the memory pointed by HL with the byte given in E.
+    ; The first byte is written, then propagated to the rest of the memory with memcpy.
     ; Parameters:
     ;       HL - Memory address to initialize
     ;       BC - Size of the memory to initialize
     ;       E  - Byte to initialize the memory with
+    ; Alters:
+    ;       A
+    PUBLIC memset
 memset:
     ; Test that BC is not null
     ld a, b
@@ -534,22 +562,128 @@ memset:
     push hl
     push de
     push bc
-    ; Put the character to fill the memory with in A and load HL with it
-    ld a, e
-    ld (hl), a
-    ; As we just filled the buffer with a byte, we have to decrement BC and
-    ; check once again whether it is null or not
+    ld (hl), e
+    ; As we just filled the buffer with a byte, we have one less byte to copy
     dec bc
-    ld a, b
-    or c
-    jp z, _memset_end
     ; DE (destination) must point to the address following HL
     ld d, h
     ld e, l
     inc de
-    ; Start the copy
+    call memcpy
+    pop bc
+    pop de
+    pop hl
+    ret
+
+
+    ; Copy BC bytes from HL to DE, the result is the same as LDIR, including when the
+    ; destination overlaps the end of the source.
+    ; Small copies are performed with LDIR, bigger ones jump inside a sequence of
+    ; MEMCPY_UNROLL LDI instructions (16 T-states per byte instead of 21).
+    ; On the eZ80, LDIR doesn't fetch its opcode again for each byte, it is always faster
+    ; than the LDI sequence.
+    ; Parameters:
+    ;       HL - Source address
+    ;       DE - Destination address
+    ;       BC - Number of bytes to copy, can be 0
+    ; Returns:
+    ;       HL - Source address + BC
+    ;       DE - Destination address + BC
+    ;       BC - 0
+    ; Alters:
+    ;       A, BC, DE, HL
+    PUBLIC memcpy
+memcpy:
+    IF CONFIG_TARGET_CPU_EZ80
+    ld a, b
+    or c
+    ret z
     ldir
- _memset_end:
+    ret
+    ELSE
+    ld a, b
+    or a
+    jr nz, _memcpy_unrolled
+    or c
+    ret z
+    ; The cost of the jump inside the sequence is only worth it for bigger copies
+    cp MEMCPY_MIN_UNROLLED
+    jr nc, _memcpy_unrolled
+    ldir
+    ret
+_memcpy_unrolled:
+    ; Skip the first (-BC % MEMCPY_UNROLL) LDI instructions of the sequence so that the
+    ; remaining size is a multiple of MEMCPY_UNROLL after the first pass.
+    ; Each LDI instruction is 2 bytes long.
+    ld a, c
+    neg
+    and MEMCPY_UNROLL - 1
+    add a
+    push hl
+    ld hl, _memcpy_ldi
+    ADD_HL_A()
+    ex (sp), hl
+    ret
+_memcpy_ldi:
+    REPT MEMCPY_UNROLL
+    ldi
+    ENDR
+    ; P/V flag is reset by LDI when BC reaches 0
+    jp pe, _memcpy_ldi
+    ret
+    ENDIF
+
+
+    ; Compare the first BC bytes of the memory areas pointed by HL and DE.
+    ; The comparison jumps inside a sequence of MEMCMP_UNROLL CPI steps, the same
+    ; way memcpy does.
+    ; Parameters:
+    ;       HL - First memory area address
+    ;       DE - Second memory area address
+    ;       BC - Number of bytes to compare, can be 0
+    ; Returns:
+    ;       A - 0 if both areas are identical
+    ;           > 0 if the first different byte is greater in DE
+    ;           < 0 if the first different byte is greater in HL
+    ; Alters:
+    ;       A
+    PUBLIC memcmp
+memcmp:
+    ld a, b
+    or c
+    ret z
+    push hl
+    push de
+    push bc
+    ; Skip the first (-BC % MEMCMP_UNROLL) steps of the sequence, each step is 6 bytes long
+    ld a, c
+    neg
+    and MEMCMP_UNROLL - 1
+    push hl
+    add a
+    ld l, a
+    add a
+    add l
+    ld hl, _memcmp_steps
+    ADD_HL_A()
+    ex (sp), hl
+    ret
+_memcmp_steps:
+    REPT MEMCMP_UNROLL
+    ld a, (de)
+    cpi
+    jr nz, _memcmp_diff
+    inc de
+    ENDR
+    ; P/V flag is reset by CPI when BC reaches 0
+    jp pe, _memcmp_steps
+    xor a
+    jr _memcmp_end
+_memcmp_diff:
+    ; CPI already incremented HL, A still contains the byte from DE
+    dec hl
+    sub (hl)
+_memcmp_end:
     pop bc
     pop de
     pop hl
@@ -10,6 +10,7 @@
         INCLUDE "mmu_h.asm"
         INCLUDE "utils_h.asm"
         INCLUDE "syscalls_h.asm"
+        INCLUDE "jobs_h.asm"
 
         EXTERN zos_loader_exit
         EXTERN zos_loader_exec
@@ -25,7 +26,11 @@ zos_sys_init:
         ; and the jp opcode: 0xC3.
         ld a, 0xc3
         ld (_zos_sys_jump), a
+    IF CONFIG_KERNEL_JOBS
+        jp zos_job_init
+    ELSE
         ret
+    ENDIF
 
         ; Map a physical memory address to the virtual address space.
         ; Prerequisite:
@@ -57,6 +62,18 @@ _zos_sys_map_error:
         ld a, ERR_INVALID_VIRT_PAGE
         ret
 
+    IF !CONFIG_KERNEL_JOBS
+        ; Without background jobs, there is no other job to give the CPU to
+zos_sys_yield:
+        xor a
+        ret
+
+        ; Job statistics are not available when background jobs are disabled
+zos_sys_jobstat:
+        ld a, ERR_NOT_SUPPORTED
+        ret
+    ENDIF
+
 
         ; Routine that shall be called as soon as a syscall has been requested.
         ; It will map the kernel RAM before operating, then perform the syscall,
@@ -123,8 +140,12 @@ zos_sys_perform_syscall:
         ; We still cannot use the stack. The stack pointer register corresponds
         ; to the user's stack, not the system's.
         ld (_zos_user_sp), sp
-        ; Load the system stack
+        ; Load the system stack, each job has its own
+    IF CONFIG_KERNEL_JOBS
+        ld sp, (_zos_job_kstack)
+    ELSE
         ld sp, CONFIG_KERNEL_STACK_ADDR
+    ENDIF
         ; Now we can prepare the jp SYSCALL instruction. Use the syscall tables to get the routine we have
         ; to jump to.
         push hl
@@ -276,6 +297,7 @@ zos_sys_restore_pages:
 
         SECTION KERNEL_BSS
 
+        PUBLIC _zos_user_a
         PUBLIC _zos_user_sp
         PUBLIC _zos_user_page_1
 _zos_user_a:  DEFS 1
@@ -310,7 +332,11 @@ syscall_exit:
 syscall_exec:
         DEFW zos_loader_exec
         DEFW zos_vfs_dup
+    IF CONFIG_KERNEL_JOBS
+        DEFW zos_job_msleep
+    ELSE
         DEFW zos_time_msleep
+    ENDIF
         DEFW zos_time_settime
         DEFW zos_time_gettime
         DEFW zos_date_setdate
@@ -323,4 +349,13 @@ syscall_map:
         DEFW zos_vfs_swap
         DEFW zos_loader_palloc
         DEFW zos_loader_pfree
+    IF CONFIG_KERNEL_JOBS
+        DEFW zos_job_sys_yield
+        DEFW zos_job_stat
+    ELSE
+        DEFW zos_sys_yield
+        DEFW zos_sys_jobstat
+    ENDIF
+        DEFW zos_sys_batch
+        DEFW zos_vfs_preallocate
 zos_syscalls_table_end:
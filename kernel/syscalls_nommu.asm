@@ -23,9 +23,10 @@ zos_sys_init:
         ld (_zos_sys_jump), a
         ret
 
-        ; Page allocation syscalls are not available in no-mmu context
+        ; Page allocation and job statistics syscalls are not available in no-mmu context
 zos_loader_palloc:
 zos_loader_pfree:
+zos_sys_jobstat:
         ; Map a physical memory address to the virtual address space.
         ; Not supported on MMU-less targets.
         ; Returns:
@@ -34,6 +35,12 @@ zos_sys_map:
         ld a, ERR_NOT_SUPPORTED
         ret
 
+        ; Background jobs are not supported on MMU-less targets, there is no other job
+        ; to give the CPU to
+zos_sys_yield:
+        xor a
+        ret
+
         ; Routine that shall be called as soon as a syscall has been requested.
         ; It will map the kernel RAM before operating, then perform the syscall,
         ; and restore the user's RAM finally.
@@ -118,4 +125,8 @@ syscall_map:
         DEFW zos_vfs_swap
         DEFW zos_loader_palloc
         DEFW zos_loader_pfree
+        DEFW zos_sys_yield
+        DEFW zos_sys_jobstat
+        DEFW zos_sys_batch
+        DEFW zos_vfs_preallocate
 zos_syscalls_table_end:
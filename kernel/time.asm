@@ -126,6 +126,11 @@ _zos_waste_time:
         ;       A, HL
         PUBLIC zos_time_settime
 zos_time_settime:
+    IF CONFIG_KERNEL_DATE_CACHE
+        ; The cached date is interpolated from the timer, it cannot be trusted anymore
+        xor a
+        ld (_zos_date_cache_valid), a
+    ENDIF
         ld hl, (_zos_time_driver_settime)
         ld a, h
         or l
@@ -167,6 +172,25 @@ zos_time_gettime:
         pop bc
         ret
 
+    IF CONFIG_KERNEL_LOG_BOOT_TIMESTAMPS
+        ; Get the current value of the time counter, in milliseconds, to timestamp
+        ; kernel logs. Unlike zos_time_gettime, this routine cannot fail.
+        ; Parameters:
+        ;       None
+        ; Returns:
+        ;       DE - Time counter in milliseconds, 0 if no timer is available
+        ; Alters:
+        ;       A, DE, HL
+        PUBLIC zos_time_get_timestamp
+zos_time_get_timestamp:
+        ld h, 0
+        call zos_time_gettime
+        or a
+        ret z
+        ld de, 0
+        ret
+    ENDIF
+
         ; ------------------------ DATE RELATED ------------------------;
 
         ; Initialize the date interface implementation. This routine is meant
@@ -201,6 +225,11 @@ zos_date_init:
         ;       A
         PUBLIC zos_date_setdate
 zos_date_setdate:
+    IF CONFIG_KERNEL_DATE_CACHE
+        ; Force the next kernel read to get the new date from the driver
+        xor a
+        ld (_zos_date_cache_valid), a
+    ENDIF
         ld hl, (_zos_date_driver_setdate)
 _zos_date_check_bc_call_hl:
         ld a, h
@@ -242,6 +271,8 @@ zos_date_getdate:
 
         ; Routine to get the date from a routine within the kernel, there won't be
         ; any check of the destination buffer.
+        ; If the date cache is enabled, the driver is only called when the cache needs
+        ; to be (re)synchronized, else the date is interpolated from the timer.
         ; Parameters:
         ;       DE - Address to a date structure to fill, as defined in the
         ;            time_h.asm header file. Must not be NULL.
@@ -256,9 +287,154 @@ zos_date_getdate_kernel:
         or l
         ld a, ERR_NOT_IMPLEMENTED
         ret z
+    IF CONFIG_KERNEL_DATE_CACHE
+        ; Without a timer, the date cannot be interpolated, always call the driver
+        push hl
+        ld hl, (_zos_time_driver_gettime)
+        ld a, h
+        or l
+        pop hl
+        jr nz, _zos_date_getdate_cached
+    ENDIF
         jp (hl)
 
 
+    IF CONFIG_KERNEL_DATE_CACHE
+        ; Invalidate the cached date, the next kernel read will get the date from
+        ; the driver. Meant to be called by the timer driver when its counter
+        ; overflows since the elapsed time cannot be calculated anymore.
+        ; This routine can be called from an interrupt handler.
+        ; Parameters:
+        ;       None
+        ; Returns:
+        ;       None
+        ; Alters:
+        ;       A
+        PUBLIC zos_date_cache_invalidate
+zos_date_cache_invalidate:
+        xor a
+        ld (_zos_date_cache_valid), a
+        ret
+
+
+        ; Get the date out of the cache, resynchronize it if needed.
+        ; Parameters:
+        ;       DE - Address of the date structure to fill
+        ; Returns:
+        ;       A - ERR_SUCCESS on success, error code else
+        ; Alters:
+        ;       A, BC, DE, HL
+_zos_date_getdate_cached:
+        push de
+        ld a, (_zos_date_cache_valid)
+        or a
+        jr z, _zos_date_cache_sync
+        ld h, 0
+        call zos_time_gettime
+        ; Check if the resynchronization period elapsed, HL = now, DE = sync time
+        ld hl, (_zos_date_cache_sync_tick)
+        ex de, hl
+        push hl
+        or a
+        sbc hl, de
+        ld de, CONFIG_KERNEL_DATE_CACHE_RESYNC
+        or a
+        sbc hl, de
+        pop hl
+        jr nc, _zos_date_cache_sync
+        ; Calculate the milliseconds that were not accounted in the cached date yet
+        ld de, (_zos_date_cache_tick)
+        ld (_zos_date_cache_tick), hl
+        or a
+        sbc hl, de
+        ld de, (_zos_date_cache_ms)
+        add hl, de
+        ; Add one second to the date for each 1000ms
+        ld de, 1000
+_zos_date_cache_advance:
+        or a
+        sbc hl, de
+        jr c, _zos_date_cache_advanced
+        call _zos_date_cache_add_second
+        jr nc, _zos_date_cache_advance
+        ; The day changed, let the driver handle the days/months/years
+        jr _zos_date_cache_sync
+_zos_date_cache_advanced:
+        add hl, de
+        ld (_zos_date_cache_ms), hl
+_zos_date_cache_copy:
+        pop de
+        ld hl, _zos_date_cache
+        ld bc, DATE_STRUCT_SIZE
+        ldir
+        ; Optimization for ERR_SUCCESS
+        xor a
+        ret
+_zos_date_cache_sync:
+        xor a
+        ld (_zos_date_cache_valid), a
+        ld de, _zos_date_cache
+        ld hl, (_zos_date_driver_getdate)
+        CALL_HL()
+        or a
+        jr nz, _zos_date_cache_error
+        ; Mark the cache as valid before sampling the timer, in case it overflows in between
+        inc a
+        ld (_zos_date_cache_valid), a
+        ld h, 0
+        call zos_time_gettime
+        ld (_zos_date_cache_tick), de
+        ld (_zos_date_cache_sync_tick), de
+        ld hl, 0
+        ld (_zos_date_cache_ms), hl
+        jr _zos_date_cache_copy
+_zos_date_cache_error:
+        pop de
+        ret
+
+
+        ; Add one second to the cached date. The day is not incremented, the cache
+        ; must be resynchronized instead.
+        ; Parameters:
+        ;       None
+        ; Returns:
+        ;       Carry - Set if the day changed, not set else
+        ; Alters:
+        ;       A, BC
+_zos_date_cache_add_second:
+        ld bc, _zos_date_cache + date_seconds_t
+        ld a, (bc)
+        add 1
+        daa
+        cp 0x60
+        jr c, _zos_date_cache_store
+        xor a
+        ld (bc), a
+        ; Minutes are right before the seconds in the structure
+        dec bc
+        ld a, (bc)
+        add 1
+        daa
+        cp 0x60
+        jr c, _zos_date_cache_store
+        xor a
+        ld (bc), a
+        ; Hours are right before the minutes
+        dec bc
+        ld a, (bc)
+        add 1
+        daa
+        cp 0x24
+        ; Carry set if the day changed
+        ccf
+        ret c
+_zos_date_cache_store:
+        ld (bc), a
+        or a
+        ret
+    ENDIF
+
+
         SECTION KERNEL_BSS
         ; Time routines
 _zos_time_driver_msleep: DEFW 1
@@ -267,3 +443,13 @@ _zos_time_driver_gettime: DEFW 1
         ; Date routines
 _zos_date_driver_setdate: DEFW 1
 _zos_date_driver_getdate: DEFW 1
+    IF CONFIG_KERNEL_DATE_CACHE
+        ; Date cache, interpolated thanks to the timer
+_zos_date_cache_valid: DEFS 1
+        ; Timer value of the last resynchronization and of the last update
+_zos_date_cache_sync_tick: DEFS 2
+_zos_date_cache_tick: DEFS 2
+        ; Milliseconds elapsed but not accounted in the cached date yet
+_zos_date_cache_ms: DEFS 2
+_zos_date_cache: DEFS DATE_STRUCT_SIZE
+    ENDIF
@@ -1,9 +1,12 @@
 
 # Kernel core related files
-SRCS = rst_vectors.asm boot.asm drivers.asm strutils.asm disks.asm vfs.asm time.asm log.asm
+SRCS = rst_vectors.asm boot.asm drivers.asm strutils.asm disks.asm vfs.asm time.asm log.asm batch.asm
 
 ifdef CONFIG_KERNEL_TARGET_HAS_MMU
 	SRCS += syscalls.asm loader.asm
+	ifdef CONFIG_KERNEL_JOBS
+		SRCS += jobs.asm
+	endif
 else
 	SRCS += syscalls_nommu.asm loader_nommu.asm
 endif
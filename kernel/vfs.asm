@@ -57,6 +57,10 @@ _zos_vfs_clean_close:
         ; Ignore return value of zos_vfs_close as some may be invalid
         call zos_vfs_close
         djnz _zos_vfs_clean_close
+    IF CONFIG_KERNEL_OPENED_FILES_POOL
+        ; All the opened files are closed, give back the structures allocated on demand
+        call zos_disks_pool_trim
+    ENDIF
         ; Fall-through
 
         ; Populate the stdin and stdout in the opened dev table.
@@ -350,6 +354,7 @@ zos_vfs_read_internal:
         ; Alters:
         ;       A, HL, BC
         PUBLIC zos_vfs_write
+        PUBLIC zos_vfs_write_internal
 zos_vfs_write:
         push de
     IF CONFIG_KERNEL_TARGET_HAS_MMU
@@ -590,6 +595,24 @@ _zos_vfs_seek_pophl_ret:
         ret
 
 
+        ; Reserve room on the disk for a file that is about to be written, so that the
+        ; writes don't have to allocate any space. On file systems that support it, the
+        ; space is reserved as a contiguous area when possible.
+        ; If the given size is smaller than the file size, the file is truncated, else,
+        ; the file size is not modified.
+        ; Parameters:
+        ;       H - Dev number, must refer to a file opened with write flags
+        ;       BCDE - 32-bit size to reserve
+        ; Returns:
+        ;       A - ERR_SUCCESS on success, error code else.
+        PUBLIC zos_vfs_preallocate
+zos_vfs_preallocate:
+        call zos_vfs_get_entry
+        ret nz
+        ; The disk layer checks that the dev is an opened file
+        jp zos_disk_preallocate
+
+
         ; Create a directory at the specified location.
         ; If one of the directories in the given path doesn't exist, this will fail.
         ; For example, if mkdir("A:/D/E/F") is requested where D exists but E doesn't, this syscall
@@ -896,6 +919,11 @@ zos_vfs_mount:
         DISKS_IS_OPN_FILEDIR(hl)
         ld a, ERR_INVALID_PARAMETER
         ret z
+        ; Make sure the file system is valid
+        ld a, e
+        cp FS_END
+        ld a, ERR_INVALID_PARAMETER
+        ret nc
         ; The dev is a driver, we can try to mount it directly
         ld a, d ; Letter to mount it on in A register
         jp zos_disks_mount
@@ -0,0 +1,58 @@
+/* SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include "zos_errors.h"
+#include "zos_time.h"
+
+/**
+ * Timing helpers shared by the benchmarks. The time is only reported when the
+ * target provides a timer.
+ */
+static uint16_t s_bench_start;
+static uint8_t  s_bench_has_timer;
+
+
+/**
+ * Start measuring the time of a step.
+ */
+static void bench_start(void)
+{
+    zos_time_t time;
+    s_bench_has_timer = gettime(0, &time) == ERR_SUCCESS;
+    s_bench_start = time.t_millis;
+}
+
+
+/**
+ * Get the number of milliseconds elapsed since `bench_start`, 0 if the target has no timer.
+ * The timer wraps around after 65 seconds, longer steps must be split.
+ */
+static uint16_t bench_elapsed(void)
+{
+    zos_time_t time;
+    if (s_bench_has_timer && gettime(0, &time) == ERR_SUCCESS) {
+        return time.t_millis - s_bench_start;
+    }
+    return 0;
+}
+
+
+/**
+ * Print the result of the step started with `bench_start`: its name, a count
+ * followed by its unit, and the elapsed time when available.
+ */
+static void bench_report(const char* name, uint16_t count, const char* unit)
+{
+    zos_time_t time;
+    if (s_bench_has_timer && gettime(0, &time) == ERR_SUCCESS) {
+        printf("%s %5u %s, %u ms\n", name, count, unit, time.t_millis - s_bench_start);
+    } else {
+        printf("%s %5u %s\n", name, count, unit);
+    }
+}
@@ -0,0 +1,119 @@
+/* SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "zos_errors.h"
+#include "zos_vfs.h"
+#include "zos_sys.h"
+#include "zos_time.h"
+#include "bench_timer.h"
+
+/* Number of files to create, and how many are created between two timer reads,
+ * the 16-bit millisecond counter would wrap around on the whole run */
+#define FILES_COUNT     1000
+#define FILES_BATCH     50
+
+/* Room for the directory path, '/', the 4-character file name and the NULL byte */
+static char s_path[PATH_MAX + 6];
+static uint8_t s_dir_len;
+
+
+static void set_name(uint16_t index)
+{
+    char* name = s_path + s_dir_len;
+    name[0] = 'f';
+    name[1] = '0' + (index / 100);
+    name[2] = '0' + (index / 10) % 10;
+    name[3] = '0' + index % 10;
+    name[4] = 0;
+}
+
+
+static void report_total(const char* name, uint16_t count, uint32_t total)
+{
+    printf("%s %5u files, %lu ms\n", name, count, total);
+}
+
+
+/* Create (or remove) all the files, returns the number of files processed */
+static uint16_t run(uint8_t create, uint32_t* total)
+{
+    uint16_t i;
+    zos_err_t err = ERR_SUCCESS;
+
+    *total = 0;
+    bench_start();
+    for (i = 0; i < FILES_COUNT && err == ERR_SUCCESS; i++) {
+        if (i != 0 && i % FILES_BATCH == 0) {
+            *total += bench_elapsed();
+            bench_start();
+        }
+        set_name(i);
+        if (create) {
+            zos_dev_t dev = open(s_path, O_WRONLY | O_CREAT);
+            if (dev < 0) {
+                err = -dev;
+            } else {
+                close(dev);
+            }
+        } else {
+            err = rm(s_path);
+        }
+    }
+    *total += bench_elapsed();
+    if (err != ERR_SUCCESS) {
+        printf("stopped by error %d\n", err);
+        i--;
+    }
+    return i;
+}
+
+
+int main(int argc, char** argv)
+{
+    const char* dir = (argc == 1) ? argv[0] : "T:/bench";
+    zos_date_t date;
+    uint32_t total;
+    uint16_t count;
+    uint16_t i;
+
+    s_dir_len = strlen(dir);
+    if (s_dir_len > PATH_MAX - 1) {
+        printf("path too long\n");
+        return 1;
+    }
+    strcpy(s_path, dir);
+    /* The directory may exist already from a previous run */
+    mkdir(s_path);
+    s_path[s_dir_len++] = '/';
+
+    count = run(1, &total);
+    report_total("create():", count, total);
+
+    /* Removing the files doesn't date any entry, it shows the cost of the directory
+     * operations alone */
+    count = run(0, &total);
+    report_total("rm():    ", count, total);
+
+    /* The `getdate` syscall always reads the date driver, this is the cost each
+     * create pays when the kernel is built without the date cache */
+    total = 0;
+    bench_start();
+    for (i = 0; i < FILES_COUNT; i++) {
+        if (i != 0 && i % FILES_BATCH == 0) {
+            total += bench_elapsed();
+            bench_start();
+        }
+        if (getdate(&date) != ERR_SUCCESS) {
+            printf("no date driver\n");
+            break;
+        }
+    }
+    total += bench_elapsed();
+    printf("getdate(): %5u calls, %lu ms\n", i, total);
+    return 0;
+}
@@ -0,0 +1,76 @@
+/* SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include "zos_errors.h"
+#include "zos_vfs.h"
+#include "zos_sys.h"
+#include "bench_timer.h"
+
+/* Opened devices are referenced by a byte, the kernel can't provide more than this */
+#define MAX_FILES   128
+
+static zos_dev_t s_devs[MAX_FILES];
+
+
+/* Make sure the file exists and is not empty so that a byte can be read from it */
+static zos_err_t prepare(const char* path)
+{
+    uint16_t size = 1;
+    char c = 'a';
+    zos_err_t err;
+    zos_dev_t dev = open(path, O_WRONLY | O_CREAT | O_TRUNC);
+    if (dev < 0) {
+        return -dev;
+    }
+    err = write(dev, &c, &size);
+    close(dev);
+    return err;
+}
+
+
+int main(int argc, char** argv)
+{
+    const char* path = (argc == 1) ? argv[0] : "B:/bench.txt";
+    zos_err_t ret = prepare(path);
+    zos_dev_t dev = 0;
+    uint16_t size;
+    uint8_t count;
+    uint8_t i;
+    char c;
+
+    if (ret != ERR_SUCCESS) {
+        printf("error %d occurred\n", ret);
+        return 1;
+    }
+
+    bench_start();
+    for (count = 0; count < MAX_FILES; count++) {
+        dev = open(path, O_RDONLY);
+        if (dev < 0) {
+            break;
+        }
+        s_devs[count] = dev;
+    }
+    bench_report("open(): ", count, "files");
+    if (dev < 0) {
+        printf("stopped by error %d\n", -dev);
+    }
+
+    bench_start();
+    for (i = 0; i < count; i++) {
+        size = 1;
+        read(s_devs[i], &c, &size);
+    }
+    bench_report("read(): ", count, "files");
+
+    bench_start();
+    for (i = 0; i < count; i++) {
+        close(s_devs[i]);
+    }
+    bench_report("close():", count, "files");
+    return 0;
+}
@@ -0,0 +1,62 @@
+/* SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <stddef.h>
+#include "first_fit.h"
+
+/* Each block starts with a 16-bit header: its size, header included, with the
+ * lowest bit set when the block is in use. Sizes are always even. */
+#define USED    1
+
+static uint16_t* s_start;
+static uint16_t* s_end;
+
+
+void ff_init(void* area, uint16_t size)
+{
+    s_start = (uint16_t*) area;
+    s_end = (uint16_t*) ((uint8_t*) area + size);
+    *s_start = size;
+}
+
+
+void* ff_alloc(uint16_t size)
+{
+    uint16_t* block = s_start;
+    const uint16_t needed = (size + sizeof(uint16_t) + 1) & ~1;
+
+    while (block < s_end) {
+        uint16_t bsize = *block;
+        if ((bsize & USED) == 0) {
+            /* Merge the following free blocks */
+            uint16_t* next = (uint16_t*) ((uint8_t*) block + bsize);
+            while (next < s_end && (*next & USED) == 0) {
+                bsize += *next;
+                next = (uint16_t*) ((uint8_t*) block + bsize);
+            }
+            *block = bsize;
+            if (bsize >= needed) {
+                /* Split the block if the remaining part can hold a header */
+                if (bsize - needed >= 2 * sizeof(uint16_t)) {
+                    *((uint16_t*) ((uint8_t*) block + needed)) = bsize - needed;
+                    bsize = needed;
+                }
+                *block = bsize | USED;
+                return block + 1;
+            }
+        }
+        block = (uint16_t*) ((uint8_t*) block + (bsize & ~USED));
+    }
+    return NULL;
+}
+
+
+void ff_free(void* ptr)
+{
+    if (ptr != NULL) {
+        uint16_t* block = (uint16_t*) ptr - 1;
+        *block &= ~USED;
+    }
+}
@@ -0,0 +1,15 @@
+/* SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Naive first-fit allocator working on a single memory area, used as a reference.
+ */
+void  ff_init(void* area, uint16_t size);
+void* ff_alloc(uint16_t size);
+void  ff_free(void* ptr);
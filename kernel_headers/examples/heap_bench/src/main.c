@@ -0,0 +1,122 @@
+/* SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include "zos_errors.h"
+#include "zos_sys.h"
+#include "zos_time.h"
+#include "zos_heap.h"
+#include "first_fit.h"
+
+/* This program must fit in the first 16KB virtual page, the second one is used
+ * as the window where both allocators map their memory. */
+#define WINDOW      ((void*) 0x8000)
+#define SLOTS       64
+#define ITERATIONS  4000
+
+typedef void* (*alloc_fn)(uint16_t size);
+typedef void  (*free_fn)(void* ptr);
+
+static void* s_slots[SLOTS];
+static uint16_t s_seed;
+
+
+static uint16_t rand16(void)
+{
+    s_seed = s_seed * 25173 + 13849;
+    return s_seed;
+}
+
+
+/* Mostly small objects, some medium ones and a few buffers of a few kilobytes */
+static uint16_t random_size(void)
+{
+    const uint16_t r = rand16();
+    const uint8_t kind = r & 0x1f;
+    if (kind == 0) {
+        return 1024 + ((r >> 5) & 0x7ff);
+    } else if (kind < 6) {
+        return 64 + ((r >> 5) & 0xff);
+    }
+    return 4 + ((r >> 5) & 0x3f);
+}
+
+
+static void run(const char* name, alloc_fn alloc, free_fn release)
+{
+    zos_time_t start;
+    zos_time_t end;
+    uint16_t failures = 0;
+    uint16_t i;
+    const uint8_t has_timer = gettime(0, &start) == ERR_SUCCESS;
+
+    s_seed = 0x1234;
+    for (i = 0; i < SLOTS; i++) {
+        s_slots[i] = NULL;
+    }
+
+    for (i = 0; i < ITERATIONS; i++) {
+        const uint8_t slot = rand16() % SLOTS;
+        if (s_slots[slot] != NULL) {
+            release(s_slots[slot]);
+            s_slots[slot] = NULL;
+        } else {
+            s_slots[slot] = alloc(random_size());
+            if (s_slots[slot] == NULL) {
+                failures++;
+            }
+        }
+    }
+
+    if (has_timer && gettime(0, &end) == ERR_SUCCESS) {
+        printf("%s: %u ms, %u failed allocations\n", name, end.t_millis - start.t_millis, failures);
+    } else {
+        printf("%s: %u failed allocations\n", name, failures);
+    }
+}
+
+
+static void free_all(free_fn release)
+{
+    uint8_t i;
+    for (i = 0; i < SLOTS; i++) {
+        release(s_slots[i]);
+    }
+}
+
+
+int main(void)
+{
+    zos_heap_stats_t stats;
+    uint8_t page;
+    zos_err_t ret;
+
+    /* Reference: first-fit allocator on a single page */
+    ret = palloc(&page);
+    if (ret == ERR_SUCCESS) {
+        ret = pmap(page, WINDOW);
+    }
+    if (ret != ERR_SUCCESS) {
+        printf("error %d occurred\n", ret);
+        return 1;
+    }
+    ff_init(WINDOW, ZOS_HEAP_PAGE_SIZE);
+    run("first-fit", ff_alloc, ff_free);
+    pfree(page);
+
+    /* Slab allocator, using the same window */
+    heap_init(WINDOW, 1);
+    run("slab     ", heap_alloc, heap_free);
+    heap_stats(&stats);
+    printf("pages: %u, slabs: %u, blocks: %u, used: %u/%u bytes, largest free run: %u KB\n",
+           stats.h_pages, stats.h_slabs, stats.h_allocs,
+           stats.h_used, stats.h_slab_bytes, stats.h_largest_run);
+
+    free_all(heap_free);
+    heap_stats(&stats);
+    printf("after freeing everything, pages: %u\n", stats.h_pages);
+    return 0;
+}
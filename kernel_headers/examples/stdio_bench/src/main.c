@@ -0,0 +1,100 @@
+/* SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include "zos_errors.h"
+#include "zos_vfs.h"
+#include "zos_sys.h"
+#include "zos_stdio.h"
+#include "bench_timer.h"
+
+/* Number of bytes to write and read back in each test */
+#define BENCH_SIZE  2048
+
+
+/* Unbuffered: one `write`/`read` syscall per byte */
+static zos_err_t bench_raw(const char* path)
+{
+    uint16_t i;
+    uint16_t calls = 0;
+    uint16_t size;
+    char c = 0;
+    zos_dev_t dev = open(path, O_WRONLY | O_CREAT | O_TRUNC);
+    if (dev < 0) {
+        return -dev;
+    }
+
+    bench_start();
+    for (i = 0; i < BENCH_SIZE; i++) {
+        c = 'a' + (i % 26);
+        size = 1;
+        write(dev, &c, &size);
+        calls++;
+    }
+    bench_report("write():", calls, "syscalls");
+    close(dev);
+
+    dev = open(path, O_RDONLY);
+    if (dev < 0) {
+        return -dev;
+    }
+    calls = 0;
+    bench_start();
+    do {
+        size = 1;
+        calls++;
+    } while (read(dev, &c, &size) == ERR_SUCCESS && size != 0);
+    bench_report("read(): ", calls, "syscalls");
+    close(dev);
+    return ERR_SUCCESS;
+}
+
+
+/* Buffered: the bytes go through a `zos_file_t` stream, a syscall is issued per buffer */
+static zos_err_t bench_stream(const char* path)
+{
+    uint16_t i;
+    zos_file_t* file = fopen(path, "w");
+    if (file == NULL) {
+        return ERR_FAILURE;
+    }
+
+    zos_stdio_syscalls = 0;
+    bench_start();
+    for (i = 0; i < BENCH_SIZE; i++) {
+        fputc('a' + (i % 26), file);
+    }
+    fclose(file);
+    bench_report("fputc():", zos_stdio_syscalls, "syscalls");
+
+    file = fopen(path, "r");
+    if (file == NULL) {
+        return ERR_FAILURE;
+    }
+    zos_stdio_syscalls = 0;
+    bench_start();
+    while (fgetc(file) != EOF) {
+    }
+    fclose(file);
+    bench_report("fgetc():", zos_stdio_syscalls, "syscalls");
+    return ERR_SUCCESS;
+}
+
+
+int main(int argc, char** argv)
+{
+    const char* path = (argc == 1) ? argv[0] : "B:/bench.txt";
+    zos_err_t ret = bench_raw(path);
+
+    if (ret == ERR_SUCCESS) {
+        ret = bench_stream(path);
+    }
+    if (ret != ERR_SUCCESS) {
+        printf("error %d occurred\n", ret);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,317 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: CC0-1.0
+
+    INCLUDE "zos_sys.asm"
+    INCLUDE "strutils_h.asm"
+
+    ; Each measurement processes the same amount of bytes, whatever the length of the
+    ; buffers, so that all the results have the same precision.
+    DEFC TOTAL_BYTES = 160000
+    ; Frequency of the CPU the T-states are calculated for, in kHz
+    DEFC CPU_FREQ_KHZ = 10000
+    DEFC MAX_LENGTH = 2000
+    ; Byte used to fill the strings, the delimiter given to memsep/strsep is never found
+    DEFC FILL_CHAR = 'a'
+    DEFC DELIMITER = '#'
+
+    ORG 0x4000
+
+_start:
+    ld h, 0
+    GETTIME()
+    or a
+    jr z, _start_timer_ok
+    S_WRITE3(DEV_STDOUT, no_timer_msg, no_timer_msg_end - no_timer_msg)
+    ld h, 1
+    EXIT()
+_start_timer_ok:
+    S_WRITE3(DEV_STDOUT, header_msg, header_msg_end - header_msg)
+    ld hl, primitives
+_start_primitive:
+    ld e, (hl)
+    inc hl
+    ld d, (hl)
+    inc hl
+    ld a, d
+    or e
+    jr z, _start_end
+    ld (cur_name), de
+    ld e, (hl)
+    inc hl
+    ld d, (hl)
+    inc hl
+    ld (cur_routine), de
+    push hl
+    call bench_primitive
+    pop hl
+    jr _start_primitive
+_start_end:
+    ld h, 0
+    EXIT()
+
+
+    ; Measure the current primitive for all the lengths and print the results on a line
+bench_primitive:
+    ; Name of the primitive, padded to 8 characters
+    ld hl, (cur_name)
+    ld de, line
+    ld bc, 8
+    ldir
+    ld hl, lengths
+    ld b, LENGTHS_COUNT
+_bench_primitive_loop:
+    push bc
+    ld c, (hl)
+    inc hl
+    ld b, (hl)
+    inc hl
+    ld (cur_length), bc
+    ld c, (hl)
+    inc hl
+    ld b, (hl)
+    inc hl
+    ld (cur_iterations), bc
+    push hl
+    push de
+    call bench_length
+    pop de
+    ; HL contains the number of tenths of T-states per byte
+    call print_tenths
+    pop hl
+    pop bc
+    djnz _bench_primitive_loop
+    ld a, '\n'
+    ld (de), a
+    inc de
+    ex de, hl
+    ld de, line
+    or a
+    sbc hl, de
+    ld b, h
+    ld c, l
+    S_WRITE1(DEV_STDOUT)
+    ret
+
+
+    ; Measure the current primitive with the current length.
+    ; The time taken by an empty routine is measured too and subtracted.
+    ; Returns:
+    ;   HL - Tenths of T-states per byte
+bench_length:
+    ld ix, empty_routine
+    call bench_run
+    push de
+    call prepare_buffers
+    ld ix, (cur_routine)
+    call bench_run
+    pop bc
+    ex de, hl
+    or a
+    sbc hl, bc
+    jr nc, _bench_length_positive
+    ld hl, 0
+_bench_length_positive:
+    ; T/byte = ms * CPU_FREQ_KHZ / TOTAL_BYTES = ms / 16, get the tenths: ms * 5 / 8
+    ld d, h
+    ld e, l
+    add hl, hl
+    add hl, hl
+    add hl, de
+    srl h
+    rr l
+    srl h
+    rr l
+    srl h
+    rr l
+    ret
+
+
+    ; Call the routine in IX cur_iterations times.
+    ; Parameters:
+    ;   IX - Routine to call, it receives HL = src, DE = dst and BC = length
+    ; Returns:
+    ;   DE - Elapsed time in milliseconds
+bench_run:
+    ld h, 0
+    GETTIME()
+    ld (start_time), de
+    ld bc, (cur_iterations)
+_bench_run_loop:
+    push bc
+    ld hl, src_buffer
+    ld de, dst_buffer
+    ld bc, (cur_length)
+    call _bench_run_call
+    pop bc
+    dec bc
+    ld a, b
+    or c
+    jr nz, _bench_run_loop
+    ld h, 0
+    GETTIME()
+    ld hl, (start_time)
+    ex de, hl
+    or a
+    sbc hl, de
+    ex de, hl
+    ret
+_bench_run_call:
+    jp (ix)
+
+
+    ; Fill the source buffer with a string of `cur_length` bytes, NULL-byte included,
+    ; and copy it to the destination buffer so that comparisons go until the end.
+prepare_buffers:
+    ld hl, src_buffer
+    ld bc, (cur_length)
+    dec bc
+    ld e, FILL_CHAR
+    call memset
+    add hl, bc
+    ld (hl), 0
+    ld hl, src_buffer
+    ld de, dst_buffer
+    ld bc, (cur_length)
+    jp memcpy
+
+
+    ; Wrappers adapting the parameters HL = src, DE = dst, BC = length to each primitive
+empty_routine:
+    ret
+
+ldir_routine:
+    ldir
+    ret
+
+memset_routine:
+    ex de, hl
+    ld e, FILL_CHAR
+    jp memset
+
+strncat_routine:
+    ; Concatenate to an empty destination
+    ex de, hl
+    xor a
+    ld (hl), a
+    jp strncat
+
+memsep_routine:
+    ld a, DELIMITER
+    jp memsep
+
+strsep_routine:
+    ld a, DELIMITER
+    jp strsep
+
+
+    ; Print a value in tenths as a right-aligned decimal number with one decimal
+    ; Parameters:
+    ;   HL - Value to print
+    ;   DE - Destination, 8 characters are written
+    ; Returns:
+    ;   DE - Destination + 8
+print_tenths:
+    push hl
+    ; Clear the field
+    ld h, d
+    ld l, e
+    ld (hl), ' '
+    inc de
+    ld bc, 7
+    ldir
+    ; HL points to the last character of the field, keep it on the stack
+    ex (sp), hl
+    ld c, 10
+    call div16_8
+    ex (sp), hl
+    add '0'
+    ld (hl), a
+    dec hl
+    ld (hl), '.'
+    dec hl
+_print_tenths_loop:
+    ex (sp), hl
+    ld c, 10
+    call div16_8
+    ld b, h
+    ld c, l
+    ex (sp), hl
+    add '0'
+    ld (hl), a
+    dec hl
+    ; Stop once the quotient is 0
+    ld a, b
+    or c
+    jr nz, _print_tenths_loop
+    pop hl
+    ret
+
+
+    ; Divide HL by C
+    ; Returns:
+    ;   HL - Quotient
+    ;   A  - Remainder
+div16_8:
+    xor a
+    ld b, 16
+_div16_8_loop:
+    add hl, hl
+    rla
+    cp c
+    jr c, _div16_8_next
+    sub c
+    inc l
+_div16_8_next:
+    djnz _div16_8_loop
+    ret
+
+
+no_timer_msg: DEFM "This benchmark requires a timer\n"
+no_timer_msg_end:
+header_msg:
+    DEFM "T-states per byte at 10MHz\n"
+    DEFM "length        10      40     160     640    2000\n"
+header_msg_end:
+
+    ; Length of the buffers and number of iterations to process TOTAL_BYTES bytes
+lengths:
+    DEFW 10, TOTAL_BYTES / 10
+    DEFW 40, TOTAL_BYTES / 40
+    DEFW 160, TOTAL_BYTES / 160
+    DEFW 640, TOTAL_BYTES / 640
+    DEFW MAX_LENGTH, TOTAL_BYTES / MAX_LENGTH
+    DEFC LENGTHS_COUNT = 5
+
+    ; Name (8 characters) and routine of each primitive, terminated by a NULL name
+primitives:
+    DEFW ldir_name, ldir_routine
+    DEFW memcpy_name, memcpy
+    DEFW memset_name, memset_routine
+    DEFW memcmp_name, memcmp
+    DEFW strcmp_name, strcmp
+    DEFW strncmp_name, strncmp
+    DEFW strcpy_name, strcpy
+    DEFW strncat_name, strncat_routine
+    DEFW memsep_name, memsep_routine
+    DEFW strsep_name, strsep_routine
+    DEFW 0
+ldir_name:    DEFM "ldir    "
+memcpy_name:  DEFM "memcpy  "
+memset_name:  DEFM "memset  "
+memcmp_name:  DEFM "memcmp  "
+strcmp_name:  DEFM "strcmp  "
+strncmp_name: DEFM "strncmp "
+strcpy_name:  DEFM "strcpy  "
+strncat_name: DEFM "strncat "
+memsep_name:  DEFM "memsep  "
+strsep_name:  DEFM "strsep  "
+
+cur_name: DEFS 2
+cur_routine: DEFS 2
+cur_length: DEFS 2
+cur_iterations: DEFS 2
+start_time: DEFS 2
+line: DEFS 8 + LENGTHS_COUNT * 8 + 1
+src_buffer: DEFS MAX_LENGTH
+dst_buffer: DEFS MAX_LENGTH
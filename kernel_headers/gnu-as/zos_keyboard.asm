@@ -12,8 +12,13 @@
     ; Parameters:
     ;   E - New mode
     .equ KB_CMD_SET_MODE, 0
+    ; Get the number of bytes received from the keyboard that were lost because the
+    ; FIFO was full, and reset that number.
+    ; Parameters:
+    ;   DE - Address of a 16-bit value to fill
+    .equ KB_CMD_GET_OVERFLOW, 1
     ; Number of commands above
-    .equ KB_CMD_COUNT, 1
+    .equ KB_CMD_COUNT, 2
 
 
     ; kb_mode_t: Modes supported by input/keyboard driver
@@ -59,6 +64,22 @@
     .equ KB_READ_NON_BLOCK, 1 << 2
 
 
+    ; kb_events_t: Can be ORed with KB_MODE_RAW and the blocking modes above
+    ; In raw mode, `read` fills the buffer with kb_event_t structures instead of bytes.
+    ; All the pending events that fit in the buffer are returned at once, the buffer
+    ; must be big enough for at least one event.
+    .equ KB_READ_EVENTS, 1 << 3
+
+    ; kb_event_t structure, filled by `read` when KB_READ_EVENTS is set
+    .equ kb_event_key_t, 0      ; Key pressed or released, same codes as in raw mode
+    .equ kb_event_state_t, 1    ; KB_EVENT_PRESSED or KB_EVENT_RELEASED
+    .equ kb_event_time_t, 2     ; Time the key was received at, in milliseconds, same clock as `gettime`
+    .equ kb_event_end_t, 4
+
+    .equ KB_EVENT_PRESSED, 0
+    .equ KB_EVENT_RELEASED, 1
+
+
     ; The following codes represent the keys of a 104-key keyboard that can be detected by
     ; the keyboard driver.
     ; When the input mode is set to RAW, the following keys can be sent to the
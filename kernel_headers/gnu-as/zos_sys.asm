@@ -96,7 +96,7 @@
     ;     char    c_def_disk;   // Upper case letter for the default disk
     ;     uint8_t c_max_driver; // Maximum number of driver loadable in the kernel
     ;     uint8_t c_max_dev;    // Maximum number of opened devices in the kernel
-    ;     uint8_t c_max_files;  // Maximum number of opened files in the kernel
+    ;     uint8_t c_max_files;  // Maximum number of opened files in the kernel, including the pool
     ;     uint16_t c_max_path;  // Maximum path length
     ;     void*    c_prog_addr; // Virtual address where user programs are loaded
     ;     char*    c_prog_path;  // Path to where user prog
@@ -54,8 +54,22 @@
     ; Resets the screen to the same state as on boot up
     .equ CMD_RESET_SCREEN, 7
 
+    ; Copy a rectangle of characters, and optionally their colors, to the screen, without
+    ; interpreting them and without moving the cursor. The coordinates are relative to the
+    ; visible screen.
+    ; Parameters:
+    ;   DE - Address of a blit_t structure (defined below). The structure and the buffers
+    ;        it points to must not cross a page boundary.
+    .equ CMD_BLIT, 8
+
+    ; Scroll the content of the screen by a number of lines, the lines revealed are cleared
+    ; and the cursor keeps its position on screen.
+    ; Parameters:
+    ;   E - Signed number of lines, positive to move the content up, negative to move it down
+    .equ CMD_SCROLL, 9
+
     ; Number of commands above
-    .equ CMD_COUNT, 8
+    .equ CMD_COUNT, 10
 
 
     ; List of colors to pass to CMD_SET_COLORS command.
@@ -83,3 +97,15 @@
     .equ area_height_t, 1  ; Height of the screen in the current mode
     .equ area_count_t,  2  ; Number of entities on-screen (usually, width * height)
     .equ area_end_t,    4
+
+
+    ; blit_t structure, used by the CMD_BLIT command
+    .equ blit_x_t,      0  ; Coordinates of the top-left corner of the rectangle
+    .equ blit_y_t,      1
+    .equ blit_w_t,      2  ; Width and height of the rectangle, not 0
+    .equ blit_h_t,      3
+    .equ blit_fill_t,   4  ; Character to fill the rectangle with when blit_chars_t is NULL
+    .equ blit_color_t,  5  ; Color to fill the rectangle with when blit_colors_t is NULL
+    .equ blit_chars_t,  6  ; w * h characters, row after row, or NULL
+    .equ blit_colors_t, 8  ; w * h colors, row after row, or NULL
+    .equ blit_end_t,    10
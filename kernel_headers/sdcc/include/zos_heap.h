@@ -0,0 +1,92 @@
+/* SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "zos_errors.h"
+#include "zos_sys.h"
+
+/**
+ * This header provides a heap allocator built on top of the `palloc`, `pfree` and `map`
+ * syscalls. The program gives the allocator one or more 16KB virtual windows it doesn't
+ * use, the allocator then maps RAM pages in these windows when it needs more memory and
+ * gives them back to the kernel as soon as they are completely free.
+ *
+ * Each page is divided in 1KB slabs. Allocations up to 512 bytes are served from slabs
+ * dedicated to a size class (8, 16, 32, ..., 512 bytes), bigger allocations get a run of
+ * contiguous slabs in a single page, so they are limited to 16KB.
+ *
+ * The implementation is provided as the `zos_heap` library, programs that use it must add
+ * `-l zos_heap` to their linker flags. It requires a kernel with MMU support.
+ */
+
+/**
+ * @brief Maximum number of virtual windows the heap can use.
+ */
+#define ZOS_HEAP_MAX_PAGES  3
+
+/**
+ * @brief Size of a virtual window/page, and size of the slabs it is divided in.
+ */
+#define ZOS_HEAP_PAGE_SIZE  0x4000
+#define ZOS_HEAP_SLAB_SIZE  1024
+
+/**
+ * @brief Biggest allocation served from a size class, bigger ones take whole slabs.
+ */
+#define ZOS_HEAP_SMALL_MAX  512
+
+
+/**
+ * @brief Usage statistics of the heap, can be retrieved with `heap_stats`.
+ */
+typedef struct {
+    uint8_t  h_pages;       // Number of pages currently allocated from the kernel
+    uint8_t  h_slabs;       // Number of slabs in use in these pages
+    uint8_t  h_largest_run; // Largest run of free slabs in a mapped page, biggest allocation
+                            // that can be served without allocating a new page
+    uint16_t h_allocs;      // Number of blocks currently allocated
+    uint16_t h_used;        // Bytes given to the program, rounded up to the size classes
+    uint16_t h_slab_bytes;  // Bytes in use slabs, `h_slab_bytes - h_used` is the memory lost
+                            // to internal fragmentation and free blocks
+} zos_heap_stats_t;
+
+
+/**
+ * @brief Initialize the heap with the virtual windows it can map pages in.
+ *        Any data in these windows will be hidden once the heap maps a page in them,
+ *        so they must not contain the program code, its data or its stack.
+ *
+ * @param window Virtual address of the first window, must be aligned on ZOS_HEAP_PAGE_SIZE.
+ * @param count Number of consecutive windows the heap can use, at most ZOS_HEAP_MAX_PAGES.
+ *
+ * @returns ERR_SUCCESS on success, ERR_INVALID_PARAMETER if a parameter is invalid.
+ */
+zos_err_t heap_init(void* window, uint8_t count);
+
+
+/**
+ * @brief Allocate a block of memory. The block is not initialized.
+ *
+ * @param size Size of the block in bytes.
+ *
+ * @returns Address of the block on success, NULL if the size is 0, bigger than a page,
+ *          or if no more memory is available.
+ */
+void* heap_alloc(uint16_t size);
+
+
+/**
+ * @brief Free a block allocated with `heap_alloc`. Does nothing if `ptr` is NULL.
+ *        When all the blocks of a page are free, the page is given back to the kernel.
+ */
+void heap_free(void* ptr);
+
+
+/**
+ * @brief Fill the given structure with the current heap statistics.
+ */
+void heap_stats(zos_heap_stats_t* stats);
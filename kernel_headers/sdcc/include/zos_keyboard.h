@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <stdint.h>
+
 /**
  * This file represents the keyboard interface for a key input driver.
  */
@@ -19,6 +21,12 @@ typedef enum {
      */
     KB_CMD_SET_MODE = 0,
 
+    /**
+     * Get the number of bytes received from the keyboard that were lost because the
+     * FIFO was full, and reset that number. The parameter is a uint16_t* to fill.
+     */
+    KB_CMD_GET_OVERFLOW,
+
     /* Number of commands */
     KB_CMD_COUNT
 } kb_cmd_t;
@@ -88,6 +96,27 @@ typedef enum {
 #define KB_READ_NON_BLOCK  (1 << 2)
 
 
+/**
+ * In raw mode, `read` fills the buffer with kb_event_t structures instead of bytes.
+ * All the pending events that fit in the buffer are returned at once, the buffer
+ * must be big enough for at least one event. Can be ORed with the flags above.
+ */
+#define KB_READ_EVENTS  (1 << 3)
+
+
+/**
+ * Structure filled by `read` when KB_READ_EVENTS is set.
+ */
+typedef struct {
+    uint8_t  key;   // Key pressed or released, same codes as in raw mode
+    uint8_t  state; // KB_EVENT_PRESSED or KB_EVENT_RELEASED
+    uint16_t time;  // Time the key was received at, in milliseconds, same clock as `gettime`
+} kb_event_t;
+
+#define KB_EVENT_PRESSED    0
+#define KB_EVENT_RELEASED   1
+
+
 /**
  * The following codes represent the keys of a 104-key keyboard that can be detected by
  * the keyboard driver.
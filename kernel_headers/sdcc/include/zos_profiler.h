@@ -0,0 +1,59 @@
+/* SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * This file represents the interface of the PC-sampling profiler driver, named "PROF".
+ * When sampling, the profiler records the address interrupted by each V-blank interrupt.
+ * The histogram can be read from the driver and symbolized on the host with `tools/zos_prof.py`.
+ */
+
+
+/**
+ * IOCTL commands for the profiler device.
+ */
+typedef enum {
+    /**
+     * Clear the histogram and start sampling. The histogram page is allocated if necessary.
+     */
+    PROF_CMD_START = 0,
+
+    /**
+     * Stop sampling, the histogram can still be read.
+     */
+    PROF_CMD_STOP,
+
+    /**
+     * Stop sampling and free the histogram page.
+     */
+    PROF_CMD_FREE,
+
+    /* Number of commands */
+    PROF_CMD_COUNT
+} prof_cmd_t;
+
+
+/**
+ * Layout of the histogram, as read from the driver. The counters saturate at 0xFFFF.
+ */
+#define PROF_BUCKET_SHIFT   4
+#define PROF_BUCKETS_COUNT  (0x10000 >> PROF_BUCKET_SHIFT)
+#define PROF_PAGES_COUNT    256
+
+typedef struct {
+    uint16_t magic;     /* "ZP" */
+    uint8_t  version;
+    uint8_t  shift;     /* log2 of the number of bytes covered by each bucket */
+    uint32_t samples;   /* Total number of samples */
+} prof_header_t;
+
+typedef struct {
+    uint16_t buckets[PROF_BUCKETS_COUNT];   /* Samples per block of the virtual address space */
+    uint16_t pages[PROF_PAGES_COUNT];       /* Samples per physical page */
+    prof_header_t header;
+} prof_dump_t;
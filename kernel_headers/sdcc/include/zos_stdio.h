@@ -0,0 +1,207 @@
+/* SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdarg.h>
+#include "zos_errors.h"
+#include "zos_vfs.h"
+
+/**
+ * This header provides a buffered stream layer on top of the `read` and `write` syscalls.
+ * Each stream owns a buffer so that small reads and writes are grouped together into a
+ * single syscall. The implementation is not part of `zos_crt0.rel`, it is provided as the
+ * `zos_stdio` library, programs that use it must add `-l zos_stdio` to their linker flags.
+ *
+ * Buffered data is only sent to the kernel when the buffer is full, when a new line is
+ * written to a line-buffered stream, or when `fflush`/`fclose` is called. Make sure to
+ * close or flush all the streams before exiting the program, else the pending data is lost.
+ */
+
+/**
+ * @brief Maximum number of streams that can be opened at the same time.
+ */
+#ifndef ZOS_FOPEN_MAX
+#define ZOS_FOPEN_MAX   4
+#endif
+
+/**
+ * @brief Size of the buffer attached to each stream by default, in bytes.
+ *        A different buffer (and size) can be provided with `setvbuf`.
+ */
+#ifndef ZOS_BUFSIZ
+#define ZOS_BUFSIZ      256
+#endif
+
+#ifndef EOF
+#define EOF             (-1)
+#endif
+
+/**
+ * @brief Buffering modes that can be passed to `setvbuf`
+ */
+#ifndef _IOFBF
+#define _IOFBF  0   // Fully buffered, data is sent when the buffer is full
+#define _IOLBF  1   // Line buffered, data is sent when a '\n' is written
+#define _IONBF  2   // Unbuffered, each operation results in a syscall
+#endif
+
+/**
+ * @brief Flags of a stream, can be retrieved with `ferror` and `feof`.
+ */
+#define ZOS_STREAM_USED     (1 << 0)
+#define ZOS_STREAM_READ     (1 << 1)
+#define ZOS_STREAM_WRITE    (1 << 2)
+#define ZOS_STREAM_EOF      (1 << 3)
+#define ZOS_STREAM_ERR      (1 << 4)
+#define ZOS_STREAM_DIRTY    (1 << 5)    // Buffer contains data to write
+#define ZOS_STREAM_OWN_DEV  (1 << 6)    // Device opened by `fopen`, closed by `fclose`
+
+
+/**
+ * @brief Structure representing an opened stream. Its fields must not be accessed directly.
+ */
+typedef struct {
+    zos_dev_t dev;
+    uint8_t   flags;
+    uint8_t   mode;     // _IOFBF, _IOLBF or _IONBF
+    uint8_t*  buf;
+    uint16_t  size;     // Size of the buffer
+    uint16_t  pos;      // Index of the next byte to read or to write in the buffer
+    uint16_t  len;      // Number of valid bytes in the buffer when reading
+    uint8_t   single;   // One-byte buffer used when the stream is unbuffered
+} zos_file_t;
+
+
+/**
+ * @brief Number of `read` and `write` syscalls issued by the streams so far. The program
+ *        can reset it to measure how many syscalls a sequence of operations costs.
+ */
+extern uint16_t zos_stdio_syscalls;
+
+
+/**
+ * @brief Open the given file and attach a stream to it.
+ *
+ * @param path Path to the file to open, same format as `open`.
+ * @param mode Opening mode, "r", "w" or "a", optionally followed by "+" (and "b", ignored).
+ *
+ * @returns A pointer to the stream on success, NULL if the file could not be opened or
+ *          if all the streams are already in use.
+ */
+zos_file_t* fopen(const char* path, const char* mode);
+
+
+/**
+ * @brief Attach a stream to a device that is already opened, such as `DEV_STDOUT`.
+ *        Streams attached to a driver are line-buffered by default. The device is not
+ *        closed by `fclose`.
+ *
+ * @param dev Opened device to attach the stream to.
+ * @param mode Same as `fopen`.
+ *
+ * @returns A pointer to the stream on success, NULL if all the streams are in use.
+ */
+zos_file_t* fdopen(zos_dev_t dev, const char* mode);
+
+
+/**
+ * @brief Flush and close the given stream. If the device was opened by `fopen`, it is closed.
+ *
+ * @returns 0 on success, EOF if an error occurred.
+ */
+int fclose(zos_file_t* stream);
+
+
+/**
+ * @brief Send the pending data of the given stream to the kernel.
+ *
+ * @param stream Stream to flush, NULL to flush all the opened streams.
+ *
+ * @returns 0 on success, EOF if an error occurred.
+ */
+int fflush(zos_file_t* stream);
+
+
+/**
+ * @brief Change the buffer and the buffering mode of a stream. Must be called before any
+ *        read or write on the stream.
+ *
+ * @param stream Stream to modify.
+ * @param buf New buffer to use, NULL to keep the current one.
+ * @param mode One of _IOFBF, _IOLBF or _IONBF.
+ * @param size Size of `buf` in bytes, ignored if `buf` is NULL.
+ *
+ * @returns 0 on success, non-zero value else.
+ */
+int setvbuf(zos_file_t* stream, char* buf, int mode, uint16_t size);
+
+
+/**
+ * @brief Read `count` elements of `size` bytes from the stream.
+ *
+ * @returns The number of complete elements read, which is less than `count` on error or
+ *          end of file.
+ */
+uint16_t fread(void* ptr, uint16_t size, uint16_t count, zos_file_t* stream);
+
+
+/**
+ * @brief Write `count` elements of `size` bytes to the stream.
+ *
+ * @returns The number of complete elements written.
+ */
+uint16_t fwrite(const void* ptr, uint16_t size, uint16_t count, zos_file_t* stream);
+
+
+/**
+ * @brief Read a single byte from the stream.
+ *
+ * @returns The byte read, as an unsigned char, or EOF on error or end of file.
+ */
+int fgetc(zos_file_t* stream);
+
+
+/**
+ * @brief Write a single byte to the stream.
+ *
+ * @returns The byte written on success, EOF else.
+ */
+int fputc(int c, zos_file_t* stream);
+
+
+/**
+ * @brief Read a line from the stream, including the final '\n', and NULL-terminate it.
+ *        At most `size - 1` characters are read.
+ *
+ * @returns `s` on success, NULL if no character could be read.
+ */
+char* fgets(char* s, int size, zos_file_t* stream);
+
+
+/**
+ * @brief Write a NULL-terminated string to the stream.
+ *
+ * @returns A non-negative value on success, EOF else.
+ */
+int fputs(const char* s, zos_file_t* stream);
+
+
+/**
+ * @brief Formatted output to the stream, same format as SDCC's `printf`.
+ *
+ * @returns Number of characters written.
+ */
+int fprintf(zos_file_t* stream, const char* format, ...);
+int vfprintf(zos_file_t* stream, const char* format, va_list ap);
+
+
+/**
+ * @brief Check the end-of-file and error indicators of the stream.
+ */
+#define feof(stream)    (((stream)->flags & ZOS_STREAM_EOF) != 0)
+#define ferror(stream)  (((stream)->flags & ZOS_STREAM_ERR) != 0)
+#define clearerr(stream) ((stream)->flags &= ~(ZOS_STREAM_EOF | ZOS_STREAM_ERR))
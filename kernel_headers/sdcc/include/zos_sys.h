@@ -39,7 +39,7 @@ typedef struct {
     char     c_def_disk;   // Upper case letter for the default disk
     uint8_t  c_max_driver; // Maximum number of driver loadable in the kernel
     uint8_t  c_max_dev;    // Maximum number of opened devices in the kernel
-    uint8_t  c_max_files;  // Maximum number of opened files in the kernel
+    uint8_t  c_max_files;  // Maximum number of opened files in the kernel, including the pool
     uint16_t c_max_path;   // Maximum path length
     void*    c_prog_addr;  // Virtual address where user programs are loaded
     char*    c_prog_path;  // Path to where user prog
@@ -51,9 +51,40 @@ typedef struct {
  */
 typedef enum zos_exec_mode_t {
     EXEC_OVERRIDE_PROGRAM = 0,
-    EXEC_PRESERVE_PROGRAM = 1
+    EXEC_PRESERVE_PROGRAM = 1,
+    EXEC_BACKGROUND_PROGRAM = 2,  // Only available when the kernel supports background jobs
 } zos_exec_mode_t;
 
+/**
+ * @brief Statistics of a job, filled by `jobstat`
+ */
+typedef struct {
+    uint8_t  j_state;     // 0 if the job doesn't exist, non-zero else
+    uint16_t j_slices;    // Number of times the job was scheduled
+    uint32_t j_cpu;       // CPU time spent in the job, in milliseconds (0 if no timer is available)
+    char     j_name[16];  // Name of the job, not NULL-terminated if it is 16 characters long
+} zos_job_stat_t;
+
+/**
+ * @brief Descriptor of an operation executed by `batch`. The fields are the values
+ *        of the registers given to the syscall, refer to the assembly documentation of
+ *        each syscall for the meaning of each register.
+ */
+typedef struct {
+    uint8_t  b_op;      // Syscall number, from read (0) to mount (14)
+    uint8_t  b_h;       // Value of register H (dev, flags for open, ...)
+    uint8_t  b_a;       // Value of register A (whence for seek)
+    uint8_t  b_ret;     // Filled with the value returned in A
+    uint16_t b_de;      // Value of register DE (buffer)
+    uint16_t b_bc;      // Value of register BC (size, path), filled with BC for read and write
+    uint32_t b_off;     // Offset for seek (BCDE), filled with the new offset
+} zos_batch_t;
+
+/**
+ * @brief Flag for `batch`, stop at the first operation that fails
+ */
+#define BATCH_STOP_ON_ERROR 1
+
 /**
  * @brief Exit the program and give back the hand to the kernel. If the caller
  *        program invoked `exec()` with `EXEC_PRESERVE_PROGRAM` as the mode,
@@ -72,6 +103,9 @@ void exit(uint8_t retval) CALL_CONV;
  *        until the sub-program finishes executing, or, it can be covered/overridden.
  *        In the first case, upon return, when not NULL, retval is filled with the return value
  *        of the sub-program.
+ *        With `EXEC_BACKGROUND_PROGRAM`, the program is started in a new background job and
+ *        the caller continues its execution as soon as the new job blocks or yields. In that
+ *        case, retval is filled with the index of the new job.
  *        The depth of sub-programs is defined and limited in the kernel. As such, it is not
  *        guaranteed that it will always be possible to execute a sub-program while keeping
  *        the current one in memory. It depends on the target and kernel configuration.
@@ -158,6 +192,46 @@ zos_err_t pfree(uint8_t page_index) CALL_CONV;
 zos_err_t pmap(uint8_t page_index, const void* vaddr) CALL_CONV;
 
 
+/**
+ * @brief Give the CPU to the next background job ready to run, if any. The current
+ *        program continues its execution the next time it is scheduled.
+ *
+ * @returns ERR_SUCCESS
+ */
+zos_err_t yield(void) CALL_CONV;
+
+
+/**
+ * @brief Get the statistics of a job. Job 0 is the foreground job.
+ *
+ * @param id Index of the job.
+ * @param stat Structure to fill with the statistics of the job.
+ *
+ * @returns ERR_SUCCESS on success,
+ *          ERR_INVALID_PARAMETER if the index is out of range,
+ *          ERR_NO_SUCH_ENTRY if the job doesn't exist,
+ *          ERR_NOT_SUPPORTED if the kernel doesn't support background jobs
+ */
+zos_err_t jobstat(uint8_t id, zos_job_stat_t* stat) CALL_CONV;
+
+
+/**
+ * @brief Execute several file and directory operations in a single syscall.
+ *        The result of each operation is written back in its descriptor.
+ *        This saves the cost of entering the kernel for each small read, write,
+ *        seek or stat.
+ *
+ * @param count Number of descriptors in the array.
+ * @param ops Array of descriptors, must not cross a 16KB page boundary.
+ * @param flags BATCH_STOP_ON_ERROR to stop at the first operation that fails, 0 else.
+ *
+ * @returns ERR_SUCCESS if all the operations succeeded, error of the first operation
+ *          that failed else. The descriptors after the failing one are not modified
+ *          when BATCH_STOP_ON_ERROR is given.
+ */
+zos_err_t batch(uint8_t count, zos_batch_t* ops, uint8_t flags) CALL_CONV;
+
+
 /**
  * @brief Get a read-only pointer to the kernel configuration.
  *
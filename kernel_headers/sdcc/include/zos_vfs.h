@@ -234,6 +234,23 @@ zos_err_t stat(const char* path, zos_stat_t* stat) CALL_CONV;
 zos_err_t seek(zos_dev_t dev, int32_t* offset, zos_whence_t whence) CALL_CONV;
 
 
+/**
+ * @brief Reserve room on the disk for an opened file, before writing to it.
+ *        The following writes, up to the given size, won't need to allocate any
+ *        space on the disk. When the file system supports it, the space is reserved
+ *        as a contiguous area if possible.
+ *        If the given size is smaller than the file size, the file is truncated.
+ *        Else, the file size is not modified.
+ *
+ * @param dev Opened file dev, it must have been opened with write flags.
+ * @param size Number of bytes to reserve for the file.
+ *
+ * @returns ERR_SUCCESS on success, ERR_NOT_SUPPORTED if the file system doesn't
+ *          support it, error code else.
+ */
+zos_err_t preallocate(zos_dev_t dev, uint32_t size) CALL_CONV;
+
+
 /**
  * @brief Perform an input/output operation on an opened driver.
  *        The command and parameter are specific to the device drivers of
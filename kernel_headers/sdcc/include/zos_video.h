@@ -42,6 +42,16 @@ typedef enum {
     /* Resets the screen to the same state as on boot up */
     CMD_RESET_SCREEN, 
 
+    /* Copy a rectangle of characters, and optionally their colors, to the screen, without
+     * interpreting them and without moving the cursor. The parameter is zos_text_blit_t*,
+     * the coordinates are relative to the visible screen. */
+    CMD_BLIT,
+
+    /* Scroll the content of the screen by a number of lines, the parameter is a signed
+     * 8-bit value: positive to move the content up, negative to move it down. The lines
+     * revealed are cleared and the cursor keeps its position on screen. */
+    CMD_SCROLL,
+
     CMD_COUNT
 } zos_video_cmd_t;
 
@@ -72,3 +82,16 @@ typedef struct
     uint8_t  height; // Maximum number of characters on one column
     uint16_t count;  // Number of entities on screen
 } zos_text_area_t;
+
+
+typedef struct
+{
+    uint8_t  x;         // Top-left corner of the rectangle
+    uint8_t  y;
+    uint8_t  width;     // Size of the rectangle, not 0
+    uint8_t  height;
+    uint8_t  fill;      // Character to fill the rectangle with when `chars` is NULL
+    uint8_t  color;     // Color to fill the rectangle with when `colors` is NULL, (bg << 4) | fg
+    const char*    chars;   // width * height characters, row after row, or NULL
+    const uint8_t* colors;  // width * height colors, row after row, or NULL
+} zos_text_blit_t;
@@ -560,6 +560,67 @@ _pmap:
     ret
 
 
+    ; zos_err_t yield(void);
+    .globl _yield
+_yield:
+    syscall 27
+    ret
+
+
+    ; zos_err_t jobstat(uint8_t id, zos_job_stat_t* stat);
+    ; Parameters:
+    ;   A - id
+    ;   DE - stat
+    .globl _jobstat
+_jobstat:
+    ; Syscall parameters:
+    ;   H - Index of the job
+    ;   DE - Structure to fill
+    ld h, a
+    syscall 28
+    ret
+
+
+    ; zos_err_t batch(uint8_t count, zos_batch_t* ops, uint8_t flags);
+    ; Parameters:
+    ;   A - count
+    ;   DE - ops
+    ;   [Stack] - flags
+    .globl _batch
+_batch:
+    ; Pop the return address and exchange it with the flags
+    pop hl
+    dec sp
+    ex (sp), hl
+    ; Syscall parameters:
+    ;   DE - Array of descriptors
+    ;   B - Number of descriptors
+    ;   C - Flags
+    ld b, a
+    ld c, h
+    syscall 29
+    ret
+
+
+    ; zos_err_t preallocate(zos_dev_t dev, uint32_t size);
+    ; Parameters:
+    ;   A - dev
+    ;   [Stack] - size
+    .globl _preallocate
+_preallocate:
+    ; Pop the return address and the size from the stack
+    pop hl
+    pop de
+    pop bc
+    push hl
+    ; Syscall parameters:
+    ;   H - Dev number, must refer to a file opened with write flags
+    ;   BCDE - 32-bit size to reserve
+    ld h, a
+    syscall 30
+    ret
+
+
     ; int getchar(void)
     ; Get next character from standard input. Input is buffered.
     ; Returns:
@@ -0,0 +1,310 @@
+/* SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "zos_heap.h"
+
+#define SLABS_PER_PAGE  (ZOS_HEAP_PAGE_SIZE / ZOS_HEAP_SLAB_SIZE)
+#define MAX_SLABS       (ZOS_HEAP_MAX_PAGES * SLABS_PER_PAGE)
+
+/* Size classes go from 8 (1 << 3) to 512 (1 << 9) bytes */
+#define CLASS_SHIFT     3
+#define CLASS_COUNT     7
+
+/* Values of `s_slab_class` for the slabs that are not part of a size class */
+#define SLAB_FREE       0xff
+#define SLAB_LARGE      0xfe    // First slab of a large allocation
+#define SLAB_CONT       0xfd    // Following slabs of a large allocation
+
+#define NO_SLAB         0xff
+
+/**
+ * All the metadata are kept outside of the slabs, so that the whole slab is usable and a
+ * block address is enough to find its slab. Free blocks of a slab are linked together,
+ * blocks that have never been allocated are counted in `s_slab_fresh` instead, this saves
+ * building the free list when a slab is created.
+ */
+static uint8_t* s_base;
+static uint8_t  s_count;
+static uint8_t  s_page[ZOS_HEAP_MAX_PAGES];    // Page index returned by palloc
+static uint8_t  s_mapped[ZOS_HEAP_MAX_PAGES];
+static uint8_t  s_page_used[ZOS_HEAP_MAX_PAGES]; // Number of slabs used in the page
+
+static uint8_t  s_slab_class[MAX_SLABS];    // Size class, or one of the SLAB_* values above
+static uint8_t  s_slab_used[MAX_SLABS];     // Blocks allocated, or slab count for SLAB_LARGE
+static uint8_t  s_slab_fresh[MAX_SLABS];    // Blocks never allocated, at the end of the slab
+static uint8_t  s_slab_next[MAX_SLABS];     // Next slab of the same class with free blocks
+static void*    s_slab_free[MAX_SLABS];     // List of freed blocks
+
+static uint8_t  s_class_head[CLASS_COUNT];  // Slabs that have at least one free block
+
+static uint16_t s_allocs;
+static uint16_t s_used;
+
+
+zos_err_t heap_init(void* window, uint8_t count)
+{
+    uint8_t i;
+    if (count == 0 || count > ZOS_HEAP_MAX_PAGES || ((uint16_t) window & (ZOS_HEAP_PAGE_SIZE - 1))) {
+        return ERR_INVALID_PARAMETER;
+    }
+    s_base  = (uint8_t*) window;
+    s_count = count;
+    for (i = 0; i < ZOS_HEAP_MAX_PAGES; i++) {
+        s_mapped[i] = 0;
+    }
+    for (i = 0; i < MAX_SLABS; i++) {
+        s_slab_class[i] = SLAB_FREE;
+    }
+    for (i = 0; i < CLASS_COUNT; i++) {
+        s_class_head[i] = NO_SLAB;
+    }
+    s_allocs = 0;
+    s_used = 0;
+    return ERR_SUCCESS;
+}
+
+
+static inline uint8_t* slab_addr(uint8_t slab)
+{
+    return s_base + (uint16_t) slab * ZOS_HEAP_SLAB_SIZE;
+}
+
+
+/**
+ * Look for `count` contiguous free slabs in the given mapped page.
+ */
+static uint8_t page_find_run(uint8_t page, uint8_t count)
+{
+    const uint8_t first = page * SLABS_PER_PAGE;
+    uint8_t run = 0;
+    uint8_t i;
+    for (i = 0; i < SLABS_PER_PAGE; i++) {
+        if (s_slab_class[first + i] != SLAB_FREE) {
+            run = 0;
+        } else if (++run == count) {
+            return first + i + 1 - count;
+        }
+    }
+    return NO_SLAB;
+}
+
+
+/**
+ * Reserve `count` contiguous slabs, map a new page from the kernel if none of the mapped
+ * pages has enough room. The slabs are marked as SLAB_LARGE/SLAB_CONT.
+ */
+static uint8_t slab_take(uint8_t count)
+{
+    uint8_t page;
+    uint8_t slab = NO_SLAB;
+    uint8_t i;
+
+    for (page = 0; page < s_count; page++) {
+        if (s_mapped[page]) {
+            slab = page_find_run(page, count);
+            if (slab != NO_SLAB) {
+                break;
+            }
+        }
+    }
+
+    if (slab == NO_SLAB) {
+        for (page = 0; page < s_count && s_mapped[page]; page++) {
+        }
+        if (page == s_count || palloc(&s_page[page]) != ERR_SUCCESS) {
+            return NO_SLAB;
+        }
+        if (pmap(s_page[page], s_base + (uint16_t) page * ZOS_HEAP_PAGE_SIZE) != ERR_SUCCESS) {
+            pfree(s_page[page]);
+            return NO_SLAB;
+        }
+        s_mapped[page] = 1;
+        s_page_used[page] = 0;
+        slab = page * SLABS_PER_PAGE;
+    }
+
+    s_page_used[page] += count;
+    s_slab_class[slab] = SLAB_LARGE;
+    s_slab_used[slab] = count;
+    for (i = 1; i < count; i++) {
+        s_slab_class[slab + i] = SLAB_CONT;
+    }
+    return slab;
+}
+
+
+/**
+ * Give back `count` slabs starting at `slab`, the page is returned to the kernel
+ * if it doesn't contain any used slab anymore.
+ */
+static void slab_release(uint8_t slab, uint8_t count)
+{
+    const uint8_t page = slab / SLABS_PER_PAGE;
+    uint8_t i;
+    for (i = 0; i < count; i++) {
+        s_slab_class[slab + i] = SLAB_FREE;
+    }
+    s_page_used[page] -= count;
+    if (s_page_used[page] == 0) {
+        /* The window still maps the freed page until a new one is mapped, it is
+         * never accessed in the meantime since no block belongs to it. */
+        pfree(s_page[page]);
+        s_mapped[page] = 0;
+    }
+}
+
+
+static void* heap_alloc_large(uint16_t size)
+{
+    uint8_t count;
+    uint8_t slab;
+
+    if (size > ZOS_HEAP_PAGE_SIZE) {
+        return NULL;
+    }
+    /* Round up to a number of slabs, a large allocation cannot span several pages */
+    count = (size + (ZOS_HEAP_SLAB_SIZE - 1)) / ZOS_HEAP_SLAB_SIZE;
+    slab = slab_take(count);
+    if (slab == NO_SLAB) {
+        return NULL;
+    }
+    s_allocs++;
+    s_used += (uint16_t) count * ZOS_HEAP_SLAB_SIZE;
+    return slab_addr(slab);
+}
+
+
+void* heap_alloc(uint16_t size)
+{
+    uint8_t cls = 0;
+    uint8_t slab;
+    uint16_t block_size = 1 << CLASS_SHIFT;
+    uint8_t* block;
+
+    if (size == 0) {
+        return NULL;
+    }
+    if (size > ZOS_HEAP_SMALL_MAX) {
+        return heap_alloc_large(size);
+    }
+
+    while (block_size < size) {
+        block_size <<= 1;
+        cls++;
+    }
+
+    slab = s_class_head[cls];
+    if (slab == NO_SLAB) {
+        slab = slab_take(1);
+        if (slab == NO_SLAB) {
+            return NULL;
+        }
+        s_slab_class[slab] = cls;
+        s_slab_used[slab] = 0;
+        s_slab_fresh[slab] = ZOS_HEAP_SLAB_SIZE / block_size;
+        s_slab_free[slab] = NULL;
+        s_slab_next[slab] = NO_SLAB;
+        s_class_head[cls] = slab;
+    }
+
+    block = s_slab_free[slab];
+    if (block != NULL) {
+        s_slab_free[slab] = *((void**) block);
+    } else {
+        /* Fresh blocks are handed out from the end of the slab */
+        block = slab_addr(slab) + (uint16_t) (--s_slab_fresh[slab]) * block_size;
+    }
+    s_slab_used[slab]++;
+
+    /* The slab is full, remove it from the list of its class, it is always the head */
+    if (s_slab_free[slab] == NULL && s_slab_fresh[slab] == 0) {
+        s_class_head[cls] = s_slab_next[slab];
+    }
+
+    s_allocs++;
+    s_used += block_size;
+    return block;
+}
+
+
+static void class_remove(uint8_t cls, uint8_t slab)
+{
+    uint8_t* prev = &s_class_head[cls];
+    while (*prev != slab) {
+        prev = &s_slab_next[*prev];
+    }
+    *prev = s_slab_next[slab];
+}
+
+
+void heap_free(void* ptr)
+{
+    const uint16_t offset = (uint8_t*) ptr - s_base;
+    uint8_t slab;
+    uint8_t cls;
+    uint16_t block_size;
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    slab = offset / ZOS_HEAP_SLAB_SIZE;
+    cls = s_slab_class[slab];
+    s_allocs--;
+
+    if (cls == SLAB_LARGE) {
+        s_used -= (uint16_t) s_slab_used[slab] * ZOS_HEAP_SLAB_SIZE;
+        slab_release(slab, s_slab_used[slab]);
+        return;
+    }
+
+    block_size = 1 << (cls + CLASS_SHIFT);
+    s_used -= block_size;
+
+    /* A full slab is not part of its class list, add it back since it now has a free block */
+    if (s_slab_free[slab] == NULL && s_slab_fresh[slab] == 0) {
+        s_slab_next[slab] = s_class_head[cls];
+        s_class_head[cls] = slab;
+    }
+    *((void**) ptr) = s_slab_free[slab];
+    s_slab_free[slab] = ptr;
+
+    if (--s_slab_used[slab] == 0) {
+        class_remove(cls, slab);
+        slab_release(slab, 1);
+    }
+}
+
+
+void heap_stats(zos_heap_stats_t* stats)
+{
+    uint8_t page;
+    uint8_t slab;
+    uint8_t run;
+
+    stats->h_pages = 0;
+    stats->h_slabs = 0;
+    stats->h_largest_run = 0;
+    stats->h_allocs = s_allocs;
+    stats->h_used = s_used;
+
+    for (page = 0; page < s_count; page++) {
+        if (!s_mapped[page]) {
+            continue;
+        }
+        stats->h_pages++;
+        stats->h_slabs += s_page_used[page];
+        run = 0;
+        for (slab = page * SLABS_PER_PAGE; slab < (page + 1) * SLABS_PER_PAGE; slab++) {
+            run = (s_slab_class[slab] == SLAB_FREE) ? run + 1 : 0;
+            if (run > stats->h_largest_run) {
+                stats->h_largest_run = run;
+            }
+        }
+    }
+    stats->h_slab_bytes = (uint16_t) stats->h_slabs * ZOS_HEAP_SLAB_SIZE;
+}
@@ -0,0 +1,453 @@
+/* SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "zos_stdio.h"
+
+/**
+ * Streams and their default buffers are statically allocated, there is no heap in the
+ * user programs. A stream that has been given a buffer by `setvbuf` keeps its static
+ * buffer unused.
+ */
+static zos_file_t s_streams[ZOS_FOPEN_MAX];
+static uint8_t s_buffers[ZOS_FOPEN_MAX][ZOS_BUFSIZ];
+
+uint16_t zos_stdio_syscalls;
+
+
+static zos_file_t* stream_alloc(zos_dev_t dev, uint8_t flags)
+{
+    uint8_t i;
+    for (i = 0; i < ZOS_FOPEN_MAX; i++) {
+        zos_file_t* stream = &s_streams[i];
+        if ((stream->flags & ZOS_STREAM_USED) == 0) {
+            stream->dev   = dev;
+            stream->flags = flags | ZOS_STREAM_USED;
+            stream->mode  = _IOFBF;
+            stream->buf   = s_buffers[i];
+            stream->size  = ZOS_BUFSIZ;
+            stream->pos   = 0;
+            stream->len   = 0;
+            return stream;
+        }
+    }
+    return NULL;
+}
+
+
+/**
+ * Parse the `fopen` mode string. Returns the stream flags, the `open` flags are stored
+ * in `oflags`. Returns 0 if the mode is invalid.
+ */
+static uint8_t parse_mode(const char* mode, uint8_t* oflags)
+{
+    uint8_t flags;
+    switch (*mode++) {
+        case 'r':
+            flags = ZOS_STREAM_READ;
+            *oflags = O_RDONLY;
+            break;
+        case 'w':
+            flags = ZOS_STREAM_WRITE;
+            *oflags = O_WRONLY | O_CREAT | O_TRUNC;
+            break;
+        case 'a':
+            flags = ZOS_STREAM_WRITE;
+            *oflags = O_WRONLY | O_CREAT | O_APPEND;
+            break;
+        default:
+            return 0;
+    }
+    for (; *mode; mode++) {
+        if (*mode == '+') {
+            flags = ZOS_STREAM_READ | ZOS_STREAM_WRITE;
+            *oflags = (*oflags & ~O_WRONLY) | O_RDWR;
+        }
+    }
+    return flags;
+}
+
+
+zos_file_t* fopen(const char* path, const char* mode)
+{
+    uint8_t oflags;
+    zos_file_t* stream;
+    zos_dev_t dev;
+    const uint8_t flags = parse_mode(mode, &oflags);
+
+    if (flags == 0) {
+        return NULL;
+    }
+    /* Look for a free stream before opening the file to not leak a device */
+    stream = stream_alloc(0, flags | ZOS_STREAM_OWN_DEV);
+    if (stream == NULL) {
+        return NULL;
+    }
+    dev = open(path, oflags);
+    if (dev < 0) {
+        stream->flags = 0;
+        return NULL;
+    }
+    stream->dev = dev;
+    return stream;
+}
+
+
+zos_file_t* fdopen(zos_dev_t dev, const char* mode)
+{
+    uint8_t oflags;
+    zos_file_t* stream;
+    const uint8_t flags = parse_mode(mode, &oflags);
+
+    if (flags == 0) {
+        return NULL;
+    }
+    stream = stream_alloc(dev, flags);
+    if (stream != NULL) {
+        /* Drivers are usually interactive (video, UART), flush on each new line */
+        stream->mode = _IOLBF;
+    }
+    return stream;
+}
+
+
+/**
+ * Send the pending bytes to the kernel. `write` may not write everything at once,
+ * so loop until the buffer is empty.
+ */
+static int stream_flush_write(zos_file_t* stream)
+{
+    uint16_t done = 0;
+    while (done < stream->pos) {
+        uint16_t size = stream->pos - done;
+        zos_stdio_syscalls++;
+        if (write(stream->dev, stream->buf + done, &size) != ERR_SUCCESS || size == 0) {
+            stream->flags |= ZOS_STREAM_ERR;
+            return EOF;
+        }
+        done += size;
+    }
+    stream->pos = 0;
+    stream->flags &= ~ZOS_STREAM_DIRTY;
+    return 0;
+}
+
+
+/**
+ * Drop the read-ahead data. The cursor of the device is ahead of the stream's cursor,
+ * seek back over the bytes that were not consumed by the program yet.
+ */
+static int stream_drop_read(zos_file_t* stream)
+{
+    const uint16_t unread = stream->len - stream->pos;
+    stream->pos = 0;
+    stream->len = 0;
+    if (unread != 0) {
+        int32_t offset = -((int32_t) unread);
+        if (seek(stream->dev, &offset, SEEK_CUR) != ERR_SUCCESS) {
+            stream->flags |= ZOS_STREAM_ERR;
+            return EOF;
+        }
+    }
+    return 0;
+}
+
+
+int fflush(zos_file_t* stream)
+{
+    if (stream == NULL) {
+        int ret = 0;
+        uint8_t i;
+        for (i = 0; i < ZOS_FOPEN_MAX; i++) {
+            if ((s_streams[i].flags & ZOS_STREAM_USED) && fflush(&s_streams[i]) != 0) {
+                ret = EOF;
+            }
+        }
+        return ret;
+    }
+
+    if (stream->flags & ZOS_STREAM_DIRTY) {
+        return stream_flush_write(stream);
+    }
+    if (stream->len != 0) {
+        return stream_drop_read(stream);
+    }
+    return 0;
+}
+
+
+int fclose(zos_file_t* stream)
+{
+    int ret = fflush(stream);
+    if ((stream->flags & ZOS_STREAM_OWN_DEV) && close(stream->dev) != ERR_SUCCESS) {
+        ret = EOF;
+    }
+    stream->flags = 0;
+    return ret;
+}
+
+
+int setvbuf(zos_file_t* stream, char* buf, int mode, uint16_t size)
+{
+    if (mode > _IONBF || stream->pos != 0 || stream->len != 0) {
+        return -1;
+    }
+    stream->mode = mode;
+    if (mode == _IONBF) {
+        stream->buf  = &stream->single;
+        stream->size = 1;
+    } else if (buf != NULL && size != 0) {
+        stream->buf  = (uint8_t*) buf;
+        stream->size = size;
+    }
+    return 0;
+}
+
+
+/**
+ * Prepare the stream for a write: drop any read-ahead data first.
+ */
+static int stream_to_write(zos_file_t* stream)
+{
+    if ((stream->flags & ZOS_STREAM_WRITE) == 0) {
+        stream->flags |= ZOS_STREAM_ERR;
+        return EOF;
+    }
+    if (stream->len != 0) {
+        return stream_drop_read(stream);
+    }
+    return 0;
+}
+
+
+/**
+ * Prepare the stream for a read: flush any pending data first.
+ */
+static int stream_to_read(zos_file_t* stream)
+{
+    if ((stream->flags & ZOS_STREAM_READ) == 0) {
+        stream->flags |= ZOS_STREAM_ERR;
+        return EOF;
+    }
+    if (stream->flags & ZOS_STREAM_DIRTY) {
+        return stream_flush_write(stream);
+    }
+    return 0;
+}
+
+
+/**
+ * Refill the buffer with a single `read` syscall. Returns the number of bytes now
+ * available, 0 on end of file or error.
+ */
+static uint16_t stream_fill(zos_file_t* stream)
+{
+    uint16_t size = stream->size;
+    stream->pos = 0;
+    stream->len = 0;
+    zos_stdio_syscalls++;
+    if (read(stream->dev, stream->buf, &size) != ERR_SUCCESS) {
+        stream->flags |= ZOS_STREAM_ERR;
+        return 0;
+    }
+    if (size == 0) {
+        stream->flags |= ZOS_STREAM_EOF;
+    }
+    stream->len = size;
+    return size;
+}
+
+
+int fgetc(zos_file_t* stream)
+{
+    /* `pos` and `len` describe the write buffer while it is dirty, flush it first */
+    if ((stream->flags & ZOS_STREAM_DIRTY) && stream_to_read(stream) != 0) {
+        return EOF;
+    }
+    if (stream->pos == stream->len) {
+        if (stream_to_read(stream) != 0 || stream_fill(stream) == 0) {
+            return EOF;
+        }
+    }
+    return stream->buf[stream->pos++];
+}
+
+
+int fputc(int c, zos_file_t* stream)
+{
+    if ((stream->flags & ZOS_STREAM_DIRTY) == 0 && stream_to_write(stream) != 0) {
+        return EOF;
+    }
+    stream->buf[stream->pos++] = (uint8_t) c;
+    stream->flags |= ZOS_STREAM_DIRTY;
+    if (stream->pos == stream->size || (stream->mode == _IOLBF && c == '\n')) {
+        if (stream_flush_write(stream) != 0) {
+            return EOF;
+        }
+    }
+    return (uint8_t) c;
+}
+
+
+uint16_t fread(void* ptr, uint16_t size, uint16_t count, zos_file_t* stream)
+{
+    uint8_t* dst = (uint8_t*) ptr;
+    const uint16_t total = size * count;
+    uint16_t remaining = total;
+
+    if (total == 0) {
+        return 0;
+    }
+    if ((stream->flags & ZOS_STREAM_DIRTY) && stream_to_read(stream) != 0) {
+        return 0;
+    }
+
+    while (remaining != 0) {
+        uint16_t avail = stream->len - stream->pos;
+        if (avail != 0) {
+            if (avail > remaining) {
+                avail = remaining;
+            }
+            memcpy(dst, stream->buf + stream->pos, avail);
+            stream->pos += avail;
+            dst += avail;
+            remaining -= avail;
+        } else if (stream_to_read(stream) != 0) {
+            break;
+        } else if (remaining >= stream->size) {
+            /* Big request: read directly into the destination, the buffer would only add
+             * a copy. Don't cross a 16KB virtual page boundary in a single syscall. */
+            uint16_t chunk = 0x4000 - ((uint16_t) dst & 0x3fff);
+            if (chunk > remaining) {
+                chunk = remaining;
+            }
+            zos_stdio_syscalls++;
+            if (read(stream->dev, dst, &chunk) != ERR_SUCCESS) {
+                stream->flags |= ZOS_STREAM_ERR;
+                break;
+            }
+            if (chunk == 0) {
+                stream->flags |= ZOS_STREAM_EOF;
+                break;
+            }
+            dst += chunk;
+            remaining -= chunk;
+        } else if (stream_fill(stream) == 0) {
+            break;
+        }
+    }
+
+    return (total - remaining) / size;
+}
+
+
+uint16_t fwrite(const void* ptr, uint16_t size, uint16_t count, zos_file_t* stream)
+{
+    const uint8_t* src = (const uint8_t*) ptr;
+    const uint16_t total = size * count;
+    uint16_t remaining = total;
+
+    if (total == 0) {
+        return 0;
+    }
+    if ((stream->flags & ZOS_STREAM_DIRTY) == 0 && stream_to_write(stream) != 0) {
+        return 0;
+    }
+
+    /* Line-buffered streams go through `fputc` to catch the new lines */
+    if (stream->mode == _IOLBF) {
+        while (remaining != 0 && fputc(*src++, stream) != EOF) {
+            remaining--;
+        }
+        return (total - remaining) / size;
+    }
+
+    while (remaining != 0) {
+        uint16_t room = stream->size - stream->pos;
+        if (stream->pos == 0 && remaining >= stream->size) {
+            /* Nothing pending and the data would fill the buffer anyway: write it directly */
+            uint16_t chunk = 0x4000 - ((uint16_t) src & 0x3fff);
+            if (chunk > remaining) {
+                chunk = remaining;
+            }
+            zos_stdio_syscalls++;
+            if (write(stream->dev, src, &chunk) != ERR_SUCCESS || chunk == 0) {
+                stream->flags |= ZOS_STREAM_ERR;
+                break;
+            }
+            src += chunk;
+            remaining -= chunk;
+            continue;
+        }
+        if (room > remaining) {
+            room = remaining;
+        }
+        memcpy(stream->buf + stream->pos, src, room);
+        stream->pos += room;
+        stream->flags |= ZOS_STREAM_DIRTY;
+        src += room;
+        remaining -= room;
+        if (stream->pos == stream->size && stream_flush_write(stream) != 0) {
+            break;
+        }
+    }
+
+    return (total - remaining) / size;
+}
+
+
+char* fgets(char* s, int size, zos_file_t* stream)
+{
+    char* dst = s;
+    int c = 0;
+
+    if (size <= 0) {
+        return NULL;
+    }
+    while (--size > 0 && c != '\n') {
+        c = fgetc(stream);
+        if (c == EOF) {
+            break;
+        }
+        *dst++ = (char) c;
+    }
+    if (dst == s) {
+        return NULL;
+    }
+    *dst = 0;
+    return s;
+}
+
+
+int fputs(const char* s, zos_file_t* stream)
+{
+    const uint16_t len = strlen(s);
+    return fwrite(s, 1, len, stream) == len ? 0 : EOF;
+}
+
+
+static void stream_putc(char c, void* stream) __reentrant
+{
+    fputc(c, (zos_file_t*) stream);
+}
+
+
+int vfprintf(zos_file_t* stream, const char* format, va_list ap)
+{
+    return _print_format(stream_putc, stream, format, ap);
+}
+
+
+int fprintf(zos_file_t* stream, const char* format, ...)
+{
+    int ret;
+    va_list ap;
+    va_start(ap, format);
+    ret = vfprintf(stream, format, ap);
+    va_end(ap);
+    return ret;
+}
@@ -0,0 +1,103 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    IFNDEF HEAP_H
+    DEFINE HEAP_H
+
+    ; Heap allocator built on top of PALLOC, PFREE and MAP syscalls. The program gives the
+    ; allocator one or more 16KB virtual windows it doesn't use, the allocator maps RAM pages
+    ; in these windows when it needs more memory and gives them back to the kernel as soon
+    ; as they are completely free.
+    ; Each page is divided in 1KB slabs. Allocations up to 512 bytes are served from slabs
+    ; dedicated to a size class (8, 16, 32, ..., 512 bytes), bigger allocations get a run of
+    ; contiguous slabs in a single page, so they are limited to 16KB.
+    ; Requires a kernel with MMU support.
+
+    ; Maximum number of virtual windows the heap can use
+    DEFC HEAP_MAX_PAGES = 3
+
+    DEFC HEAP_PAGE_SIZE = 0x4000
+    DEFC HEAP_SLAB_SIZE = 1024
+    DEFC HEAP_SMALL_MAX = 512
+
+    ; Structure filled by heap_stats
+    DEFVARS 0 {
+        heap_stats_pages_t  DS.B 1  ; Number of pages currently allocated from the kernel
+        heap_stats_slabs_t  DS.B 1  ; Number of slabs in use in these pages
+        heap_stats_run_t    DS.B 1  ; Largest run of free slabs in a mapped page
+        heap_stats_allocs_t DS.W 1  ; Number of blocks currently allocated
+        heap_stats_used_t   DS.W 1  ; Bytes given to the program, rounded up to the size classes
+        heap_stats_bytes_t  DS.W 1  ; Bytes in use slabs, bytes - used is lost to fragmentation
+        heap_stats_end_t
+    }
+    DEFC HEAP_STATS_SIZE = heap_stats_end_t
+
+
+    ; Initialize the heap with the virtual windows it can map pages in. Any data in these
+    ; windows will be hidden once the heap maps a page in them, so they must not contain
+    ; the program code, its data or its stack.
+    ; Parameters:
+    ;   HL - Virtual address of the first window, aligned on HEAP_PAGE_SIZE
+    ;   A  - Number of consecutive windows the heap can use, at most HEAP_MAX_PAGES
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, ERR_INVALID_PARAMETER else
+    ; Alters:
+    ;   A, BC, HL
+    EXTERN heap_init
+
+
+    ; Allocate a block of memory. The block is not initialized.
+    ; Parameters:
+    ;   BC - Size of the block in bytes
+    ; Returns:
+    ;   HL - Address of the block, 0 if the size is 0, bigger than a page, or if there is
+    ;        no more memory
+    ; Alters:
+    ;   A, BC, DE, HL
+    EXTERN heap_alloc
+
+
+    ; Free a block allocated with heap_alloc. Does nothing if HL is 0.
+    ; When all the blocks of a page are free, the page is given back to the kernel.
+    ; Parameters:
+    ;   HL - Address of the block
+    ; Alters:
+    ;   A, BC, DE, HL
+    EXTERN heap_free
+
+
+    ; Fill a structure of HEAP_STATS_SIZE bytes with the current heap statistics.
+    ; Parameters:
+    ;   DE - Address of the structure to fill
+    ; Alters:
+    ;   A, BC, DE, HL
+    EXTERN heap_stats
+
+
+    ; The definitions below are only meant to be used by the implementation
+
+    DEFC HEAP_SLABS_PER_PAGE = HEAP_PAGE_SIZE / HEAP_SLAB_SIZE
+    DEFC HEAP_MAX_SLABS      = HEAP_MAX_PAGES * HEAP_SLABS_PER_PAGE
+    DEFC HEAP_CLASS_SHIFT    = 3
+    DEFC HEAP_CLASS_COUNT    = 7
+
+    ; Values of heap_slab_class for slabs that are not part of a size class
+    DEFC HEAP_SLAB_FREE  = 0xff
+    DEFC HEAP_SLAB_LARGE = 0xfe
+    DEFC HEAP_SLAB_CONT  = 0xfd
+    DEFC HEAP_NO_SLAB    = 0xff
+
+    ; Get the address of the entry A of the given byte table in HL
+    ; Alters:
+    ;   A, HL
+    MACRO HEAP_TABLE_ENTRY table
+        ld hl, table
+        add l
+        ld l, a
+        adc h
+        sub l
+        ld h, a
+    ENDM
+
+    ENDIF
@@ -0,0 +1,186 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    IFNDEF STDIO_H
+    DEFINE STDIO_H
+
+    ; Buffered streams on top of READ and WRITE syscalls. Each stream is a structure
+    ; of STREAM_STRUCT_SIZE bytes, allocated by the program, that owns a buffer.
+    ; Small reads and writes are grouped in the buffer and sent to the kernel with a
+    ; single syscall, when the buffer is full/empty or when a new line is written to a
+    ; line-buffered stream.
+    ; A stream is either a read stream or a write stream. In all the routines below, IX
+    ; must point to the stream structure.
+    ; Pending data are only written on `fflush` or `fclose`, make sure to call one of them
+    ; before exiting the program.
+    DEFVARS 0 {
+        stream_dev_t    DS.B 1  ; Opened device
+        stream_flags_t  DS.B 1  ; STREAM_* flags below
+        stream_buf_t    DS.W 1  ; Address of the buffer
+        stream_size_t   DS.W 1  ; Size of the buffer
+        stream_pos_t    DS.W 1  ; Index of the next byte to read or write in the buffer
+        stream_len_t    DS.W 1  ; Number of valid bytes in the buffer (read stream only)
+        stream_end_t
+    }
+    DEFC STREAM_STRUCT_SIZE = stream_end_t
+
+    ; Default buffer size for `fopen`, the buffer must not cross a virtual page boundary
+    DEFC STREAM_BUFSIZE = 256
+
+    DEFC STREAM_READ_BIT  = 0
+    DEFC STREAM_WRITE_BIT = 1
+    DEFC STREAM_LINE_BIT  = 2   ; Line-buffered, flush on each '\n'
+    DEFC STREAM_EOF_BIT   = 3   ; End of file reached
+    DEFC STREAM_ERR_BIT   = 4   ; An error occurred
+
+    DEFC STREAM_READ  = 1 << STREAM_READ_BIT
+    DEFC STREAM_WRITE = 1 << STREAM_WRITE_BIT
+    DEFC STREAM_LINE  = 1 << STREAM_LINE_BIT
+    DEFC STREAM_EOF   = 1 << STREAM_EOF_BIT
+    DEFC STREAM_ERR   = 1 << STREAM_ERR_BIT
+
+
+    ; Initialize a stream for an already opened device, such as DEV_STDOUT.
+    ; Parameters:
+    ;   IX - Stream structure to initialize
+    ;   H  - Opened device
+    ;   A  - STREAM_READ or STREAM_WRITE, can be ORed with STREAM_LINE
+    ;   DE - Buffer, must not cross a virtual page boundary
+    ;   BC - Size of the buffer, must not be 0
+    ; Alters:
+    ;   None
+    EXTERN fdopen
+
+
+    ; Open a file and initialize a stream for it, with a buffer of STREAM_BUFSIZE bytes.
+    ; The stream is a write stream if the file is opened with O_WRONLY or O_RDWR,
+    ; a read stream else.
+    ; Parameters:
+    ;   IX - Stream structure to initialize
+    ;   BC - Path of the file to open
+    ;   H  - Flags to open the file with (O_*)
+    ;   DE - Buffer of STREAM_BUFSIZE bytes
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+    EXTERN fopen
+
+
+    ; Write the pending data of a write stream. Does nothing on a read stream.
+    ; Parameters:
+    ;   IX - Stream to flush
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+    EXTERN fflush
+
+
+    ; Flush the stream and close its device.
+    ; Parameters:
+    ;   IX - Stream to close
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+    EXTERN fclose
+
+
+    ; Write a byte to a write stream.
+    ; Parameters:
+    ;   IX - Write stream
+    ;   A  - Byte to write
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+    EXTERN fputc
+
+
+    ; Write a buffer to a write stream.
+    ; Parameters:
+    ;   IX - Write stream
+    ;   DE - Buffer to write
+    ;   BC - Size of the buffer
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+    EXTERN fwrite
+
+
+    ; Write a NULL-terminated string to a write stream.
+    ; Parameters:
+    ;   IX - Write stream
+    ;   HL - NULL-terminated string
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+    EXTERN fputs
+
+
+    ; Formatted output to a write stream. Supported specifiers are %s, %c, %u, %x and %%.
+    ; Each specifier consumes a 16-bit parameter from the array pointed by DE:
+    ; the address of the string for %s, the character in the lowest byte for %c.
+    ; Parameters:
+    ;   IX - Write stream
+    ;   HL - NULL-terminated format string
+    ;   DE - Array of 16-bit parameters
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+    EXTERN fprintf
+
+
+    ; Refill the buffer of a read stream with a single READ syscall.
+    ; Parameters:
+    ;   IX - Read stream
+    ; Returns:
+    ;   A  - ERR_SUCCESS on success, error code else
+    ;   BC - Number of bytes in the buffer, 0 on end of file or error
+    ; Alters:
+    ;   A, BC, DE, HL
+    EXTERN stream_fill
+
+
+    ; Read a byte from a read stream.
+    ; Parameters:
+    ;   IX - Read stream
+    ; Returns:
+    ;   A - Byte read
+    ;   carry flag - No byte available, end of file or error, check stream flags
+    ;   not carry flag - Success
+    ; Alters:
+    ;   A, BC, DE, HL
+    EXTERN fgetc
+
+
+    ; Read bytes from a read stream.
+    ; Parameters:
+    ;   IX - Read stream
+    ;   DE - Destination buffer
+    ;   BC - Number of bytes to read
+    ; Returns:
+    ;   A  - ERR_SUCCESS on success or end of file, error code else
+    ;   BC - Number of bytes read
+    ; Alters:
+    ;   A, BC, DE, HL
+    EXTERN fread
+
+
+    ; Read a line from a read stream, including the final '\n', and NULL-terminate it.
+    ; Parameters:
+    ;   IX - Read stream
+    ;   DE - Destination buffer
+    ;   BC - Size of the destination buffer, including the NULL byte, must not be 0
+    ; Returns:
+    ;   BC - Length of the string, 0 on end of file or error
+    ; Alters:
+    ;   A, BC, DE, HL
+    EXTERN fgets
+
+    ENDIF
@@ -124,6 +124,36 @@
     EXTERN is_whitespace
 
 
+    ; Compare the first BC bytes of the memory areas pointed by HL and DE.
+    ; Parameters:
+    ;       HL - First memory area address
+    ;       DE - Second memory area address
+    ;       BC - Number of bytes to compare, can be 0
+    ; Returns:
+    ;       A - 0 if both areas are identical
+    ;           > 0 if the first different byte is greater in DE
+    ;           < 0 if the first different byte is greater in HL
+    ; Alters:
+    ;       A
+    EXTERN memcmp
+
+
+    ; Copy BC bytes from HL to DE, the result is the same as LDIR, including when the
+    ; destination overlaps the end of the source. Faster than LDIR for copies of 32 bytes
+    ; or more.
+    ; Parameters:
+    ;       HL - Source address
+    ;       DE - Destination address
+    ;       BC - Number of bytes to copy, can be 0
+    ; Returns:
+    ;       HL - Source address + BC
+    ;       DE - Destination address + BC
+    ;       BC - 0
+    ; Alters:
+    ;       A, BC, DE, HL
+    EXTERN memcpy
+
+
     ; Replace a byte by another in an array.
     ; Parameters:
     ;   A - Old byte to replace
@@ -159,6 +189,8 @@
     ;       HL - Memory address to initialize
     ;       BC - Size of the memory to initialize
     ;       E  - Byte to initialize the memory with
+    ; Alters:
+    ;       A
     EXTERN memset
 
     ; Convert an ASCII character representing a decimal digit to its binary value
@@ -0,0 +1,219 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    INCLUDE "zos_sys.asm"
+    INCLUDE "heap_h.asm"
+
+    SECTION TEXT
+
+    EXTERN heap_slab_take
+    EXTERN heap_base_h
+    EXTERN heap_class_head
+    EXTERN heap_allocs
+    EXTERN heap_used
+    EXTERN heap_slab_class
+    EXTERN heap_slab_used
+    EXTERN heap_slab_fresh
+    EXTERN heap_slab_next
+    EXTERN heap_slab_free
+
+    ; Allocate a block of memory. The block is not initialized.
+    ; Parameters:
+    ;   BC - Size of the block in bytes
+    ; Returns:
+    ;   HL - Address of the block, 0 if the size is 0, bigger than a page, or if there is
+    ;        no more memory
+    ; Alters:
+    ;   A, BC, DE, HL
+    PUBLIC heap_alloc
+heap_alloc:
+    ld a, b
+    or c
+    jr z, _heap_alloc_null
+    ld hl, HEAP_SMALL_MAX
+    or a
+    sbc hl, bc
+    jr c, _heap_alloc_large
+    ; Look for the size class: D = class, HL = block size. The carry is set after `add`
+    ; if the block size is smaller than the requested size.
+    ld hl, 1 << HEAP_CLASS_SHIFT
+    ld d, 0
+_heap_alloc_class:
+    or a
+    sbc hl, bc
+    add hl, bc
+    jr nc, _heap_alloc_class_found
+    add hl, hl
+    inc d
+    jr _heap_alloc_class
+_heap_alloc_class_found:
+    push hl
+    ld a, d
+    HEAP_TABLE_ENTRY(heap_class_head)
+    ld a, (hl)
+    cp HEAP_NO_SLAB
+    jr nz, _heap_alloc_from_slab
+    ; No slab with free blocks in this class, create a new one
+    push de
+    ld a, 1
+    call heap_slab_take
+    pop de
+    jr c, _heap_alloc_fail
+    ld e, a
+    HEAP_TABLE_ENTRY(heap_slab_class)
+    ld (hl), d
+    ld a, e
+    HEAP_TABLE_ENTRY(heap_slab_used)
+    ld (hl), 0
+    ld a, e
+    HEAP_TABLE_ENTRY(heap_slab_next)
+    ld (hl), HEAP_NO_SLAB
+    ; Number of blocks in the slab: HEAP_SLAB_SIZE >> (class + HEAP_CLASS_SHIFT)
+    ld a, d
+    or a
+    ld a, HEAP_SLAB_SIZE >> HEAP_CLASS_SHIFT
+    jr z, _heap_alloc_fresh_set
+    ld b, d
+_heap_alloc_fresh_count:
+    srl a
+    djnz _heap_alloc_fresh_count
+_heap_alloc_fresh_set:
+    ld c, a
+    ld a, e
+    HEAP_TABLE_ENTRY(heap_slab_fresh)
+    ld (hl), c
+    ld a, e
+    add a
+    HEAP_TABLE_ENTRY(heap_slab_free)
+    xor a
+    ld (hl), a
+    inc hl
+    ld (hl), a
+    ld a, d
+    HEAP_TABLE_ENTRY(heap_class_head)
+    ld (hl), e
+    ld a, e
+_heap_alloc_from_slab:
+    ; A = slab, D = class, block size on the stack
+    ld e, a
+    add a
+    HEAP_TABLE_ENTRY(heap_slab_free)
+    ld c, (hl)
+    inc hl
+    ld b, (hl)
+    ld a, b
+    or c
+    jr z, _heap_alloc_fresh
+    ; Pop the first freed block, its first two bytes point to the next one
+    ld a, (bc)
+    dec hl
+    ld (hl), a
+    inc bc
+    ld a, (bc)
+    inc hl
+    ld (hl), a
+    dec bc
+    jr _heap_alloc_got
+_heap_alloc_fresh:
+    ; Fresh blocks are handed out from the end of the slab:
+    ; BC = slab address + --fresh << (class + HEAP_CLASS_SHIFT)
+    ld a, e
+    HEAP_TABLE_ENTRY(heap_slab_fresh)
+    dec (hl)
+    ld l, (hl)
+    ld h, 0
+    ld b, d
+    inc b
+    inc b
+    inc b
+_heap_alloc_fresh_offset:
+    add hl, hl
+    djnz _heap_alloc_fresh_offset
+    ld a, e
+    add a
+    add a
+    ld c, a
+    ld a, (heap_base_h)
+    add c
+    add h
+    ld b, a
+    ld c, l
+_heap_alloc_got:
+    ; BC = block, E = slab, D = class
+    ld a, e
+    HEAP_TABLE_ENTRY(heap_slab_used)
+    inc (hl)
+    ; If the slab is full, remove it from its class list, it is always the head
+    ld a, e
+    add a
+    HEAP_TABLE_ENTRY(heap_slab_free)
+    ld a, (hl)
+    inc hl
+    or (hl)
+    jr nz, _heap_alloc_update
+    ld a, e
+    HEAP_TABLE_ENTRY(heap_slab_fresh)
+    ld a, (hl)
+    or a
+    jr nz, _heap_alloc_update
+    ld a, e
+    HEAP_TABLE_ENTRY(heap_slab_next)
+    ld e, (hl)
+    ld a, d
+    HEAP_TABLE_ENTRY(heap_class_head)
+    ld (hl), e
+_heap_alloc_update:
+    pop de
+    ld hl, (heap_allocs)
+    inc hl
+    ld (heap_allocs), hl
+    ld hl, (heap_used)
+    add hl, de
+    ld (heap_used), hl
+    ld h, b
+    ld l, c
+    ret
+_heap_alloc_fail:
+    pop hl
+_heap_alloc_null:
+    ld hl, 0
+    ret
+_heap_alloc_large:
+    ; Allocations bigger than a page cannot be served
+    ld hl, HEAP_PAGE_SIZE
+    or a
+    sbc hl, bc
+    jr c, _heap_alloc_null
+    ; Number of slabs: (size + HEAP_SLAB_SIZE - 1) / HEAP_SLAB_SIZE
+    ld hl, HEAP_SLAB_SIZE - 1
+    add hl, bc
+    ld a, h
+    rrca
+    rrca
+    and 0x3f
+    ld e, a
+    push de
+    call heap_slab_take
+    pop de
+    jr c, _heap_alloc_null
+    ld c, a
+    ld hl, (heap_allocs)
+    inc hl
+    ld (heap_allocs), hl
+    ; Used bytes += slabs * HEAP_SLAB_SIZE
+    ld a, e
+    add a
+    add a
+    ld hl, heap_used + 1
+    add (hl)
+    ld (hl), a
+    ; HL = slab address
+    ld a, c
+    add a
+    add a
+    ld hl, heap_base_h
+    add (hl)
+    ld h, a
+    ld l, 0
+    ret
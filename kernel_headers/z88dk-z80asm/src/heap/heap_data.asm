@@ -0,0 +1,40 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    INCLUDE "zos_sys.asm"
+    INCLUDE "heap_h.asm"
+
+    ; State of the heap allocator. The slab metadata are kept outside of the slabs, so that
+    ; the whole slab is usable and a block address is enough to find its slab.
+    ; Free blocks of a slab are linked together, blocks that have never been allocated are
+    ; counted in heap_slab_fresh instead, this saves building the list when a slab is created.
+    SECTION BSS
+
+    PUBLIC heap_base_h
+    PUBLIC heap_count
+    PUBLIC heap_page
+    PUBLIC heap_mapped
+    PUBLIC heap_page_used
+    PUBLIC heap_class_head
+    PUBLIC heap_allocs
+    PUBLIC heap_used
+    PUBLIC heap_slab_class
+    PUBLIC heap_slab_used
+    PUBLIC heap_slab_fresh
+    PUBLIC heap_slab_next
+    PUBLIC heap_slab_free
+
+heap_base_h:     DEFS 1  ; Upper byte of the first window address
+heap_count:      DEFS 1  ; Number of windows
+heap_page:       DEFS HEAP_MAX_PAGES    ; Page index returned by PALLOC
+heap_mapped:     DEFS HEAP_MAX_PAGES
+heap_page_used:  DEFS HEAP_MAX_PAGES    ; Number of slabs used in the page
+heap_class_head: DEFS HEAP_CLASS_COUNT  ; Slabs that have at least one free block
+heap_allocs:     DEFS 2
+heap_used:       DEFS 2
+heap_slab_class: DEFS HEAP_MAX_SLABS    ; Size class, or one of the HEAP_SLAB_* values
+heap_slab_used:  DEFS HEAP_MAX_SLABS    ; Blocks allocated, or slab count for HEAP_SLAB_LARGE
+heap_slab_fresh: DEFS HEAP_MAX_SLABS    ; Blocks never allocated, at the end of the slab
+heap_slab_next:  DEFS HEAP_MAX_SLABS    ; Next slab of the same class with free blocks
+heap_slab_free:  DEFS HEAP_MAX_SLABS * 2 ; List of freed blocks
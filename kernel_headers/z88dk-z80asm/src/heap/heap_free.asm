@@ -0,0 +1,147 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    INCLUDE "zos_sys.asm"
+    INCLUDE "heap_h.asm"
+
+    SECTION TEXT
+
+    EXTERN heap_slab_release
+    EXTERN heap_base_h
+    EXTERN heap_class_head
+    EXTERN heap_allocs
+    EXTERN heap_used
+    EXTERN heap_slab_class
+    EXTERN heap_slab_used
+    EXTERN heap_slab_fresh
+    EXTERN heap_slab_next
+    EXTERN heap_slab_free
+
+    ; Free a block allocated with heap_alloc. Does nothing if HL is 0.
+    ; When all the blocks of a page are free, the page is given back to the kernel.
+    ; Parameters:
+    ;   HL - Address of the block
+    ; Alters:
+    ;   A, BC, DE, HL
+    PUBLIC heap_free
+heap_free:
+    ld a, h
+    or l
+    ret z
+    ; E = slab = (H - base) / 4
+    ld a, (heap_base_h)
+    ld c, a
+    ld a, h
+    sub c
+    rrca
+    rrca
+    and 0x3f
+    ld e, a
+    push hl
+    ld hl, (heap_allocs)
+    dec hl
+    ld (heap_allocs), hl
+    ld a, e
+    HEAP_TABLE_ENTRY(heap_slab_class)
+    ld d, (hl)
+    ld a, d
+    cp HEAP_SLAB_LARGE
+    jr nz, _heap_free_small
+    pop hl
+    ; Large allocation, release all its slabs
+    ld a, e
+    HEAP_TABLE_ENTRY(heap_slab_used)
+    ld b, (hl)
+    ld a, b
+    add a
+    add a
+    ld c, a
+    ld hl, heap_used + 1
+    ld a, (hl)
+    sub c
+    ld (hl), a
+    ld a, e
+    ld e, b
+    jp heap_slab_release
+_heap_free_small:
+    ; Used bytes -= block size, which is (1 << HEAP_CLASS_SHIFT) << class
+    push de
+    ld hl, 1 << HEAP_CLASS_SHIFT
+    ld a, d
+    or a
+    jr z, _heap_free_size
+    ld b, d
+_heap_free_size_loop:
+    add hl, hl
+    djnz _heap_free_size_loop
+_heap_free_size:
+    ex de, hl
+    ld hl, (heap_used)
+    or a
+    sbc hl, de
+    ld (heap_used), hl
+    pop de
+    ; BC = first freed block of the slab
+    ld a, e
+    add a
+    HEAP_TABLE_ENTRY(heap_slab_free)
+    ld c, (hl)
+    inc hl
+    ld b, (hl)
+    ld a, b
+    or c
+    jr nz, _heap_free_push
+    ld a, e
+    HEAP_TABLE_ENTRY(heap_slab_fresh)
+    ld a, (hl)
+    or a
+    jr nz, _heap_free_push
+    ; The slab was full, so not part of its class list, add it back since it now has a
+    ; free block. BC is 0 here.
+    ld a, d
+    HEAP_TABLE_ENTRY(heap_class_head)
+    ld c, (hl)
+    ld (hl), e
+    ld a, e
+    HEAP_TABLE_ENTRY(heap_slab_next)
+    ld (hl), c
+    ld c, b
+_heap_free_push:
+    ; The block now points to the former first freed block, and becomes the first one
+    pop hl
+    ld (hl), c
+    inc hl
+    ld (hl), b
+    dec hl
+    push hl
+    ld a, e
+    add a
+    HEAP_TABLE_ENTRY(heap_slab_free)
+    pop bc
+    ld (hl), c
+    inc hl
+    ld (hl), b
+    ld a, e
+    HEAP_TABLE_ENTRY(heap_slab_used)
+    dec (hl)
+    ret nz
+    ; The slab is empty, remove it from its class list and release it
+    ld a, d
+    HEAP_TABLE_ENTRY(heap_class_head)
+_heap_free_remove:
+    ld a, (hl)
+    cp e
+    jr z, _heap_free_remove_found
+    HEAP_TABLE_ENTRY(heap_slab_next)
+    jr _heap_free_remove
+_heap_free_remove_found:
+    push hl
+    ld a, e
+    HEAP_TABLE_ENTRY(heap_slab_next)
+    ld a, (hl)
+    pop hl
+    ld (hl), a
+    ld a, e
+    ld e, 1
+    jp heap_slab_release
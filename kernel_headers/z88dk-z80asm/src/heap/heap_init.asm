@@ -0,0 +1,68 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    INCLUDE "zos_sys.asm"
+    INCLUDE "heap_h.asm"
+
+    SECTION TEXT
+
+    EXTERN heap_base_h
+    EXTERN heap_count
+    EXTERN heap_mapped
+    EXTERN heap_class_head
+    EXTERN heap_allocs
+    EXTERN heap_used
+    EXTERN heap_slab_class
+
+    ; Initialize the heap with the virtual windows it can map pages in.
+    ; Parameters:
+    ;   HL - Virtual address of the first window, aligned on HEAP_PAGE_SIZE
+    ;   A  - Number of consecutive windows the heap can use, at most HEAP_MAX_PAGES
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, ERR_INVALID_PARAMETER else
+    ; Alters:
+    ;   A, BC, HL
+    PUBLIC heap_init
+heap_init:
+    or a
+    jr z, _heap_init_invalid
+    cp HEAP_MAX_PAGES + 1
+    jr nc, _heap_init_invalid
+    ld c, a
+    ld a, l
+    or a
+    jr nz, _heap_init_invalid
+    ld a, h
+    and (HEAP_PAGE_SIZE - 1) >> 8
+    jr nz, _heap_init_invalid
+    ld a, h
+    ld (heap_base_h), a
+    ld a, c
+    ld (heap_count), a
+    ld hl, heap_mapped
+    ld b, HEAP_MAX_PAGES
+_heap_init_pages:
+    ld (hl), 0
+    inc hl
+    djnz _heap_init_pages
+    ld hl, heap_slab_class
+    ld b, HEAP_MAX_SLABS
+_heap_init_slabs:
+    ld (hl), HEAP_SLAB_FREE
+    inc hl
+    djnz _heap_init_slabs
+    ld hl, heap_class_head
+    ld b, HEAP_CLASS_COUNT
+_heap_init_classes:
+    ld (hl), HEAP_NO_SLAB
+    inc hl
+    djnz _heap_init_classes
+    ld hl, 0
+    ld (heap_allocs), hl
+    ld (heap_used), hl
+    xor a
+    ret
+_heap_init_invalid:
+    ld a, ERR_INVALID_PARAMETER
+    ret
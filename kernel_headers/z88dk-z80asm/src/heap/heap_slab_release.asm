@@ -0,0 +1,52 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    INCLUDE "zos_sys.asm"
+    INCLUDE "heap_h.asm"
+
+    SECTION TEXT
+
+    EXTERN heap_page
+    EXTERN heap_mapped
+    EXTERN heap_page_used
+    EXTERN heap_slab_class
+
+    ; Give back contiguous slabs, the page is returned to the kernel if it doesn't contain
+    ; any used slab anymore. The window still maps the freed page until a new one is mapped,
+    ; it is never accessed in the meantime since no block belongs to it.
+    ; Parameters:
+    ;   A - Index of the first slab
+    ;   E - Number of slabs
+    ; Alters:
+    ;   A, BC, DE, HL
+    PUBLIC heap_slab_release
+heap_slab_release:
+    ld c, a
+    HEAP_TABLE_ENTRY(heap_slab_class)
+    ld b, e
+_heap_slab_release_loop:
+    ld (hl), HEAP_SLAB_FREE
+    inc hl
+    djnz _heap_slab_release_loop
+    ; D = page
+    ld a, c
+    rrca
+    rrca
+    rrca
+    rrca
+    and 0x0f
+    ld d, a
+    HEAP_TABLE_ENTRY(heap_page_used)
+    ld a, (hl)
+    sub e
+    ld (hl), a
+    ret nz
+    ld a, d
+    HEAP_TABLE_ENTRY(heap_mapped)
+    ld (hl), 0
+    ld a, d
+    HEAP_TABLE_ENTRY(heap_page)
+    ld b, (hl)
+    PFREE()
+    ret
@@ -0,0 +1,183 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    INCLUDE "zos_sys.asm"
+    INCLUDE "heap_h.asm"
+
+    SECTION TEXT
+
+    EXTERN heap_base_h
+    EXTERN heap_count
+    EXTERN heap_page
+    EXTERN heap_mapped
+    EXTERN heap_page_used
+    EXTERN heap_slab_class
+    EXTERN heap_slab_used
+
+    ; Reserve contiguous slabs in a page, map a new page from the kernel if none of the
+    ; mapped pages has enough room. The slabs are marked as HEAP_SLAB_LARGE/HEAP_SLAB_CONT.
+    ; Parameters:
+    ;   A - Number of slabs, between 1 and HEAP_SLABS_PER_PAGE
+    ; Returns:
+    ;   A - Index of the first slab
+    ;   carry flag - No more memory
+    ;   not carry flag - Success
+    ; Alters:
+    ;   A, BC, DE, HL
+    PUBLIC heap_slab_take
+heap_slab_take:
+    ; D = page, E = number of slabs
+    ld e, a
+    ld d, 0
+_heap_slab_take_mapped:
+    ld a, (heap_count)
+    cp d
+    jr z, _heap_slab_take_new
+    ld a, d
+    HEAP_TABLE_ENTRY(heap_mapped)
+    ld a, (hl)
+    or a
+    jr z, _heap_slab_take_next
+    call _heap_find_run
+    jr nc, _heap_slab_take_found
+_heap_slab_take_next:
+    inc d
+    jr _heap_slab_take_mapped
+_heap_slab_take_new:
+    ; Look for a window that has no page mapped
+    ld d, 0
+    ld hl, heap_mapped
+_heap_slab_take_window:
+    ld a, (heap_count)
+    cp d
+    jr z, _heap_slab_take_fail
+    ld a, (hl)
+    or a
+    jr z, _heap_slab_take_alloc
+    inc hl
+    inc d
+    jr _heap_slab_take_window
+_heap_slab_take_alloc:
+    push de
+    PALLOC()
+    pop de
+    or a
+    jr nz, _heap_slab_take_fail
+    ld a, d
+    HEAP_TABLE_ENTRY(heap_page)
+    ld (hl), b
+    ; Map it: DE = window address, HBC = page index << 6
+    push de
+    ld a, d
+    rrca
+    rrca
+    ld hl, heap_base_h
+    add (hl)
+    ld d, a
+    ld e, 0
+    ld a, b
+    and 3
+    rrca
+    rrca
+    ld c, a
+    ld a, b
+    srl a
+    srl a
+    ld h, a
+    ld b, c
+    ld c, 0
+    MAP()
+    pop de
+    or a
+    jr nz, _heap_slab_take_unmapped
+    ld a, d
+    HEAP_TABLE_ENTRY(heap_mapped)
+    ld (hl), 1
+    ld a, d
+    HEAP_TABLE_ENTRY(heap_page_used)
+    ld (hl), 0
+    ; First slab of the page
+    ld a, d
+    add a
+    add a
+    add a
+    add a
+_heap_slab_take_found:
+    ; A = slab, D = page, E = number of slabs
+    ld c, a
+    ld a, d
+    HEAP_TABLE_ENTRY(heap_page_used)
+    ld a, (hl)
+    add e
+    ld (hl), a
+    ld a, c
+    HEAP_TABLE_ENTRY(heap_slab_used)
+    ld (hl), e
+    ld a, c
+    HEAP_TABLE_ENTRY(heap_slab_class)
+    ld (hl), HEAP_SLAB_LARGE
+    ld b, e
+    dec b
+    jr z, _heap_slab_take_end
+_heap_slab_take_cont:
+    inc hl
+    ld (hl), HEAP_SLAB_CONT
+    djnz _heap_slab_take_cont
+_heap_slab_take_end:
+    ld a, c
+    or a
+    ret
+_heap_slab_take_unmapped:
+    ld a, d
+    HEAP_TABLE_ENTRY(heap_page)
+    ld b, (hl)
+    PFREE()
+_heap_slab_take_fail:
+    ld a, HEAP_NO_SLAB
+    scf
+    ret
+
+
+    ; Look for E contiguous free slabs in page D
+    ; Returns:
+    ;   A - Index of the first slab
+    ;   carry flag - Not found
+    ;   not carry flag - Found
+    ; Alters:
+    ;   A, BC, HL
+_heap_find_run:
+    ld a, d
+    add a
+    add a
+    add a
+    add a
+    ld c, a
+    HEAP_TABLE_ENTRY(heap_slab_class)
+    ld b, HEAP_SLABS_PER_PAGE
+    push de
+    ; D = length of the current run, C = index of the slab following the current one
+    ld d, 0
+_heap_find_run_loop:
+    ld a, (hl)
+    inc hl
+    inc c
+    inc d
+    cp HEAP_SLAB_FREE
+    jr z, _heap_find_run_check
+    ld d, 0
+    jr _heap_find_run_next
+_heap_find_run_check:
+    ld a, d
+    cp e
+    jr z, _heap_find_run_found
+_heap_find_run_next:
+    djnz _heap_find_run_loop
+    pop de
+    scf
+    ret
+_heap_find_run_found:
+    ld a, c
+    sub e
+    pop de
+    ret
@@ -0,0 +1,95 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    INCLUDE "zos_sys.asm"
+    INCLUDE "heap_h.asm"
+
+    SECTION TEXT
+
+    EXTERN heap_count
+    EXTERN heap_mapped
+    EXTERN heap_page_used
+    EXTERN heap_allocs
+    EXTERN heap_used
+    EXTERN heap_slab_class
+
+    ; Fill a structure of HEAP_STATS_SIZE bytes with the current heap statistics.
+    ; Parameters:
+    ;   DE - Address of the structure to fill
+    ; Alters:
+    ;   A, BC, DE, HL
+    PUBLIC heap_stats
+heap_stats:
+    push de
+    ; B = pages, C = slabs, D = largest free run, E = current page
+    ld bc, 0
+    ld de, 0
+_heap_stats_loop:
+    ld a, (heap_count)
+    cp e
+    jr z, _heap_stats_store
+    ld a, e
+    HEAP_TABLE_ENTRY(heap_mapped)
+    ld a, (hl)
+    or a
+    jr z, _heap_stats_next
+    inc b
+    ld a, e
+    HEAP_TABLE_ENTRY(heap_page_used)
+    ld a, c
+    add (hl)
+    ld c, a
+    push bc
+    ld a, e
+    add a
+    add a
+    add a
+    add a
+    HEAP_TABLE_ENTRY(heap_slab_class)
+    ld b, HEAP_SLABS_PER_PAGE
+    ld c, 0
+_heap_stats_run:
+    ld a, (hl)
+    inc hl
+    inc c
+    cp HEAP_SLAB_FREE
+    jr z, _heap_stats_run_max
+    ld c, 0
+_heap_stats_run_max:
+    ld a, d
+    cp c
+    jr nc, _heap_stats_run_next
+    ld d, c
+_heap_stats_run_next:
+    djnz _heap_stats_run
+    pop bc
+_heap_stats_next:
+    inc e
+    jr _heap_stats_loop
+_heap_stats_store:
+    pop hl
+    ld (hl), b
+    inc hl
+    ld (hl), c
+    inc hl
+    ld (hl), d
+    inc hl
+    ld de, (heap_allocs)
+    ld (hl), e
+    inc hl
+    ld (hl), d
+    inc hl
+    ld de, (heap_used)
+    ld (hl), e
+    inc hl
+    ld (hl), d
+    inc hl
+    ; Slab bytes = slabs * HEAP_SLAB_SIZE
+    ld (hl), 0
+    inc hl
+    ld a, c
+    add a
+    add a
+    ld (hl), a
+    ret
@@ -0,0 +1,31 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    INCLUDE "zos_sys.asm"
+    INCLUDE "stdio_h.asm"
+
+    SECTION TEXT
+
+    EXTERN fflush
+
+    ; Flush the stream and close its device.
+    ; Parameters:
+    ;   IX - Stream to close
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+    PUBLIC fclose
+fclose:
+    call fflush
+    push af
+    ld h, (ix + stream_dev_t)
+    CLOSE()
+    pop hl
+    ; Return the error from the flush first, if any
+    inc h
+    dec h
+    ret z
+    ld a, h
+    ret
@@ -0,0 +1,31 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    INCLUDE "zos_sys.asm"
+    INCLUDE "stdio_h.asm"
+
+    SECTION TEXT
+
+    ; Initialize a stream for an already opened device, such as DEV_STDOUT.
+    ; Parameters:
+    ;   IX - Stream structure to initialize
+    ;   H  - Opened device
+    ;   A  - STREAM_READ or STREAM_WRITE, can be ORed with STREAM_LINE
+    ;   DE - Buffer, must not cross a virtual page boundary
+    ;   BC - Size of the buffer, must not be 0
+    ; Alters:
+    ;   None
+    PUBLIC fdopen
+fdopen:
+    ld (ix + stream_dev_t), h
+    ld (ix + stream_flags_t), a
+    ld (ix + stream_buf_t), e
+    ld (ix + stream_buf_t + 1), d
+    ld (ix + stream_size_t), c
+    ld (ix + stream_size_t + 1), b
+    ld (ix + stream_pos_t), 0
+    ld (ix + stream_pos_t + 1), 0
+    ld (ix + stream_len_t), 0
+    ld (ix + stream_len_t + 1), 0
+    ret
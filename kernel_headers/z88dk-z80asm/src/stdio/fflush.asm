@@ -0,0 +1,60 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    INCLUDE "zos_sys.asm"
+    INCLUDE "stdio_h.asm"
+
+    SECTION TEXT
+
+    ; Write the pending data of a write stream. Does nothing on a read stream.
+    ; Parameters:
+    ;   IX - Stream to flush
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+    PUBLIC fflush
+fflush:
+    ld a, (ix + stream_flags_t)
+    and STREAM_WRITE
+    ret z
+    ld e, (ix + stream_buf_t)
+    ld d, (ix + stream_buf_t + 1)
+    ld c, (ix + stream_pos_t)
+    ld b, (ix + stream_pos_t + 1)
+    ; The kernel may write less bytes than requested, loop until everything is written
+_fflush_loop:
+    ld a, b
+    or c
+    jr z, _fflush_done
+    ld h, (ix + stream_dev_t)
+    push de
+    push bc
+    WRITE()
+    pop hl
+    pop de
+    or a
+    jr nz, _fflush_error
+    ld a, b
+    or c
+    jr z, _fflush_short
+    ; Buffer += written, remaining -= written
+    ex de, hl
+    add hl, bc
+    ex de, hl
+    or a
+    sbc hl, bc
+    ld b, h
+    ld c, l
+    jr _fflush_loop
+_fflush_short:
+    ld a, ERR_FAILURE
+_fflush_error:
+    set STREAM_ERR_BIT, (ix + stream_flags_t)
+    ret
+_fflush_done:
+    ; A is 0 already
+    ld (ix + stream_pos_t), a
+    ld (ix + stream_pos_t + 1), a
+    ret
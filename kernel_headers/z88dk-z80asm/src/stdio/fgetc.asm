@@ -0,0 +1,51 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    INCLUDE "zos_sys.asm"
+    INCLUDE "stdio_h.asm"
+
+    SECTION TEXT
+
+    EXTERN stream_fill
+
+    ; Read a byte from a read stream.
+    ; Parameters:
+    ;   IX - Read stream
+    ; Returns:
+    ;   A - Byte read
+    ;   carry flag - No byte available, end of file or error, check stream flags
+    ;   not carry flag - Success
+    ; Alters:
+    ;   A, BC, DE, HL
+    PUBLIC fgetc
+fgetc:
+    ld l, (ix + stream_pos_t)
+    ld h, (ix + stream_pos_t + 1)
+    ld e, (ix + stream_len_t)
+    ld d, (ix + stream_len_t + 1)
+    or a
+    sbc hl, de
+    jr nz, _fgetc_available
+    call stream_fill
+    ld a, b
+    or c
+    scf
+    ret z
+    ; The position is 0 after a refill
+    ld hl, 0
+    jr _fgetc_read
+_fgetc_available:
+    add hl, de
+_fgetc_read:
+    ld c, l
+    ld b, h
+    inc bc
+    ld (ix + stream_pos_t), c
+    ld (ix + stream_pos_t + 1), b
+    ld e, (ix + stream_buf_t)
+    ld d, (ix + stream_buf_t + 1)
+    add hl, de
+    ld a, (hl)
+    or a
+    ret
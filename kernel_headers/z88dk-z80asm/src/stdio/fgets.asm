@@ -0,0 +1,50 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    INCLUDE "zos_sys.asm"
+    INCLUDE "stdio_h.asm"
+
+    SECTION TEXT
+
+    EXTERN fgetc
+
+    ; Read a line from a read stream, including the final '\n', and NULL-terminate it.
+    ; Parameters:
+    ;   IX - Read stream
+    ;   DE - Destination buffer
+    ;   BC - Size of the destination buffer, including the NULL byte, must not be 0
+    ; Returns:
+    ;   BC - Length of the string, 0 on end of file or error
+    ; Alters:
+    ;   A, BC, DE, HL
+    PUBLIC fgets
+fgets:
+    push de
+    ; Keep room for the NULL byte
+    dec bc
+_fgets_loop:
+    ld a, b
+    or c
+    jr z, _fgets_end
+    push bc
+    push de
+    call fgetc
+    pop de
+    pop bc
+    jr c, _fgets_end
+    ld (de), a
+    inc de
+    dec bc
+    cp '\n'
+    jr nz, _fgets_loop
+_fgets_end:
+    xor a
+    ld (de), a
+    ; BC = end - start
+    ex de, hl
+    pop de
+    sbc hl, de
+    ld b, h
+    ld c, l
+    ret
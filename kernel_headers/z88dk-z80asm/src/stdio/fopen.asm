@@ -0,0 +1,49 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    INCLUDE "zos_sys.asm"
+    INCLUDE "stdio_h.asm"
+
+    SECTION TEXT
+
+    EXTERN fdopen
+
+    ; Open a file and initialize a stream for it, with a buffer of STREAM_BUFSIZE bytes.
+    ; The stream is a write stream if the file is opened with O_WRONLY or O_RDWR,
+    ; a read stream else.
+    ; Parameters:
+    ;   IX - Stream structure to initialize
+    ;   BC - Path of the file to open
+    ;   H  - Flags to open the file with (O_*)
+    ;   DE - Buffer of STREAM_BUFSIZE bytes
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+    PUBLIC fopen
+fopen:
+    push de
+    ld a, h
+    push af
+    OPEN()
+    ; A is the opened dev on success, negated error else
+    or a
+    jp m, _fopen_error
+    ld h, a
+    pop af
+    and O_WRONLY | O_RDWR
+    ld a, STREAM_READ
+    jr z, _fopen_flags
+    ld a, STREAM_WRITE
+_fopen_flags:
+    pop de
+    ld bc, STREAM_BUFSIZE
+    call fdopen
+    xor a
+    ret
+_fopen_error:
+    pop de
+    pop de
+    neg
+    ret
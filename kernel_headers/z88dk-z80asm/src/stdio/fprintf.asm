@@ -0,0 +1,129 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    INCLUDE "zos_sys.asm"
+    INCLUDE "stdio_h.asm"
+
+    SECTION TEXT
+
+    EXTERN fputc
+    EXTERN fputs
+
+    ; Formatted output to a write stream. Supported specifiers are %s, %c, %u, %x and %%.
+    ; Each specifier consumes a 16-bit parameter from the array pointed by DE:
+    ; the address of the string for %s, the character in the lowest byte for %c.
+    ; Parameters:
+    ;   IX - Write stream
+    ;   HL - NULL-terminated format string
+    ;   DE - Array of 16-bit parameters
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+    PUBLIC fprintf
+fprintf:
+    ld a, (hl)
+    or a
+    jr z, _fprintf_end
+    inc hl
+    cp '%'
+    jr nz, _fprintf_putc
+    ld a, (hl)
+    or a
+    jr z, _fprintf_end
+    inc hl
+    cp '%'
+    jr z, _fprintf_putc
+    ; Specifier, get the next parameter in BC
+    ex de, hl
+    ld c, (hl)
+    inc hl
+    ld b, (hl)
+    inc hl
+    ex de, hl
+    push hl
+    push de
+    cp 's'
+    jr z, _fprintf_str
+    cp 'c'
+    jr z, _fprintf_char
+    ld e, 16
+    cp 'x'
+    jr z, _fprintf_num
+    ld e, 10
+    cp 'u'
+    jr z, _fprintf_num
+    pop de
+    pop hl
+    ld a, ERR_INVALID_PARAMETER
+    ret
+_fprintf_char:
+    ld a, c
+    jr _fprintf_output
+_fprintf_putc:
+    push hl
+    push de
+_fprintf_output:
+    ; Errors are sticky in the stream flags, they are checked at the end
+    call fputc
+_fprintf_next:
+    pop de
+    pop hl
+    jr fprintf
+_fprintf_str:
+    ld h, b
+    ld l, c
+    call fputs
+    jr _fprintf_next
+_fprintf_num:
+    ; Push the digits on the stack, least significant first, then pop them to the stream
+    ld h, b
+    ld l, c
+    ld b, 0
+_fprintf_num_div:
+    call _fprintf_div
+    add '0'
+    cp '9' + 1
+    jr c, _fprintf_num_digit
+    add 'a' - '9' - 1
+_fprintf_num_digit:
+    push af
+    inc b
+    ld a, h
+    or l
+    jr nz, _fprintf_num_div
+_fprintf_num_out:
+    pop af
+    push bc
+    call fputc
+    pop bc
+    djnz _fprintf_num_out
+    jr _fprintf_next
+_fprintf_end:
+    bit STREAM_ERR_BIT, (ix + stream_flags_t)
+    ret z
+    ld a, ERR_FAILURE
+    ret
+
+    ; Divide HL by E
+    ; Returns:
+    ;   HL - Quotient
+    ;   A - Remainder
+    ; Alters:
+    ;   A, HL
+_fprintf_div:
+    push bc
+    xor a
+    ld b, 16
+_fprintf_div_loop:
+    add hl, hl
+    rla
+    cp e
+    jr c, _fprintf_div_next
+    sub e
+    inc l
+_fprintf_div_next:
+    djnz _fprintf_div_loop
+    pop bc
+    ret
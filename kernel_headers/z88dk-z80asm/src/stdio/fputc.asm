@@ -0,0 +1,45 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    INCLUDE "zos_sys.asm"
+    INCLUDE "stdio_h.asm"
+
+    SECTION TEXT
+
+    EXTERN fflush
+
+    ; Write a byte to a write stream.
+    ; Parameters:
+    ;   IX - Write stream
+    ;   A  - Byte to write
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+    PUBLIC fputc
+fputc:
+    ld c, a
+    ld l, (ix + stream_buf_t)
+    ld h, (ix + stream_buf_t + 1)
+    ld e, (ix + stream_pos_t)
+    ld d, (ix + stream_pos_t + 1)
+    add hl, de
+    ld (hl), c
+    inc de
+    ld (ix + stream_pos_t), e
+    ld (ix + stream_pos_t + 1), d
+    ; Flush if the buffer is full
+    ld l, (ix + stream_size_t)
+    ld h, (ix + stream_size_t + 1)
+    xor a
+    sbc hl, de
+    jp z, fflush
+    ; Or if a new line was written to a line-buffered stream
+    bit STREAM_LINE_BIT, (ix + stream_flags_t)
+    ret z
+    ld a, c
+    cp '\n'
+    jp z, fflush
+    xor a
+    ret
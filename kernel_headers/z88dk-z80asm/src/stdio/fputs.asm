@@ -0,0 +1,31 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    INCLUDE "zos_sys.asm"
+    INCLUDE "stdio_h.asm"
+
+    SECTION TEXT
+
+    EXTERN fputc
+
+    ; Write a NULL-terminated string to a write stream.
+    ; Parameters:
+    ;   IX - Write stream
+    ;   HL - NULL-terminated string
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+    PUBLIC fputs
+fputs:
+    ld a, (hl)
+    or a
+    ret z
+    inc hl
+    push hl
+    call fputc
+    pop hl
+    or a
+    jr z, fputs
+    ret
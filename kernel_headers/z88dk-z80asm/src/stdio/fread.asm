@@ -0,0 +1,97 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    INCLUDE "zos_sys.asm"
+    INCLUDE "stdio_h.asm"
+
+    SECTION TEXT
+
+    EXTERN stream_fill
+
+    ; Read bytes from a read stream.
+    ; Parameters:
+    ;   IX - Read stream
+    ;   DE - Destination buffer
+    ;   BC - Number of bytes to read
+    ; Returns:
+    ;   A  - ERR_SUCCESS on success or end of file, error code else
+    ;   BC - Number of bytes read
+    ; Alters:
+    ;   A, BC, DE, HL
+    PUBLIC fread
+fread:
+    ; Keep the total size to calculate the number of bytes read
+    push bc
+_fread_loop:
+    ld a, b
+    or c
+    jr z, _fread_end
+    ; HL = bytes available in the buffer
+    ld l, (ix + stream_len_t)
+    ld h, (ix + stream_len_t + 1)
+    ld a, l
+    sub (ix + stream_pos_t)
+    ld l, a
+    ld a, h
+    sbc (ix + stream_pos_t + 1)
+    ld h, a
+    or l
+    jr z, _fread_fill
+    ; Copy min(available, remaining) bytes, carry is set after `add` if available < remaining
+    sbc hl, bc
+    add hl, bc
+    jr c, _fread_copy
+    ld h, b
+    ld l, c
+_fread_copy:
+    ; Remaining -= chunk
+    ld a, c
+    sub l
+    ld c, a
+    ld a, b
+    sbc h
+    ld b, a
+    push bc
+    ld b, h
+    ld c, l
+    ; HL = buffer + pos, pos += chunk
+    ld l, (ix + stream_pos_t)
+    ld h, (ix + stream_pos_t + 1)
+    push hl
+    add hl, bc
+    ld (ix + stream_pos_t), l
+    ld (ix + stream_pos_t + 1), h
+    pop hl
+    ld a, (ix + stream_buf_t)
+    add l
+    ld l, a
+    ld a, (ix + stream_buf_t + 1)
+    adc h
+    ld h, a
+    ldir
+    pop bc
+    jr _fread_loop
+_fread_fill:
+    push bc
+    push de
+    call stream_fill
+    pop de
+    ld h, a
+    ld a, b
+    or c
+    pop bc
+    jr nz, _fread_loop
+    ; End of file or error, the code is in H
+    ld a, h
+    jr _fread_return
+_fread_end:
+    xor a
+_fread_return:
+    ; BC = total - remaining
+    pop hl
+    or a
+    sbc hl, bc
+    ld b, h
+    ld c, l
+    ret
@@ -0,0 +1,102 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    INCLUDE "zos_sys.asm"
+    INCLUDE "stdio_h.asm"
+
+    SECTION TEXT
+
+    EXTERN fflush
+    EXTERN fputc
+
+    ; Write a buffer to a write stream.
+    ; Parameters:
+    ;   IX - Write stream
+    ;   DE - Buffer to write
+    ;   BC - Size of the buffer
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+    PUBLIC fwrite
+fwrite:
+    ; Line-buffered streams need to check each byte for a new line
+    bit STREAM_LINE_BIT, (ix + stream_flags_t)
+    jr nz, _fwrite_line
+_fwrite_loop:
+    ld a, b
+    or c
+    ret z
+    push bc
+    push de
+    ; HL = room left in the buffer
+    ld l, (ix + stream_size_t)
+    ld h, (ix + stream_size_t + 1)
+    ld e, (ix + stream_pos_t)
+    ld d, (ix + stream_pos_t + 1)
+    or a
+    sbc hl, de
+    ; Copy min(room, remaining) bytes, carry is set after `add` if room < remaining
+    sbc hl, bc
+    add hl, bc
+    jr c, _fwrite_chunk
+    ld h, b
+    ld l, c
+_fwrite_chunk:
+    ; BC = chunk, pos += chunk
+    ld b, h
+    ld c, l
+    ex de, hl
+    add hl, bc
+    ld (ix + stream_pos_t), l
+    ld (ix + stream_pos_t + 1), h
+    ; DE = buffer + former pos
+    or a
+    sbc hl, bc
+    ld e, (ix + stream_buf_t)
+    ld d, (ix + stream_buf_t + 1)
+    add hl, de
+    ex de, hl
+    pop hl
+    push bc
+    ldir
+    pop bc
+    ; Remaining -= chunk, DE = source
+    ex (sp), hl
+    or a
+    sbc hl, bc
+    ex (sp), hl
+    ex de, hl
+    ; Flush if the buffer is full
+    ld l, (ix + stream_size_t)
+    ld h, (ix + stream_size_t + 1)
+    ld c, (ix + stream_pos_t)
+    ld b, (ix + stream_pos_t + 1)
+    or a
+    sbc hl, bc
+    pop bc
+    jr nz, _fwrite_loop
+    push bc
+    push de
+    call fflush
+    pop de
+    pop bc
+    or a
+    jr z, _fwrite_loop
+    ret
+_fwrite_line:
+    ld a, b
+    or c
+    ret z
+    ld a, (de)
+    inc de
+    dec bc
+    push bc
+    push de
+    call fputc
+    pop de
+    pop bc
+    or a
+    jr z, _fwrite_line
+    ret
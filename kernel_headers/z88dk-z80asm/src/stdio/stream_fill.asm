@@ -0,0 +1,46 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    INCLUDE "zos_sys.asm"
+    INCLUDE "stdio_h.asm"
+
+    SECTION TEXT
+
+    ; Refill the buffer of a read stream with a single READ syscall.
+    ; Parameters:
+    ;   IX - Read stream
+    ; Returns:
+    ;   A  - ERR_SUCCESS on success, error code else
+    ;   BC - Number of bytes in the buffer, 0 on end of file or error
+    ; Alters:
+    ;   A, BC, DE, HL
+    PUBLIC stream_fill
+stream_fill:
+    xor a
+    ld (ix + stream_pos_t), a
+    ld (ix + stream_pos_t + 1), a
+    ld (ix + stream_len_t), a
+    ld (ix + stream_len_t + 1), a
+    ld h, (ix + stream_dev_t)
+    ld e, (ix + stream_buf_t)
+    ld d, (ix + stream_buf_t + 1)
+    ld c, (ix + stream_size_t)
+    ld b, (ix + stream_size_t + 1)
+    READ()
+    or a
+    jr nz, _stream_fill_error
+    ld (ix + stream_len_t), c
+    ld (ix + stream_len_t + 1), b
+    ld a, b
+    or c
+    jr z, _stream_fill_eof
+    xor a
+    ret
+_stream_fill_eof:
+    set STREAM_EOF_BIT, (ix + stream_flags_t)
+    ret
+_stream_fill_error:
+    set STREAM_ERR_BIT, (ix + stream_flags_t)
+    ld bc, 0
+    ret
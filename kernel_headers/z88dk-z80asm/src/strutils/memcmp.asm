@@ -0,0 +1,68 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    SECTION TEXT
+
+    ; Number of CPI steps in the sequence, must be a power of 2
+    DEFC MEMCMP_UNROLL = 8
+
+    ; Compare the first BC bytes of the memory areas pointed by HL and DE.
+    ; The comparison jumps inside a sequence of MEMCMP_UNROLL CPI steps, the same
+    ; way memcpy does.
+    ; Parameters:
+    ;       HL - First memory area address
+    ;       DE - Second memory area address
+    ;       BC - Number of bytes to compare, can be 0
+    ; Returns:
+    ;       A - 0 if both areas are identical
+    ;           > 0 if the first different byte is greater in DE
+    ;           < 0 if the first different byte is greater in HL
+    ; Alters:
+    ;       A
+    PUBLIC memcmp
+memcmp:
+    ld a, b
+    or c
+    ret z
+    push hl
+    push de
+    push bc
+    ; Skip the first (-BC % MEMCMP_UNROLL) steps of the sequence, each step is 6 bytes long
+    ld a, c
+    neg
+    and MEMCMP_UNROLL - 1
+    push hl
+    add a
+    ld l, a
+    add a
+    add l
+    ld hl, _memcmp_steps
+    ; HL += A
+    add l
+    ld l, a
+    adc h
+    sub l
+    ld h, a
+    ex (sp), hl
+    ret
+_memcmp_steps:
+    REPT MEMCMP_UNROLL
+    ld a, (de)
+    cpi
+    jr nz, _memcmp_diff
+    inc de
+    ENDR
+    ; P/V flag is reset by CPI when BC reaches 0
+    jp pe, _memcmp_steps
+    xor a
+    jr _memcmp_end
+_memcmp_diff:
+    ; CPI already incremented HL, A still contains the byte from DE
+    dec hl
+    sub (hl)
+_memcmp_end:
+    pop bc
+    pop de
+    pop hl
+    ret
@@ -0,0 +1,62 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    SECTION TEXT
+
+    ; Number of LDI in the sequence, must be a power of 2
+    DEFC MEMCPY_UNROLL = 16
+    ; Copies smaller than this are done with LDIR
+    DEFC MEMCPY_MIN_UNROLLED = 32
+
+    ; Copy BC bytes from HL to DE, the result is the same as LDIR, including when the
+    ; destination overlaps the end of the source.
+    ; Small copies are performed with LDIR, bigger ones jump inside a sequence of
+    ; MEMCPY_UNROLL LDI instructions (16 T-states per byte instead of 21).
+    ; Parameters:
+    ;       HL - Source address
+    ;       DE - Destination address
+    ;       BC - Number of bytes to copy, can be 0
+    ; Returns:
+    ;       HL - Source address + BC
+    ;       DE - Destination address + BC
+    ;       BC - 0
+    ; Alters:
+    ;       A, BC, DE, HL
+    PUBLIC memcpy
+memcpy:
+    ld a, b
+    or a
+    jr nz, _memcpy_unrolled
+    or c
+    ret z
+    ; The cost of the jump inside the sequence is only worth it for bigger copies
+    cp MEMCPY_MIN_UNROLLED
+    jr nc, _memcpy_unrolled
+    ldir
+    ret
+_memcpy_unrolled:
+    ; Skip the first (-BC % MEMCPY_UNROLL) LDI instructions of the sequence so that the
+    ; remaining size is a multiple of MEMCPY_UNROLL after the first pass.
+    ; Each LDI instruction is 2 bytes long.
+    ld a, c
+    neg
+    and MEMCPY_UNROLL - 1
+    add a
+    push hl
+    ld hl, _memcpy_ldi
+    ; HL += A
+    add l
+    ld l, a
+    adc h
+    sub l
+    ld h, a
+    ex (sp), hl
+    ret
+_memcpy_ldi:
+    REPT MEMCPY_UNROLL
+    ldi
+    ENDR
+    ; P/V flag is reset by LDI when BC reaches 0
+    jp pe, _memcpy_ldi
+    ret
@@ -4,11 +4,16 @@
 
     SECTION TEXT
 
+    EXTERN memcpy
+
     ; Initialize the memory pointed by HL with the byte given in E.
+    ; The first byte is written, then propagated to the rest of the memory with memcpy.
     ; Parameters:
     ;       HL - Memory address to initialize
     ;       BC - Size of the memory to initialize
     ;       E  - Byte to initialize the memory with
+    ; Alters:
+    ;       A
     PUBLIC memset
 memset:
     ; Test that BC is not null
@@ -19,22 +24,14 @@ memset:
     push hl
     push de
     push bc
-    ; Put the character to fill the memory with in A and load HL with it
-    ld a, e
-    ld (hl), a
-    ; As we just filled the buffer with a byte, we have to decrement BC and
-    ; check once again whether it is null or not
+    ld (hl), e
+    ; As we just filled the buffer with a byte, we have one less byte to copy
     dec bc
-    ld a, b
-    or c
-    jp z, _memset_end
     ; DE (destination) must point to the address following HL
     ld d, h
     ld e, l
     inc de
-    ; Start the copy
-    ldir
- _memset_end:
+    call memcpy
     pop bc
     pop de
     pop hl
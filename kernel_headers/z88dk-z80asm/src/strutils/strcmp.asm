@@ -4,37 +4,39 @@
 
     SECTION TEXT
 
-    ; Compare two NULL-terminated strings pointed by HL and DE.
-    ; If they are identical, A will be 0
-    ; If DE is greater than HL, A will be positive
-    ; If HL is greater than DE, A will be negative
+    DEFC STRCMP_UNROLL = 4
+
+    ; Compare two NULL-terminated strings.
+    ; The loop is unrolled STRCMP_UNROLL times to save the branch back.
     ; Parameters:
-    ;   HL - First NULL-terminated string
-    ;   DE - Second NULL-terminated string
+    ;   HL - First NULL-terminated string address
+    ;   DE - Second NULL-terminated string address
     ; Returns:
-    ;   A - 0 if both are identical
-    ;       Negative value if HL > DE
-    ;       Positive value if HL < DE
+    ;   A - 0 if strings are identical
+    ;       > 0 if DE is greater than HL
+    ;       < 0 if HL is greater than DE
     ; Alters:
-    ;   A
+    ;       A
     PUBLIC strcmp
 strcmp:
     push hl
     push de
-    dec hl
-    dec de
 _strcmp_compare:
+    REPT STRCMP_UNROLL
+    ld a, (de)
+    cp (hl)
+    jr nz, _strcmp_diff
+    ; Both characters are identical, stop if we reached the end of the strings
+    or a
+    jr z, _strcmp_end
     inc hl
     inc de
-    ld a, (de)
+    ENDR
+    jp _strcmp_compare
+_strcmp_diff:
+    ; A still contains the character from DE
     sub (hl)
-    jr nz, _strcmp_end
-    ; Check if both strings have reached the end
-    ; If this is the case, or (hl) will reset in zero flag to be set
-    ; In that case, no need to continue, we can return, with flag Z set
-    or (hl)
-    jr nz, _strcmp_compare
 _strcmp_end:
     pop de
     pop hl
-    ret
\ No newline at end of file
+    ret
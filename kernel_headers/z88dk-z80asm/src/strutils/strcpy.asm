@@ -4,6 +4,8 @@
 
     SECTION TEXT
 
+    DEFC STRCPY_UNROLL = 4
+
     ; Function copying src string into dest, including the terminating null byte
     ; Parameters:
     ;   HL - source string
@@ -15,14 +17,19 @@ strcpy:
     push hl
     push bc
     push de
-    ld bc, 0xffff
+    ; LDI is faster than loading and storing the byte, BC is decremented but its
+    ; value doesn't matter
 _strcpy_loop:
+    REPT STRCPY_UNROLL
     ld a, (hl)
     ; Copy byte into de, even if it's null-byte
     ldi
     ; Test null-byte here
     or a
-    jp nz, _strcpy_loop
+    jr z, _strcpy_end
+    ENDR
+    jp _strcpy_loop
+_strcpy_end:
     pop de
     pop bc
     pop hl
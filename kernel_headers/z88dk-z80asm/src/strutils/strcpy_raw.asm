@@ -4,6 +4,8 @@
 
     SECTION TEXT
 
+    DEFC STRCPY_UNROLL = 4
+
     ; Function copying src string into dest, including the terminating null byte.
     ; This function does not save HL and DE.
     ; Parameters:
@@ -17,13 +19,18 @@
     PUBLIC strcpy_raw
 strcpy_raw:
     push bc
-    ld bc, 0xffff
+    ; LDI is faster than loading and storing the byte, BC is decremented but its
+    ; value doesn't matter
 _strcpy_loop:
+    REPT STRCPY_UNROLL
     ld a, (hl)
     ; Copy byte into de, even if it's null-byte
     ldi
     ; Test null-byte here
     or a
-    jp nz, _strcpy_loop
+    jr z, _strcpy_end
+    ENDR
+    jp _strcpy_loop
+_strcpy_end:
     pop bc
     ret
@@ -21,11 +21,9 @@ strncat:
     push bc
     xor a
     cpir
-    ; Test is BC is 0!
-    ld a, b
-    or c
+    ; Test is BC is 0, CPIR resets P/V flag in that case
     ld a, 1 ; In case of an error
-    jp z, _strncat_src_null
+    jp po, _strncat_src_null
     ; HL points to the address past the NULL-byte.
     ; Similarly, BC has counted the NULL-byte
     dec hl
@@ -33,24 +31,25 @@ strncat:
     ; We should now copy bytes until BC is 0 or [DE] is 0
     ex de, hl
 _strncat_copy:
-    xor a
-    or (hl)
+    ld a, (hl)
     ldi
-    jp z, _strncat_pop_de
-    ; Check if BC is 0
-    ld a, b
-    or c
+    ; Check if BC is 0 before `or a` overwrites P/V flag
+    jp po, _strncat_full
+    or a
     jp nz, _strncat_copy
-    ; BC is 0, terminate dst and return
+    ; We've met a null byte in src, which was copied successfully, A is 0
+    jr _strncat_pop_de
+_strncat_full:
+    ; BC is 0, success if the last byte copied was the null byte
+    or a
+    jr z, _strncat_pop_de
+    ; Terminate dst and return A > 0
+    xor a
     ld (de), a
-    ; We have to return A > 0 so increment
     inc a
 _strncat_pop_de:
     pop de
 _strncat_src_null:
-    ; We've met a null pointer in src, which was copied successfully
-    ; A is already 0, we can return
     pop bc
     pop hl
     ret
-
@@ -5,6 +5,7 @@
     SECTION TEXT
 
     ; Same as strcmp, but at most BC bytes will be read.
+    ; CPI is used to compare, increment HL and decrement BC in a single instruction.
     ; Parameters:
     ;   HL - First NULL-terminated string address
     ;   DE - Second NULL-terminated string address
@@ -17,27 +18,28 @@
     ;       A
     PUBLIC strncmp
 strncmp:
+    ld a, b
+    or c
+    ret z
     push hl
     push de
     push bc
-    dec hl
-    dec de
-    inc bc
 _strncmp_compare:
-    dec bc
-    inc hl
-    inc de
-    ld a, b
-    or c
-    jr z, _strncmp_end
     ld a, (de)
+    cpi
+    jr nz, _strncmp_diff
+    inc de
+    ; P/V flag is reset when BC reaches 0, test it before `or a` overwrites it
+    jp po, _strncmp_equal
+    or a
+    jp nz, _strncmp_compare
+_strncmp_equal:
+    xor a
+    jr _strncmp_end
+_strncmp_diff:
+    ; CPI already incremented HL, A still contains the character from DE
+    dec hl
     sub (hl)
-    jr nz, _strncmp_end
-    ; Check if both strings have reached the end
-    ; If this is the case, or (hl) will reset in zero flag to be set
-    ; In that case, no need to continue, we can return, with flag Z set
-    or (hl)
-    jr nz, _strncmp_compare
 _strncmp_end:
     pop bc
     pop de
@@ -4,6 +4,10 @@
 
     SECTION TEXT
 
+    EXTERN memcpy
+
+    DEFC STRCPY_UNROLL = 4
+
     ; Same as strcpy but if the source address is smaller than the given size,
     ; the destination buffer will be filled with NULL (\0) byte.
     ; Parameters:
@@ -23,30 +27,29 @@ strncpy:
     push de
     push bc
 _strncpy_loop:
+    REPT STRCPY_UNROLL
     ; Read the src byte, to check null-byte
     ld a, (hl)
-    ; We cannot use ldir here as we need to check the null-byte in src
+    ; We cannot use ldir here as we need to check the null-byte in src.
+    ; P/V flag is reset by LDI when BC reaches 0.
     ldi
+    jp po, _strncpy_end
     or a
-    jp z, _strncpy_zero
-    ld a, b
-    or c
-    jp nz, _strncpy_loop
+    jr z, _strncpy_zero
+    ENDR
+    jp _strncpy_loop
 _strncpy_end:
     pop bc
     pop de
     pop hl
     ret
 _strncpy_zero:
-    ; Here too, we have to test whether BC is 0 or not
-    ld a, b
-    or c
-    jp z, _strncpy_end
-    ; 0 has just been copied to dst (DE), we can reuse this null byte to fill
-    ; the end of the buffer using LDIR
-    ld hl, de
+    ; 0 has just been copied to dst (DE), BC is not 0, we can reuse this null byte
+    ; to fill the end of the buffer
+    ld h, d
+    ld l, e
     ; Make hl point to the null-byte we just copied
     dec hl
     ; Perform the copy
-    ldir
-    jp _strncpy_end
\ No newline at end of file
+    call memcpy
+    jp _strncpy_end
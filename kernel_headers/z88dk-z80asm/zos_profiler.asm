@@ -0,0 +1,36 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+    IFNDEF ZOS_PROFILER_H
+    DEFINE ZOS_PROFILER_H
+
+    ; This file represents the interface of the PC-sampling profiler driver, named "PROF".
+    ; When sampling, the profiler records the address interrupted by each V-blank interrupt.
+    ; The histogram can be read from the driver, for example with `cp #PROF B:/prof.bin`,
+    ; and symbolized on the host with `tools/zos_prof.py`.
+
+    ; prof_cmd_t: IOCTL commands of the profiler driver
+    DEFGROUP {
+        ; Clear the histogram and start sampling. The histogram page is allocated if necessary.
+        PROF_CMD_START = 0,
+        ; Stop sampling, the histogram can still be read
+        PROF_CMD_STOP,
+        ; Stop sampling and free the histogram page
+        PROF_CMD_FREE,
+
+        ; Number of commands above
+        PROF_CMD_COUNT
+    }
+
+    ; Layout of the histogram, as read from the driver:
+    ;   - 4096 16-bit counters, one per 16-byte block of the virtual address space
+    ;   - 256 16-bit counters, one per physical page the interrupted code was in
+    ;   - the header: magic "ZP", version, log2 of the block size and the 32-bit number of samples
+    ; All the values are little-endian, the counters saturate at 0xFFFF.
+    DEFC PROF_BUCKET_SHIFT = 4
+    DEFC PROF_PAGES_OFF    = 0x2000
+    DEFC PROF_HEADER_OFF   = 0x2200
+    DEFC PROF_DUMP_SIZE    = 0x2208
+
+    ENDIF ; ZOS_PROFILER_H
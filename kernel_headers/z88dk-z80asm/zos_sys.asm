@@ -102,7 +102,7 @@
     ;     char    c_def_disk;   // Upper case letter for the default disk
     ;     uint8_t c_max_driver; // Maximum number of driver loadable in the kernel
     ;     uint8_t c_max_dev;    // Maximum number of opened devices in the kernel
-    ;     uint8_t c_max_files;  // Maximum number of opened files in the kernel
+    ;     uint8_t c_max_files;  // Maximum number of opened files in the kernel, including the pool
     ;     uint16_t c_max_path;  // Maximum path length
     ;     void*    c_prog_addr; // Virtual address where user programs are loaded
     ;     char*    c_prog_path;  // Path to where user prog
@@ -117,6 +117,46 @@
     ; program finishes its execution
     DEFC EXEC_PRESERVE_PROGRAM = 1
 
+    ; @brief Execute the program in a new background job when invoking `exec`, the caller keeps
+    ; running once the new job blocks or yields. Only available when the kernel is compiled with
+    ; background jobs support.
+    DEFC EXEC_BACKGROUND_PROGRAM = 2
+
+    ; @brief Job statistics, filled by the `jobstat` syscall:
+    ; typedef struct {
+    ;     uint8_t  j_state;     // 0 if the job doesn't exist, non-zero else
+    ;     uint16_t j_slices;    // Number of times the job was scheduled
+    ;     uint32_t j_cpu;       // CPU time spent in the job, in milliseconds (0 if no timer)
+    ;     char     j_name[16];  // Name of the job, not NULL-terminated if it is 16 characters long
+    ; } zos_job_stat_t;
+    DEFC ZOS_JOB_STATE_OFF  = 0
+    DEFC ZOS_JOB_SLICES_OFF = 1
+    DEFC ZOS_JOB_CPU_OFF    = 3
+    DEFC ZOS_JOB_NAME_OFF   = 7
+    DEFC ZOS_JOB_STAT_SIZE  = 23
+
+    ; @brief Descriptor of an operation executed by the `batch` syscall:
+    ; typedef struct {
+    ;     uint8_t  b_op;      // Syscall number, from read (0) to mount (14)
+    ;     uint8_t  b_h;       // Value of register H (dev, flags for open, ...)
+    ;     uint8_t  b_a;       // Value of register A (whence for seek)
+    ;     uint8_t  b_ret;     // Filled with the value returned in A
+    ;     uint16_t b_de;      // Value of register DE (buffer)
+    ;     uint16_t b_bc;      // Value of register BC (size, path), filled with BC for read and write
+    ;     uint32_t b_off;     // Offset for seek (BCDE), filled with the new offset
+    ; } zos_batch_t;
+    DEFC ZOS_BATCH_OP_OFF  = 0
+    DEFC ZOS_BATCH_H_OFF   = 1
+    DEFC ZOS_BATCH_A_OFF   = 2
+    DEFC ZOS_BATCH_RET_OFF = 3
+    DEFC ZOS_BATCH_DE_OFF  = 4
+    DEFC ZOS_BATCH_BC_OFF  = 6
+    DEFC ZOS_BATCH_OFF_OFF = 8
+    DEFC ZOS_BATCH_SIZE    = 12
+
+    ; @brief Flag for the `batch` syscall, stop at the first operation that fails
+    DEFC BATCH_STOP_ON_ERROR = 1
+
 
     ; @brief Macro to abstract the syscall instruction
     MACRO SYSCALL
@@ -475,14 +515,18 @@
     ;   BC - File to load and execute. The string must be NULL-terminated and must not cross boundaries.
     ;   DE - String argument to give to the program to execute, must be NULL-terminated. Can be NULL.
     ;   H - Mode marking whether the current program shall be preserved in RAM or overwritten by sub-program.
-    ;       Can be either `EXEC_OVERRIDE_PROGRAM` or `EXEC_PRESERVE_PROGRAM`.
+    ;       Can be either `EXEC_OVERRIDE_PROGRAM`, `EXEC_PRESERVE_PROGRAM` or `EXEC_BACKGROUND_PROGRAM`.
     ; Returns:
     ;   A - When invoked with `EXEC_OVERRIDE_PROGRAM`, returns only on error
     ;       When invoked with `EXEC_PRESERVE_PROGRAM`, returns ERR_SUCCESS when the sub-program was executed
     ;       successfully (regardless of its returned value), error code else. If error code is ERR_CANNOT_REGISTER_MORE,
     ;       the maximum depth has been reached, the current program cannot execute a program while being preserved in
     ;       memory. In that case, it shall either exit, either execute the sub-program with `EXEC_OVERRIDE_PROGRAM`.
+    ;       When invoked with `EXEC_BACKGROUND_PROGRAM`, returns ERR_SUCCESS once the job has been started,
+    ;       ERR_CANNOT_REGISTER_MORE if the maximum number of jobs is reached, error code else.
+    ;       Background jobs cannot use `EXEC_PRESERVE_PROGRAM`, ERR_NOT_SUPPORTED is returned.
     ;   D - Sub-program exit value, when invoked with `EXEC_PRESERVE_PROGRAM`.
+    ;       Index of the new job, when invoked with `EXEC_BACKGROUND_PROGRAM`.
     ; Alters:
     ;   Contrarily to other syscalls, invoking EXEC() will not preserve AF, BC, DE, IX, IY.
     ;   Only HL is guaranteed to be preserved.
@@ -651,6 +695,76 @@
     ENDM
 
 
+    ; @brief Give the CPU to the next background job ready to run, if any. The current program
+    ;        continues its execution the next time it is scheduled.
+    ;        Can be invoked with YIELD().
+    ;
+    ; Parameters:
+    ;   None
+    ; Returns:
+    ;   A - ERR_SUCCESS
+    MACRO  YIELD  _
+        ld l, 27
+        SYSCALL
+    ENDM
+
+
+    ; @brief Get the statistics of a job: its name, the number of times it was scheduled and
+    ;        the CPU time it used. Job 0 is the foreground job.
+    ;        Can be invoked with JOBSTAT().
+    ;
+    ; Parameters:
+    ;   H  - Index of the job
+    ;   DE - Address of the structure to fill, at least ZOS_JOB_STAT_SIZE bytes big
+    ; Returns:
+    ;   A - ERR_SUCCESS on success
+    ;       ERR_INVALID_PARAMETER if the index is out of range
+    ;       ERR_NO_SUCH_ENTRY if the job doesn't exist
+    ;       ERR_NOT_SUPPORTED if the kernel doesn't support background jobs
+    MACRO  JOBSTAT  _
+        ld l, 28
+        SYSCALL
+    ENDM
+
+
+    ; @brief Execute several file and directory operations in a single syscall. Each operation
+    ;        is described by a `zos_batch_t` descriptor, containing the syscall number and the
+    ;        value of its parameters. This saves the cost of entering the kernel for each small
+    ;        read, write, seek or stat.
+    ;        Can be invoked with BATCH().
+    ;
+    ; Parameters:
+    ;   DE - Array of descriptors, must not cross a page boundary
+    ;   B  - Number of descriptors in the array
+    ;   C  - Flags, `BATCH_STOP_ON_ERROR` to stop at the first operation that fails
+    ; Returns:
+    ;   A - ERR_SUCCESS if all the operations succeeded, error of the first failing operation else
+    ;   B - Number of operations executed
+    MACRO  BATCH  _
+        ld l, 29
+        SYSCALL
+    ENDM
+
+
+    ; @brief Reserve room on the disk for an opened file, before writing to it. The following
+    ;        writes, up to the given size, won't need to allocate any space on the disk. When
+    ;        the file system supports it, the space is reserved as a contiguous area if possible.
+    ;        If the given size is smaller than the file size, the file is truncated. Else, the
+    ;        file size is not modified.
+    ;        Can be invoked with PREALLOCATE().
+    ;
+    ; Parameters:
+    ;   H - Opened file dev, it must have been opened with write flags
+    ;   BCDE - 32-bit size to reserve
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, ERR_NOT_SUPPORTED if the file system doesn't support it,
+    ;       error code else
+    MACRO  PREALLOCATE  _
+        ld l, 30
+        SYSCALL
+    ENDM
+
+
     ; @brief Get a read-only pointer to the kernel configuration.
     ;
     ; Parameters:
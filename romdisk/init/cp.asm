@@ -50,6 +50,20 @@ cp_main:
     jp m, _cp_error_close
     ld e, a
     push de
+    ; Reserve the size of the source file on the destination disk at once, so that the file
+    ; is not grown page by page while writing. This is only a hint, ignore the errors.
+    ld h, d
+    ld de, STATIC_BUFFER
+    DSTAT()
+    or a
+    jr nz, _cp_loop
+    pop de
+    push de
+    ld h, e
+    ; The size is right after the flags in the stat structure
+    ld de, (STATIC_BUFFER + 1)
+    ld bc, (STATIC_BUFFER + 3)
+    PREALLOCATE()
 _cp_loop:
     pop de
     push de
@@ -11,6 +11,14 @@
         DEFC CURDIR_COLOR = TEXT_COLOR_LIGHT_GRAY
         DEFC TEXT_COLOR   = TEXT_COLOR_WHITE
 
+        ; BSS must end before 0x8000, used as a 16KB buffer by `less` and `xfer`
+        DEFC BSS_ADDR     = 0x7000
+        DEFC BSS_END_MAX  = 0x8000
+
+        ; Provided by the linker
+        EXTERN __DATA_tail
+        EXTERN __BSS_tail
+
         ; Designate the order of the sections before starting the code
         ; We can name the sections whatever we want, but it has to match
         ; across all the files
@@ -22,8 +30,8 @@
         SECTION BSS
         ; Give a hardcoded address to the BSS section so that it is not put inside the TEXT
         ; binary (and init.bin file is then smaller)
-        ; This value should be adapted if the TEXT section grows bigger.
-        ORG 0x6000
+        ; The TEXT and DATA sections must not overlap it, this is checked at link time below.
+        ORG BSS_ADDR
         ; ----------------  END  ----------------;
 
         ; Start the actual code
@@ -38,6 +46,22 @@
         ENDM
 
         EXTERN parse_exec_cmd
+        EXTERN bg_exec_de
+
+        ; Entry point of the shell. When started in a background job, the command line to
+        ; execute is given as a parameter: execute it and exit.
+        ; Parameters:
+        ;       DE - Command line
+        ;       BC - Length of the command line, 0 if no parameter was given
+init_main:
+        ld a, b
+        or c
+        ; Any non-zero value marks the shell as running in the background
+        ld (background_job), a
+        jr z, next_command
+        call parse_exec_cmd
+        ld h, 0
+        EXIT()
 
 next_command:
         ; Set STDIN mode to cooked
@@ -76,6 +100,26 @@ next_command:
         ld l, e
         add hl, bc
         ld (hl), 0
+        ; A trailing '&' executes the command in a background job, remove it and
+        ; the spaces before it
+        dec hl
+        ld a, (hl)
+        cp '&'
+        jr nz, next_command_parse
+_next_command_strip:
+        ld (hl), 0
+        or a
+        sbc hl, de
+        add hl, de
+        jr z, _next_command_background
+        dec hl
+        ld a, (hl)
+        cp ' '
+        jr z, _next_command_strip
+_next_command_background:
+        call bg_exec_de
+        jp next_command
+next_command_parse:
         ; We can now parse the command line
         call parse_exec_cmd
         jp next_command
@@ -191,6 +235,9 @@ _promptlen_loop_end:
         SECTION BSS
 curdir: DEFS PATH_MAX + 1
 curdir_len: DEFS 2
+        ; Non-zero when this shell runs in a background job
+        PUBLIC background_job
+background_job: DEFS 1
 bigbuffer: DEFS 81
 bigbuffer_end:
         ; Allocate a few more bytes so that we can append some characters
@@ -199,4 +246,9 @@ bigbuffer_end:
         PUBLIC init_static_buffer
         PUBLIC init_static_buffer_end
 init_static_buffer: DEFS 1024
-init_static_buffer_end:
\ No newline at end of file
+init_static_buffer_end:
+
+        ; Make sure the code and data don't spill into the BSS, and that the BSS doesn't
+        ; reach the buffer shared by the commands
+        ASSERT(__DATA_tail <= BSS_ADDR)
+        ASSERT(__BSS_tail <= BSS_END_MAX)
@@ -0,0 +1,234 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+        INCLUDE "zos_sys.asm"
+        INCLUDE "strutils_h.asm"
+
+        SECTION TEXT
+
+        EXTERN error_print
+
+        ; Offset of the `c_prog_path` field in the kernel configuration
+        DEFC CONFIG_PROG_PATH_OFF = 10
+        ; The kernel supports at most 8 jobs
+        DEFC MAX_JOBS = 8
+
+        ; Execute a command line in a new background job. The job runs another instance
+        ; of this shell, which executes the command and exits.
+        ; Parameters:
+        ;       DE - Command line, without the trailing '&'
+        ; Returns:
+        ;       None
+        ; Alters:
+        ;       A, BC, DE, HL
+        PUBLIC bg_exec_de
+bg_exec_de:
+        ; Nothing to do if the command is empty
+        ld a, (de)
+        or a
+        ret z
+        ; Get the path of the shell from the kernel configuration
+        KERNEL_CONFIG(hl)
+        ld bc, CONFIG_PROG_PATH_OFF
+        add hl, bc
+        ld c, (hl)
+        inc hl
+        ld b, (hl)
+        ld h, EXEC_BACKGROUND_PROGRAM
+        push ix
+        push iy
+        EXEC()
+        pop iy
+        pop ix
+        or a
+        jr nz, _bg_exec_error
+        ; Print the index of the new job, in D
+        ld a, d
+        add '0'
+        ld (bg_msg_id), a
+        S_WRITE3(DEV_STDOUT, bg_msg, bg_msg_end - bg_msg)
+        ret
+_bg_exec_error:
+        ld de, bg_err_msg
+        ld bc, bg_err_msg_end - bg_err_msg
+        jp error_print
+
+bg_msg: DEFM "["
+bg_msg_id: DEFM "0]\n"
+bg_msg_end:
+bg_err_msg: DEFM "error starting job: "
+bg_err_msg_end:
+
+
+        ; "jobs" command main function, list the jobs with their CPU time and the
+        ; number of time they were scheduled.
+        ; Parameters:
+        ;       HL - ARGV
+        ;       BC - ARGC
+        ; Returns:
+        ;       A - 0 on success
+        PUBLIC jobs_main
+jobs_main:
+        S_WRITE3(DEV_STDOUT, jobs_header, jobs_header_end - jobs_header)
+        ld b, 0
+_jobs_main_loop:
+        push bc
+        ld h, b
+        ld de, job_stat
+        JOBSTAT()
+        pop bc
+        cp ERR_NO_SUCH_ENTRY
+        jr z, _jobs_main_next
+        ; Any other error means we reached the end of the jobs, or that the kernel doesn't support them
+        or a
+        jr nz, _jobs_main_end
+        push bc
+        call _jobs_print_entry
+        pop bc
+_jobs_main_next:
+        inc b
+        ld a, b
+        cp MAX_JOBS
+        jr nz, _jobs_main_loop
+        xor a
+        ret
+_jobs_main_end:
+        ; ERR_INVALID_PARAMETER marks the end of the table
+        cp ERR_INVALID_PARAMETER
+        jr z, _jobs_main_success
+        ld de, 0
+        call error_print
+        ld a, 1
+        ret
+_jobs_main_success:
+        xor a
+        ret
+
+        ; Print the job whose statistics are in `job_stat`
+        ; Parameters:
+        ;       B - Index of the job
+_jobs_print_entry:
+        ld de, job_line
+        ld a, '['
+        ld (de), a
+        inc de
+        ld a, b
+        add '0'
+        ld (de), a
+        inc de
+        ld a, ']'
+        ld (de), a
+        inc de
+        ; CPU time, 32-bit value
+        ld hl, job_stat + ZOS_JOB_CPU_OFF
+        call dword_to_ascii_dec
+        ex de, hl
+        ld (hl), ' '
+        inc hl
+        ld (hl), 'm'
+        inc hl
+        ld (hl), 's'
+        inc hl
+        ex de, hl
+        ; Number of slices, extend it to 32-bit in place, the CPU time is not needed anymore
+        ld hl, (job_stat + ZOS_JOB_SLICES_OFF)
+        ld (job_stat + ZOS_JOB_CPU_OFF), hl
+        ld hl, 0
+        ld (job_stat + ZOS_JOB_CPU_OFF + 2), hl
+        ld hl, job_stat + ZOS_JOB_CPU_OFF
+        call dword_to_ascii_dec
+        ld a, ' '
+        ld (de), a
+        inc de
+        ; Name of the job, at most 16 characters
+        ld hl, job_stat + ZOS_JOB_NAME_OFF
+        ld b, ZOS_JOB_STAT_SIZE - ZOS_JOB_NAME_OFF
+_jobs_print_name:
+        ld a, (hl)
+        or a
+        jr z, _jobs_print_name_end
+        ld (de), a
+        inc hl
+        inc de
+        djnz _jobs_print_name
+_jobs_print_name_end:
+        ld a, '\n'
+        ld (de), a
+        inc de
+        ; Calculate the length of the line
+        ex de, hl
+        ld de, job_line
+        or a
+        sbc hl, de
+        ld b, h
+        ld c, l
+        S_WRITE1(DEV_STDOUT)
+        ret
+
+jobs_header: DEFM "job     cpu time    slices name\n"
+jobs_header_end:
+
+
+        ; "fg" command main function, wait for the given job to finish. The other jobs
+        ; keep running while waiting.
+        ; Parameters:
+        ;       HL - ARGV
+        ;       BC - ARGC
+        ; Returns:
+        ;       A - 0 on success
+        PUBLIC fg_main
+fg_main:
+        ld a, c
+        cp 2
+        jr nz, _fg_usage
+        inc hl
+        inc hl
+        ld a, (hl)
+        inc hl
+        ld h, (hl)
+        ld l, a
+        call parse_int
+        or a
+        jr nz, _fg_usage
+        ; The foreground job cannot be waited for
+        ld a, h
+        or a
+        jr nz, _fg_usage
+        or l
+        jr z, _fg_usage
+        ld b, l
+_fg_main_loop:
+        push bc
+        YIELD()
+        pop bc
+        ld h, b
+        ld de, job_stat
+        push bc
+        JOBSTAT()
+        pop bc
+        or a
+        jr z, _fg_main_loop
+        ; The job doesn't exist (anymore)
+        cp ERR_NO_SUCH_ENTRY
+        jr nz, _fg_error
+        xor a
+        ret
+_fg_error:
+        ld de, 0
+        call error_print
+        ld a, 2
+        ret
+_fg_usage:
+        S_WRITE3(DEV_STDOUT, fg_usage, fg_usage_end - fg_usage)
+        ld a, 1
+        ret
+
+fg_usage: DEFM "usage: fg <job>\n"
+fg_usage_end:
+
+
+        SECTION BSS
+job_stat: DEFS ZOS_JOB_STAT_SIZE
+        ; "[N]", CPU time, " ms", slices, ' ', name and '\n'
+job_line: DEFS 3 + 10 + 3 + 10 + 1 + 16 + 1
@@ -12,6 +12,25 @@
         DEFC PAGE3_ADDR    = 0x8000
         DEFC PAGE3_SIZE    = 16384
 
+        ; The file is not loaded at once, only a window of it is kept in the third page.
+        ; It is reloaded, with a single seek and read, when the top line gets too close
+        ; to its end or when scrolling up before its beginning.
+        DEFC WINDOW_ADDR   = PAGE3_ADDR
+        DEFC WINDOW_SIZE   = 12288
+        ; Reload the window when fewer bytes than this remain after the top line
+        DEFC WINDOW_MARGIN = WINDOW_SIZE / 2
+        ; Bytes kept before the top line when reloading the window without the index
+        DEFC WINDOW_BACK   = WINDOW_SIZE - WINDOW_MARGIN
+
+        ; The rest of the page holds a sparse index of 32-bit line offsets, built as the user
+        ; scrolls down: entry i is the offset of line (i << index_shift). When it is full, every
+        ; other entry is dropped and the step is doubled.
+        DEFC INDEX_ADDR       = WINDOW_ADDR + WINDOW_SIZE
+        DEFC INDEX_MAX        = (PAGE3_SIZE - WINDOW_SIZE) / 4
+        DEFC INDEX_SHIFT_INIT = 4
+        ; Value of `top_line` when the number of the top line is not known
+        DEFC LINE_UNKNOWN     = 0xffff
+
         ; A static buffer that can be used across the commands implementation
         EXTERN init_static_buffer
         EXTERN init_static_buffer_end
@@ -21,6 +40,8 @@
         DEFC COMMAND_QUIT        = KB_KEY_Q
         DEFC COMMAND_SCROLL_UP   = KB_UP_ARROW
         DEFC COMMAND_SCROLL_DOWN = KB_DOWN_ARROW
+        DEFC COMMAND_JUMP_START  = KB_HOME
+        DEFC COMMAND_JUMP_END    = KB_END
 
         ; "less" command main function
         ; Parameters:
@@ -53,34 +74,47 @@ less_main:
         ; Get the number of characters on screen
         call get_screen_characters_count
         or a
-        jr nz, ioctl_error
+        jp nz, ioctl_error
         ; Set the input to RAW
         call set_stdin_mode
-        jr nz, ioctl_error
+        jp nz, ioctl_error
         ; Reset the print buffer by simulating a CR
         call print_char_cr
-        ; Save the number of characters on screen
+        ; Get the size of the file, required to jump to its end
         ld a, (file_fd)
         ld h, a
-        ; FIXME: Use the global buffer instead of the third page, to allow files
-        ; bigger than 16KB
-        ld de, PAGE3_ADDR
-        ld (buffer_from), de
-        ld bc, PAGE3_SIZE
-        READ()
-        ; Check for a potential error
+        ld de, init_static_buffer
+        DSTAT()
         or a
         jp nz, read_error
-        ; Save the number of characters read (file size)
-        ld hl, PAGE3_ADDR
-        add hl, bc
-        ld (buffer_filled), hl
-_less_clear_and_print:
-        ; Clear the screen and print the characters from the file
+        ld hl, init_static_buffer + 1
+        ld de, file_size
+        ld bc, 4
+        ldir
+        ; The index starts with line 0, at offset 0
+        ld hl, INDEX_ADDR
+        ld b, 4
+_less_index_init:
+        ld (hl), 0
+        inc hl
+        djnz _less_index_init
+        ld hl, 1
+        ld (index_count), hl
+        ld a, INDEX_SHIFT_INIT
+        ld (index_shift), a
+        ; Only load the beginning of the file, whatever its size
+        call jump_start
+        or a
+        jr nz, _less_io_error
+        ; Clear the screen once and check whether the lines can be drawn with blits
         call clear_set_cursor
         or a
-        jr nz, ioctl_error
-        call print_buffer
+        jp nz, ioctl_error
+        call blit_detect
+_less_redraw:
+        call redraw_screen
+        or a
+        jp nz, ioctl_error
         ; Set the cursor to the bottom of the screen and listen on the keyboard
 _less_wait_command:
         call listen_on_input
@@ -91,14 +125,50 @@ _less_wait_command:
         jr z, _less_scroll_up
         cp COMMAND_SCROLL_DOWN
         jr z, _less_scroll_down
+        cp COMMAND_JUMP_START
+        jr z, _less_jump_start
+        cp COMMAND_JUMP_END
+        jr z, _less_jump_end
         ; Unknown command, try again
         jr _less_wait_command
 _less_scroll_up:
+        xor a
+        ld (moved), a
         call scroll_up
-        jr _less_clear_and_print
+        ld l, -1
+        jr _less_check_scroll
 _less_scroll_down:
+        xor a
+        ld (moved), a
         call scroll_down
-        jr _less_clear_and_print
+        ld l, 1
+_less_check_scroll:
+        or a
+        jr nz, _less_io_error
+        ; Nothing to draw if the top line didn't change
+        ld a, (moved)
+        or a
+        jr z, _less_wait_command
+        ld a, l
+        call scroll_screen
+        or a
+        jp nz, ioctl_error
+        jp _less_wait_command
+_less_jump_start:
+        call jump_start
+        jr _less_check_error
+_less_jump_end:
+        call jump_end
+_less_check_error:
+        or a
+        jp z, _less_redraw
+_less_io_error:
+        ; read_error closes the file, it expects its dev in H
+        ld b, a
+        ld a, (file_fd)
+        ld h, a
+        ld a, b
+        jp read_error
 _less_end:
         ; On exit, clear the screen and set the cursor back
         call clear_set_cursor
@@ -200,14 +270,118 @@ get_current_buffer_size:
         ret
 
 
+        ; Load a window of the file, starting at the given offset
+        ; Parameters:
+        ;   HL - Address of the 32-bit offset of the window in the file
+        ; Returns:
+        ;   A - ERR_SUCCESS on success, error code else
+        ;   [buffer_from] - Beginning of the window
+load_window:
+        ld de, win_off
+        ld bc, 4
+        ldir
+        ; Seek to the offset, BCDE must contain it
+        ld de, (win_off)
+        ld bc, (win_off + 2)
+        ld a, (file_fd)
+        ld h, a
+        ld a, SEEK_SET
+        SEEK()
+        or a
+        ret nz
+        ld a, (file_fd)
+        ld h, a
+        ld de, WINDOW_ADDR
+        ld bc, WINDOW_SIZE
+        READ()
+        or a
+        ret nz
+        ld hl, WINDOW_ADDR
+        ld (buffer_from), hl
+        add hl, bc
+        ld (buffer_filled), hl
+        ; If fewer bytes than requested were read, the window reaches the end of the file.
+        ; The carry was cleared by the previous add.
+        ld hl, WINDOW_SIZE
+        sbc hl, bc
+        ld a, h
+        or l
+        ld (win_eof), a
+        xor a
+        ret
+
+
+        ; Get the offset, in the file, of the line at the top of the screen
+        ; Parameters:
+        ;   None
+        ; Returns:
+        ;   HL - Address of the 32-bit offset (tmp_off)
+        ; Alters:
+        ;   A, DE, HL
+get_top_offset:
+        ld hl, (buffer_from)
+        ld de, -WINDOW_ADDR
+        add hl, de
+        ld de, (win_off)
+        add hl, de
+        ld (tmp_off), hl
+        ld hl, (win_off + 2)
+        ld de, 0
+        adc hl, de
+        ld (tmp_off + 2), hl
+        ld hl, tmp_off
+        ret
+
+
+        ; Check whether the window starts at the beginning of the file
+        ; Returns:
+        ;   Z flag - Set if the window starts at offset 0
+        ; Alters:
+        ;   A, HL
+win_off_is_zero:
+        ld hl, win_off
+        ld a, (hl)
+        inc hl
+        or (hl)
+        inc hl
+        or (hl)
+        inc hl
+        or (hl)
+        ret
+
+
+        ; Make sure that enough bytes follow the top line in the window, else reload the
+        ; window so that it starts at the top line.
+        ; Returns:
+        ;   A - ERR_SUCCESS on success, error code else
+ensure_window:
+        ld a, (win_eof)
+        or a
+        jr nz, _ensure_window_ok
+        call get_current_buffer_size
+        ld hl, WINDOW_MARGIN
+        or a
+        sbc hl, bc
+        jr c, _ensure_window_ok
+        call get_top_offset
+        jp load_window
+_ensure_window_ok:
+        xor a
+        ret
+
+
         ; Scroll the screen down by looking for the next \n character in the buffer. Let's allow scrolling, even if
         ; the file doesn't reach the bottom of the screen, this will ease the algorithm since we don't need to perform
         ; any further check.
         ; Parameters:
         ;   None
         ; Returns:
+        ;   A - ERR_SUCCESS on success, error code else
         ;   [buffer_from] - Address of the next line
 scroll_down:
+        call ensure_window
+        or a
+        ret nz
         call get_current_buffer_size
         ret z
         ; Look for the next new line character
@@ -216,52 +390,631 @@ scroll_down:
         cpir
         ; If Z is set, we found a newline and the HL points to the character right after
         ; else, we didn't find it, we can return, we cannot scroll further down
-        ret nz
+        jr nz, _scroll_down_end
         ld (buffer_from), hl
+        ld a, 1
+        ld (moved), a
+        ; Update the line number if it is known and add the line to the index
+        ld hl, (top_line)
+        ld a, h
+        and l
+        inc a
+        ret z
+        inc hl
+        ld (top_line), hl
+        call index_record
+_scroll_down_end:
+        xor a
         ret
 
 
-        ; Scroll the screen up by looking for the previous \n character in the buffer.
+        ; Record the offset of the top line in the index if its number is a multiple of
+        ; the index step and if it is the next entry to fill.
+        ; Parameters:
+        ;   HL - Number of the top line
+index_record:
+        push hl
+        ; Divide the line number by the step, any bit shifted out means it's not a multiple
+        ld a, (index_shift)
+        ld b, a
+_index_record_shift:
+        srl h
+        rr l
+        jr c, _index_record_pop
+        djnz _index_record_shift
+        ; HL is the entry number, check that it is the next one
+        ld de, (index_count)
+        or a
+        sbc hl, de
+        jr nz, _index_record_pop
+        ; If the index is full, drop every other entry and try again with the new step
+        ld a, d
+        cp INDEX_MAX >> 8
+        jr nz, _index_record_store
+        call index_compact
+        pop hl
+        jr index_record
+_index_record_store:
+        pop hl
+        push de
+        call get_top_offset
+        pop hl
+        ; Increment the number of entries, the new one is at INDEX_ADDR + count * 4
+        ld d, h
+        ld e, l
+        inc de
+        ld (index_count), de
+        add hl, hl
+        add hl, hl
+        ld de, INDEX_ADDR
+        add hl, de
+        ex de, hl
+        ld hl, tmp_off
+        ld bc, 4
+        ldir
+        ret
+_index_record_pop:
+        pop hl
+        ret
+
+
+        ; Keep the even entries of the full index only and double its step.
+index_compact:
+        ld hl, INDEX_ADDR
+        ld de, INDEX_ADDR
+        ld bc, INDEX_MAX / 2
+_index_compact_loop:
+        push bc
+        ld bc, 4
+        ldir
+        ; Skip the odd entry
+        ld c, 4
+        add hl, bc
+        pop bc
+        dec bc
+        ld a, b
+        or c
+        jr nz, _index_compact_loop
+        ld hl, INDEX_MAX / 2
+        ld (index_count), hl
+        ld hl, index_shift
+        inc (hl)
+        ret
+
+
+        ; Look for the beginning of the line preceding the top line, in the window.
         ; Parameters:
         ;   None
         ; Returns:
-        ;   [buffer_from] - Address of the previous line
-scroll_up:
-        ; Check if the buffer isn't already at the top
+        ;   HL - Address of the previous line
+        ;   Z flag - Set if the top line is the first line of the file
+        ;   Carry flag - Set if the previous line doesn't start in the window
+window_prev_line:
         ld de, (buffer_from)
-        ld hl, -PAGE3_ADDR
+        ld hl, -WINDOW_ADDR
         ; Add doesn't affect Z flag, ADC does...
         or a
         adc hl, de
-        ret z   ; Already at the top if both are equal
-        ; Put buffer_from back at in HL, DE contains the size
+        jr z, _window_prev_at_start
+        ; Put buffer_from back at in HL, BC contains the size
+        ld b, h
+        ld c, l
         ex de, hl
-        ld b, d
-        ld c, e
         ; Look for the previous new line character, BEFORE the current line
         dec hl  ; should point to '\n'
         dec bc
-        ; If BC is 0, the file starts with a \n directly, e.g. "\nb"
+        ; If BC is 0, the window starts with a \n directly, e.g. "\nb"
         ld a, b
         or c
-        jr z, _scroll_up_store
+        jr z, _window_prev_start
         dec hl  ; should point to the last character of the previous line
         dec bc
-        ; If BC is 0, the file starts with a 2-character line, e.g. "a\nb"
+        ; If BC is 0, the window starts with a 2-character line, e.g. "a\nb"
         ld a, b
         or c
-        jr z, _scroll_up_store
+        jr z, _window_prev_start
         ld a, '\n'
         cpdr
         ; If Z is set, we found a newline and the HL points to the character right before
-        ; else, we didn't find it, HL points to the beginning of the buffer
-        jr nz, _scroll_up_store
+        jr nz, _window_prev_start
         inc hl ; points to \n
         inc hl ; points to the previous line first character
-_scroll_up_store:
+        ; A is not 0, clear the Z and carry flags
+        or a
+        ret
+_window_prev_start:
+        ; No new line before, the previous line starts at the beginning of the window,
+        ; only if the window is the beginning of the file
+        call win_off_is_zero
+        jr nz, _window_prev_not_found
+        ld hl, WINDOW_ADDR
+        inc a
+        ret
+_window_prev_at_start:
+        call win_off_is_zero
+        ret z
+_window_prev_not_found:
+        scf
+        ret
+
+
+        ; Scroll the screen up by looking for the previous \n character in the buffer.
+        ; Parameters:
+        ;   None
+        ; Returns:
+        ;   A - ERR_SUCCESS on success, error code else
+        ;   [buffer_from] - Address of the previous line
+scroll_up:
+        call window_prev_line
+        ; Already at the top of the file, A is 0
+        ret z
+        jr c, _scroll_up_reload
         ld (buffer_from), hl
+        jr _scroll_up_line
+_scroll_up_reload:
+        call reload_before_top
+        or a
+        ret nz
+_scroll_up_line:
+        ld a, 1
+        ld (moved), a
+        ; Update the line number if it is known
+        ld hl, (top_line)
+        ld a, h
+        and l
+        inc a
+        ret z
+        dec hl
+        ld (top_line), hl
+        xor a
         ret
 
+
+        ; Reload the window so that it contains the line preceding the top line. If the number
+        ; of the top line is known, the window is loaded from the closest index entry, else it
+        ; is loaded a bit before the top line.
+        ; Parameters:
+        ;   None
+        ; Returns:
+        ;   A - ERR_SUCCESS on success, error code else
+        ;   [buffer_from] - Address of the previous line
+reload_before_top:
+        ; Save the offset of the top line, the window is going to be overwritten
+        call get_top_offset
+        ld de, saved_top
+        ld bc, 4
+        ldir
+        ld hl, (top_line)
+        ld a, h
+        and l
+        inc a
+        jr z, _reload_backward
+        ; Look for the entry of the previous line, T = top_line - 1, entry = T >> index_shift
+        dec hl
+        push hl
+        ld a, (index_shift)
+        ld b, a
+_reload_entry_shift:
+        srl h
+        rr l
+        djnz _reload_entry_shift
+        ld de, (index_count)
+        ld a, l
+        sub e
+        ld a, h
+        sbc d
+        jr nc, _reload_backward_pop
+        push hl
+        add hl, hl
+        add hl, hl
+        ld de, INDEX_ADDR
+        add hl, de
+        call load_window
+        pop de
+        pop hl
+        or a
+        ret nz
+        ; Number of lines to skip from the entry: T - (entry << index_shift)
+        ld a, (index_shift)
+        ld b, a
+_reload_line_shift:
+        sla e
+        rl d
+        djnz _reload_line_shift
+        or a
+        sbc hl, de
+        ex de, hl
+        ld hl, WINDOW_ADDR
+_reload_skip:
+        ld a, d
+        or e
+        jr z, _reload_skip_done
+        ; BC = bytes remaining in the window after HL
+        push de
+        ex de, hl
+        ld hl, (buffer_filled)
+        or a
+        sbc hl, de
+        ld b, h
+        ld c, l
+        ex de, hl
+        pop de
+        ld a, b
+        or c
+        jr z, _reload_backward
+        ld a, '\n'
+        cpir
+        ; Lines too long to fit in the window, fall back to the other method
+        jr nz, _reload_backward
+        dec de
+        jr _reload_skip
+_reload_skip_done:
+        ld (buffer_from), hl
+        xor a
+        ret
+_reload_backward_pop:
+        pop hl
+_reload_backward:
+        ; Load the window WINDOW_BACK bytes before the top line, or at offset 0 if
+        ; the top line is closer to the beginning of the file. DE is the distance.
+        ld de, WINDOW_BACK
+        ld hl, (saved_top + 2)
+        ld a, h
+        or l
+        jr nz, _reload_backward_load
+        ld hl, (saved_top)
+        sbc hl, de
+        jr nc, _reload_backward_load
+        ld de, (saved_top)
+_reload_backward_load:
+        ld hl, (saved_top)
+        or a
+        sbc hl, de
+        ld (tmp_off), hl
+        ld hl, (saved_top + 2)
+        ld bc, 0
+        sbc hl, bc
+        ld (tmp_off + 2), hl
+        push de
+        ld hl, tmp_off
+        call load_window
+        pop de
+        or a
+        ret nz
+        ld hl, WINDOW_ADDR
+        add hl, de
+        ld (buffer_from), hl
+        call window_prev_line
+        jr c, _reload_backward_long
+        ld (buffer_from), hl
+        xor a
+        ret
+_reload_backward_long:
+        ; The previous line is longer than WINDOW_BACK, show its end only, its number
+        ; is now unknown
+        ld hl, WINDOW_ADDR
+        ld (buffer_from), hl
+        ld hl, LINE_UNKNOWN
+        ld (top_line), hl
+        xor a
+        ret
+
+
+        ; Show the beginning of the file
+        ; Returns:
+        ;   A - ERR_SUCCESS on success, error code else
+jump_start:
+        ld hl, 0
+        ld (tmp_off), hl
+        ld (tmp_off + 2), hl
+        ld (top_line), hl
+        ld hl, tmp_off
+        jp load_window
+
+
+        ; Show the end of the file with a single seek: load the last window of the file
+        ; and go up from its end until the screen is filled.
+        ; Returns:
+        ;   A - ERR_SUCCESS on success, error code else
+jump_end:
+        ; The window starts at file_size - WINDOW_SIZE, or at 0 if the file is smaller
+        ld hl, (file_size)
+        ld de, WINDOW_SIZE
+        or a
+        sbc hl, de
+        ld (tmp_off), hl
+        ld hl, (file_size + 2)
+        ld de, 0
+        sbc hl, de
+        ld (tmp_off + 2), hl
+        jr nc, _jump_end_load
+        ld hl, 0
+        ld (tmp_off), hl
+        ld (tmp_off + 2), hl
+_jump_end_load:
+        ld hl, tmp_off
+        call load_window
+        or a
+        ret nz
+        ld hl, (buffer_filled)
+        ld (buffer_from), hl
+        ; The last line of the screen is used for the prompt
+        ld a, (screen_area + area_height_t)
+        dec a
+        ld b, a
+_jump_end_up:
+        push bc
+        call window_prev_line
+        pop bc
+        jr z, _jump_end_first
+        jr c, _jump_end_done
+        ld (buffer_from), hl
+        djnz _jump_end_up
+_jump_end_done:
+        ld hl, LINE_UNKNOWN
+        ld (top_line), hl
+        xor a
+        ret
+_jump_end_first:
+        ; The whole file fits on screen
+        ld hl, 0
+        ld (top_line), hl
+        xor a
+        ret
+
+
+        ; Check whether the video driver supports the blit command by blanking the prompt line
+        ; with it. If it does, the screen will be drawn with blits and scrolled by the driver.
+        ; Parameters:
+        ;   None
+        ; Returns:
+        ;   [blit_mode] - Non-zero if the blits are supported
+blit_detect:
+        xor a
+        ld (blit_mode), a
+        ; Both descriptors cover the whole width of the screen
+        ld hl, blank_desc
+        ld de, blit_desc
+        ld (hl), a
+        ld (de), a
+        inc hl
+        inc de
+        ld a, (screen_area + area_height_t)
+        dec a
+        ld (hl), a
+        inc hl
+        inc de
+        ld a, (screen_area + area_width_t)
+        ld (hl), a
+        ld (de), a
+        inc hl
+        inc de
+        ld (hl), 1
+        inc hl
+        inc de
+        ld (hl), ' '
+        inc hl
+        inc de
+        ld a, TEXT_COLOR_BLACK << 4 | TEXT_COLOR_WHITE
+        ld (hl), a
+        ld (de), a
+        ld hl, 0
+        ld (blank_desc + blit_chars_t), hl
+        ld (blank_desc + blit_colors_t), hl
+        ld (blit_desc + blit_colors_t), hl
+        ld hl, init_static_buffer
+        ld (blit_desc + blit_chars_t), hl
+        ; Number of lines that fit in the static buffer
+        ld hl, INIT_BUFFER_SIZE
+        ld a, (screen_area + area_width_t)
+        ld e, a
+        ld d, 0
+        ld a, -1
+_blit_detect_rows:
+        inc a
+        or a
+        sbc hl, de
+        jr nc, _blit_detect_rows
+        ld (rows_per_blit), a
+        call blank_prompt
+        ret nz
+        ld a, 1
+        ld (blit_mode), a
+        ; The blits don't move the cursor, set it on the prompt line once and for all
+        ld a, (screen_area + area_height_t)
+        dec a
+        ld e, a
+        ld d, 0
+        ld c, CMD_SET_CURSOR_XY
+        jp stdout_ioctl
+
+
+        ; Blank the last line of the screen, used as the prompt
+        ; Returns:
+        ;   A - ERR_SUCCESS on success, error code else
+blank_prompt:
+        ld de, blank_desc
+        ld c, CMD_BLIT
+        jp stdout_ioctl
+
+
+        ; Draw the lines of the file on the whole screen, except the prompt line
+        ; Returns:
+        ;   A - ERR_SUCCESS on success, error code else
+redraw_screen:
+        ld a, (blit_mode)
+        or a
+        jr z, _redraw_screen_print
+        ld a, (screen_area + area_height_t)
+        dec a
+        ld e, a
+        ld d, 0
+        jr draw_rows
+_redraw_screen_print:
+        ; Clear the screen and print the characters from the file
+        call clear_set_cursor
+        or a
+        ret nz
+        call print_buffer
+        xor a
+        ret
+
+
+        ; Update the screen after the top line moved by one line. The content of the screen
+        ; is scrolled by the driver and only the line revealed is drawn.
+        ; Parameters:
+        ;   A - 1 if the top line moved down in the file, -1 if it moved up
+        ; Returns:
+        ;   A - ERR_SUCCESS on success, error code else
+scroll_screen:
+        ld e, a
+        ld a, (blit_mode)
+        or a
+        jr z, redraw_screen
+        push de
+        ld c, CMD_SCROLL
+        call stdout_ioctl
+        pop de
+        jr nz, redraw_screen
+        ld a, e
+        or a
+        jp m, _scroll_screen_up
+        ; The former prompt line is now above the prompt, draw the new last line there
+        ld a, (screen_area + area_height_t)
+        sub 2
+        ld d, a
+        ld e, 1
+        jr draw_rows
+_scroll_screen_up:
+        ; The former last line went down to the prompt line, blank it and draw the new first line
+        call blank_prompt
+        ret nz
+        ld de, 1
+        ; Fall-through
+
+
+        ; Draw some lines of the file on screen with the blit command. The lines are rendered
+        ; in the static buffer, as many as it can hold, and sent with a single blit.
+        ; Parameters:
+        ;   D - First line of the screen to draw, it shows the D-th line after the top line
+        ;   E - Number of lines to draw
+        ; Returns:
+        ;   A - ERR_SUCCESS on success, error code else
+draw_rows:
+        ld a, d
+        ld (draw_row), a
+        ld a, e
+        ld (draw_left), a
+        call get_current_buffer_size
+        ld hl, (buffer_from)
+        ; Skip the first D lines, the lines after the end of the file are drawn blank
+        ld a, d
+        or a
+        jr z, _draw_rows_loop
+_draw_rows_skip:
+        ld a, b
+        or c
+        jr z, _draw_rows_loop
+        ld a, '\n'
+        cpir
+        jr nz, _draw_rows_loop
+        dec d
+        jr nz, _draw_rows_skip
+_draw_rows_loop:
+        ld a, (draw_left)
+        or a
+        ret z
+        ; Number of lines in this blit: min(draw_left, rows_per_blit)
+        ld d, a
+        ld a, (rows_per_blit)
+        cp d
+        jr c, _draw_rows_count
+        ld a, d
+_draw_rows_count:
+        ld (blit_desc + blit_h_t), a
+        ld de, init_static_buffer
+_draw_rows_render:
+        push af
+        call render_line
+        pop af
+        dec a
+        jr nz, _draw_rows_render
+        ; Send the lines to the driver, keep the position in the file
+        push hl
+        push bc
+        ld a, (draw_row)
+        ld (blit_desc + blit_y_t), a
+        ld de, blit_desc
+        ld c, CMD_BLIT
+        call stdout_ioctl
+        pop bc
+        pop hl
+        ret nz
+        ld a, (blit_desc + blit_h_t)
+        ld d, a
+        ld a, (draw_row)
+        add d
+        ld (draw_row), a
+        ld a, (draw_left)
+        sub d
+        ld (draw_left), a
+        jr _draw_rows_loop
+
+
+        ; Render a line of the file in a buffer, truncated or padded with spaces to the width
+        ; of the screen.
+        ; Parameters:
+        ;   HL - Line to render
+        ;   BC - Number of bytes remaining in the window
+        ;   DE - Destination buffer
+        ; Returns:
+        ;   HL - Next line
+        ;   BC - Number of bytes remaining after the line
+        ;   DE - Destination buffer + screen width
+        ; Alters:
+        ;   A, BC, DE, HL
+render_line:
+        ld a, (screen_area + area_width_t)
+        ld (render_left), a
+_render_line_loop:
+        ld a, b
+        or c
+        jr z, _render_line_pad
+        ld a, (hl)
+        inc hl
+        dec bc
+        cp '\n'
+        jr z, _render_line_pad
+        cp '\r'
+        jr z, _render_line_loop
+        ld (de), a
+        inc de
+        ld a, (render_left)
+        dec a
+        ld (render_left), a
+        jr nz, _render_line_loop
+        ; The line doesn't fit on screen, skip the rest of it
+        ld a, b
+        or c
+        ret z
+        ld a, '\n'
+        cpir
+        ret
+_render_line_pad:
+        ld a, (render_left)
+        or a
+        ret z
+        push bc
+        ld b, a
+        ld a, ' '
+_render_line_pad_loop:
+        ld (de), a
+        inc de
+        djnz _render_line_pad_loop
+        pop bc
+        ret
+
+
         ; Print the characters starting from `buffer_from`
 print_buffer:
         call get_current_buffer_size
@@ -373,6 +1126,10 @@ print_flush:
         ; Returns:
         ;   A - First character of the buffer, 0 if nothing
 listen_on_input:
+        ; In blit mode, the cursor never leaves the last line
+        ld a, (blit_mode)
+        or a
+        jr nz, _listen_on_input_read
         ; Set the cursor to the last line
         ld a, (screen_area + 1)
         dec a
@@ -384,6 +1141,7 @@ listen_on_input:
         or a
         ret nz
         ; TODO: Check the errors?
+_listen_on_input_read:
         ; Read the command from the standard input
         ld de, init_static_buffer
         ld bc, INIT_BUFFER_SIZE
@@ -407,10 +1165,33 @@ str_ioctl_err_end:
     SECTION BSS
 file_fd: DEFS 1
 screen_area: DEFS area_end_t
-    ; Number of bytes stored in the buffer / file size
+file_size: DEFS 4
+    ; Offset, in the file, of the first byte of the window
+win_off: DEFS 4
+    ; Non-zero if the window reaches the end of the file
+win_eof: DEFS 1
+    ; Address following the last byte loaded in the window
 buffer_filled: DEFS 2
     ; Address of the buffer to start displaying from
 buffer_from: DEFS 2
+    ; Number of the line at the top of the screen, LINE_UNKNOWN if not known
+top_line: DEFS 2
+index_count: DEFS 2
+index_shift: DEFS 1
+    ; Offset of the top line, saved before reloading the window
+saved_top: DEFS 4
+tmp_off: DEFS 4
     ; Print buffer, using the shared buffer
 init_static_buffer_from: DEFS 2
 init_static_buffer_size: DEFS 1
+    ; Non-zero if the screen is drawn with the blit command
+blit_mode: DEFS 1
+    ; Descriptors to draw lines from the static buffer and to blank the prompt line
+blit_desc: DEFS blit_end_t
+blank_desc: DEFS blit_end_t
+rows_per_blit: DEFS 1
+draw_row: DEFS 1
+draw_left: DEFS 1
+render_left: DEFS 1
+    ; Set by scroll_up and scroll_down when the top line changed
+moved: DEFS 1
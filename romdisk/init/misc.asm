@@ -7,6 +7,7 @@
     INCLUDE "strutils_h.asm"
 
     EXTERN error_print
+    EXTERN background_job
 
     SECTION TEXT
 
@@ -120,7 +121,12 @@ try_exec_bc_de:
     ; Prepare parameter before testing the MMU capability
     ld h, EXEC_PRESERVE_PROGRAM
     or a    ; A = 0 <=> no MMU capability, cannot preserve
-    jr nz, _process_command_exec
+    jr z, _process_command_override
+    ; A shell running in a background job cannot be preserved either
+    ld a, (background_job)
+    or a
+    jr z, _process_command_exec
+_process_command_override:
     ld h, EXEC_OVERRIDE_PROGRAM
 _process_command_exec:
     EXEC()
@@ -526,8 +526,11 @@ system_commands_begin:
         NEW_COMMAND("date", date_main)
         NEW_COMMAND("exec", exec_main)
         NEW_COMMAND("expr", expr_main)
+        NEW_COMMAND("fg", fg_main)
         NEW_COMMAND("help", help_main)
+        NEW_COMMAND("jobs", jobs_main)
         NEW_COMMAND("load", load_main)
+        NEW_COMMAND("prof", prof_main)
         NEW_COMMAND("reset", reset_main)
         NEW_COMMAND("sleep", sleep_main)
         NEW_COMMAND("uartrcv", uartrcv_main)
@@ -542,12 +545,15 @@ system_commands_begin:
         NEW_COMMAND("echo", echo_main)
         NEW_COMMAND("exec", exec_main)
         NEW_COMMAND("expr", expr_main)
+        NEW_COMMAND("fg", fg_main)
         NEW_COMMAND("help", help_main)
         NEW_COMMAND("hexdump", hexdump_main)
+        NEW_COMMAND("jobs", jobs_main)
         NEW_COMMAND("less", less_main)
         NEW_COMMAND("load", load_main)
         NEW_COMMAND("ls", ls_main)
         NEW_COMMAND("mkdir", mkdir_main)
+        NEW_COMMAND("prof", prof_main)
         NEW_COMMAND("reset", reset_main)
         NEW_COMMAND("rm", rm_main)
         NEW_COMMAND("sleep", sleep_main)
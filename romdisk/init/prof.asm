@@ -0,0 +1,76 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+        INCLUDE "zos_sys.asm"
+        INCLUDE "zos_profiler.asm"
+        INCLUDE "strutils_h.asm"
+
+        SECTION TEXT
+
+        EXTERN error_print
+
+        ; "prof" command main function, start or stop the PC-sampling profiler.
+        ; The histogram can then be saved with `cp #PROF <file>`.
+        ; Parameters:
+        ;       HL - ARGV
+        ;       BC - ARGC
+        ; Returns:
+        ;       A - 0 on success
+        PUBLIC prof_main
+prof_main:
+        ld a, c
+        cp 2
+        jr nz, _prof_usage
+        inc hl
+        inc hl
+        ld a, (hl)
+        inc hl
+        ld h, (hl)
+        ld l, a
+        ; Look for the command in the table
+        ld c, PROF_CMD_START
+        ld de, prof_start_str
+        call strcmp
+        or a
+        jr z, _prof_ioctl
+        ld c, PROF_CMD_STOP
+        ld de, prof_stop_str
+        call strcmp
+        or a
+        jr nz, _prof_usage
+_prof_ioctl:
+        push bc
+        ld bc, prof_dev_str
+        ld h, O_RDONLY
+        OPEN()
+        pop bc
+        or a
+        jp m, _prof_open_error
+        ld h, a
+        push hl
+        IOCTL()
+        pop hl
+        push af
+        CLOSE()
+        pop af
+        or a
+        ret z
+        jr _prof_error
+_prof_open_error:
+        neg
+_prof_error:
+        ld de, 0
+        call error_print
+        ld a, 2
+        ret
+_prof_usage:
+        S_WRITE3(DEV_STDOUT, prof_usage, prof_usage_end - prof_usage)
+        ld a, 1
+        ret
+
+prof_dev_str: DEFM "#PROF", 0
+prof_start_str: DEFM "start", 0
+prof_stop_str: DEFM "stop", 0
+prof_usage: DEFM "usage: prof start|stop\n"
+prof_usage_end:
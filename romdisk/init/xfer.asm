@@ -202,6 +202,13 @@ xfer_rcv_no_override:
     jp m, xfer_rcv_open_dest_err
     ; Store the file descriptor in static memory
     ld (STATIC_BUFFER + XFER_FILE_FD), a
+    ; Reserve the size of the whole file on the disk at once, so that it is not grown page by
+    ; page while receiving it. The header contains the 32-bit little-endian size of the file.
+    ; This is only a hint, ignore the errors.
+    ld h, a
+    ld de, (STATIC_BUFFER + 20)
+    ld bc, (STATIC_BUFFER + 22)
+    PREALLOCATE()
     ; Send an ACK to the host, it will give us some time before sending
     ; the next chunk of data
     ld a, ACK_BYTE
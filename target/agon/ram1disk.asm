@@ -14,6 +14,12 @@
 
 ; Allowing space for 64k ZealOS + 256k (max) ROMDISK
     DEFL ramdisk_base = 0x090000
+; The RAM disk ends before the memory used by MOS, its size must be a multiple of 64KB
+    DEFC RAMDISK_SIZE = 0x020000
+; 24-bit base address of the segment the kernel and the programs run in (MBASE)
+    DEFC KERNEL_SEGMENT = 0x040000
+
+    ASSERT((ramdisk_base & 0xffff) == 0 && (RAMDISK_SIZE & 0xffff) == 0)
 
     SECTION KERNEL_DRV_TEXT
 ramdisk_init:
@@ -83,27 +89,22 @@ ramdisk_read:
     or a
 ;    jp nz, _ramdisk_read_as_block  ;Future expansion
     ret nz
-    ; The offset must be 16-bit according to the filesystem, so the top of the stack must have
-    ; 0x000
-    pop hl
-    ld a, h
-    or l
-    pop hl
+    call _ramdisk_pop_offset
     jr nz, ramdisk_read_invalid_offset
-    ; In practice, BC will also be smaller than 256 when called from the FS, so don't accept
-    ; bigger size for now.
-    or b
-    jr nz, ramdisk_read_invalid_size
-        ; Convert addresses to eZ80 address space on Agon
+    call _ramdisk_disk_address
+    jr c, ramdisk_read_invalid_offset
+    ret z
+        ; The whole transfer is a single 24-bit LDIR between the RAM disk and the buffer,
+        ; which is in the kernel segment
         ld      (source_ez80+2),hl
+        ld      (source_ez80+4),a
         ld      (dest_ez80+2),de
         ld      (length_ez80+2),bc
 
-;currently compiled on an absolute base address of 0x040000h in Agon Light
 source_ez80:
        ld.lil      hl,ramdisk_base
 dest_ez80:
-       ld.lil      de,40000h
+       ld.lil      de,KERNEL_SEGMENT
 length_ez80:
        ld.lil      bc,00000h
 
@@ -115,9 +116,6 @@ length_ez80:
         xor a
         ret
 
-ramdisk_read_invalid_size:
-    ld a, ERR_INVALID_PARAMETER
-    ret
 ramdisk_read_invalid_offset:
     ld a, ERR_INVALID_OFFSET
     ret
@@ -213,23 +211,18 @@ ramdisk_write:
     or a
 ;    jp nz, _ramdisk_write_as_block ;future expansion
     ret nz
-    ; The offset must be 16-bit according to the filesystem, so the top of the stack must have
-    ; 0x000
-    pop hl
-    ld a, h
-    or l
-    pop hl
+    call _ramdisk_pop_offset
     jr nz, ramdisk_read_invalid_offset
-    or b
-    jr nz, ramdisk_read_invalid_size
-; Convert addresses to eZ80 address space on Agon
+    call _ramdisk_disk_address
+    jr c, ramdisk_read_invalid_offset
+    ret z
         ld      (destw_ez80+2),hl
+        ld      (destw_ez80+4),a
         ld      (sourcew_ez80+2),de
         ld      (lengthw_ez80+2),bc
 
-;currently compiled on an absolute base address of 0x040000h in Agon Light
 sourcew_ez80:
-       ld.lil      hl,40000h
+       ld.lil      hl,KERNEL_SEGMENT
 destw_ez80:
        ld.lil      de,ramdisk_base
 lengthw_ez80:
@@ -239,11 +232,79 @@ lengthw_ez80:
         ENTER_CRITICAL()
         ldir.l
         EXIT_CRITICAL()
-        pop     bc      ;number of bytes read
+        pop     bc      ;number of bytes written
         xor a
         ret
 
 
+    ; Pop the 32-bit offset given to the read and write routines. The return address
+    ; of this routine is on top of it.
+    ; Returns:
+    ;       A:HL - Lower 24 bits of the offset
+    ;       Z flag - Set if the offset fits in 24 bits
+    ; Alters:
+    ;       A, HL
+_ramdisk_pop_offset:
+    pop hl
+    ; Upper 16-bit of the offset
+    ex (sp), hl
+    ld a, h
+    or a
+    ld a, l
+    pop hl
+    ; Lower 16-bit of the offset
+    ex (sp), hl
+    ret
+
+
+    ; Convert an offset on the disk to a 24-bit address, and limit the size of the transfer
+    ; so that it doesn't go past the end of the disk.
+    ; Parameters:
+    ;       A:HL - Offset on the disk
+    ;       BC - Size of the transfer
+    ; Returns:
+    ;       A:HL - 24-bit address of the offset
+    ;       BC - Size of the transfer, limited to the end of the disk
+    ;       Carry flag - Set if the offset is past the end of the disk
+    ;       Z flag - Set if there is nothing to transfer (BC is 0), A is ERR_SUCCESS in that case
+    ; Alters:
+    ;       A, BC, HL
+_ramdisk_disk_address:
+    cp RAMDISK_SIZE >> 16
+    ccf
+    ret c
+    ; Only the last 64KB of the disk can limit the size, BC is at most 16KB
+    inc a
+    cp RAMDISK_SIZE >> 16
+    dec a
+    jr c, _ramdisk_disk_address_size
+    push hl
+    add hl, bc
+    pop hl
+    jr nc, _ramdisk_disk_address_size
+    ; BC = 0x10000 - HL
+    push af
+    xor a
+    sub l
+    ld c, a
+    ld a, 0
+    sbc a, h
+    ld b, a
+    pop af
+_ramdisk_disk_address_size:
+    add ramdisk_base >> 16
+    ; Carry is reset by the addition, check the size without altering it
+    inc b
+    dec b
+    ret nz
+    inc c
+    dec c
+    ret nz
+    ; Nothing to transfer, A must be ERR_SUCCESS
+    xor a
+    ret
+
+
 ramdisk_seek:
 ramdisk_ioctl:
     ld a, ERR_NOT_IMPLEMENTED
@@ -20,3 +20,7 @@
         SECTION KERNEL_BSS
         ORG CONFIG_KERNEL_RAM_START
         SECTION DRIVER_BSS
+
+        ; Opened files allocated on demand, from the end of the kernel RAM sections up to
+        ; the kernel stack (see KERNEL_OPENED_FILES_POOL). This section must be the last one.
+        SECTION KERNEL_POOL
\ No newline at end of file
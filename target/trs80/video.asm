@@ -229,6 +229,9 @@ _video_ioctl_cmd_table:
         DEFW _video_ioctl_set_cursor_xy
         DEFW _video_ioctl_set_colors
         DEFW _video_ioctl_clear_screen
+        DEFW _video_not_impl    ; CMD_RESET_SCREEN
+        DEFW _video_not_impl    ; CMD_BLIT
+        DEFW _video_not_impl    ; CMD_SCROLL
 
 
         ; Write function, called every time user application needs to output chars
@@ -16,7 +16,29 @@
     DEFC CF_DISK_LETTER = 'C'
 
     SECTION KERNEL_DRV_TEXT
+  IF CONFIG_KERNEL_LAZY_DISK_PROBE
 cf_init:
+    ; Do not wait for the CompactFlash on boot, mount the disk right away and let
+    ; the kernel call cf_probe on the first access.
+    ld a, CF_DISK_LETTER
+    ld e, FS_RAWTABLE
+    ld hl, _cf_driver
+    ld bc, cf_probe
+    call zos_disks_mount_lazy
+    or a
+    ret nz
+    ld a, ERR_DRIVER_HIDDEN
+    ret
+
+    ; Probe routine, called by the kernel the first time the disk is accessed.
+    ; Returns:
+    ;   A - ERR_SUCCESS if the CompactFlash is present and usable, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+cf_probe:
+  ELSE
+cf_init:
+  ENDIF
   IF CONFIG_TARGET_COMPACTFLASH_TIMEOUT > 0
     ld bc, CONFIG_TARGET_COMPACTFLASH_TIMEOUT
     ld de, 1    ; 1 millisecond
@@ -52,6 +74,11 @@ cf_ready:
     call wait_for_ready
     ; If A is not zero, 8-bit mode is not supported
     jr nz, _cf_init_not_compatible
+  IF CONFIG_KERNEL_LAZY_DISK_PROBE
+    ; The disk is already mounted, nothing else to do
+    xor a
+    ret
+  ELSE
     ; Put disk letter in A, file system in E (rawtable) and driver structure in HL
     ld a, CF_DISK_LETTER
     ld e, FS_RAWTABLE
@@ -64,6 +91,7 @@ cf_ready:
     ; directly used by users as a block device (yet?).
     ld a, ERR_DRIVER_HIDDEN
     ret
+  ENDIF
 _cf_init_not_compatible:
     ld hl, _not_compatible
     call zos_log_error
@@ -72,7 +100,12 @@ _cf_init_not_compatible:
 _cf_init_not_found:
     ld hl, _not_found_str
     call zos_log_warning
+  IF CONFIG_KERNEL_LAZY_DISK_PROBE
+    ; The disk must be unmounted
+    ld a, ERR_NO_SUCH_ENTRY
+  ELSE
     xor a
+  ENDIF
     ret
 _not_compatible: DEFM "CompactFlash: 8-bit mode unsupported\n", 0
 _not_found_str:  DEFM "No CompactFlash found\n", 0
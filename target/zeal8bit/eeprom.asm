@@ -20,6 +20,11 @@
 
     SECTION KERNEL_DRV_TEXT
 eeprom_init:
+  IF CONFIG_TARGET_I2C_FAST_MODE
+    ; The EEPROM supports fast-mode, unlike the RTC
+    ld a, I2C_EEPROM_ADDRESS
+    call i2c_set_fast_device
+  ENDIF
     ; Before mounting the disk, make sure it is formatted. To do so, read the first two bytes.
     ; Re-use the same buffer for write and reads.
     ld hl, 0
@@ -168,6 +173,8 @@ _eeprom_update_offset:
     ;   A, HL
 eeprom_set_current_address:
     push bc
+    ; The previous page write must be over before talking to the EEPROM
+    call eeprom_wait_ready
     ; Set the 'current address' in the I2C chip
     ; We must store the offset (HL) in big-endian in a buffer
     ld a, h
@@ -379,6 +386,8 @@ _eeprom_write_page:
     push hl
     push de
     push bc
+    ; The previous page write must be over before sending this one
+    call eeprom_wait_ready
     ld a, l
     ld (_eeprom_buffer + 1), a
     ld a, h
@@ -394,8 +403,14 @@ _eeprom_write_page:
     ld c, 2
     call i2c_write_double_buffer
     or a
-    ; If the transfer was a success, we have to wait for the write to finish
-    call z, eeprom_write_poll
+    ; If the transfer was a success, the EEPROM is now busy writing the page internally.
+    ; Instead of waiting for it here, let the next transaction wait for it, so that the
+    ; CPU can prepare the next page (or return to the file system) in the meantime.
+    jr nz, _eeprom_write_page_error
+    inc a
+    ld (_eeprom_busy), a
+    dec a
+_eeprom_write_page_error:
     pop bc
     pop de
     pop hl
@@ -410,25 +425,32 @@ _eeprom_write_page:
     ret
 
 
+    ; Wait for the EEPROM to finish the previous page write, if any.
+    ; Returns:
+    ;   A - 0
+    ; Alters:
+    ;   A
+eeprom_wait_ready:
+    ld a, (_eeprom_busy)
+    or a
+    ret z
+    xor a
+    ld (_eeprom_busy), a
+    ; Fall-through
+
+
     ; After a write, the EEPROM will stop responding until the write is
     ; done internally. We have to poll the device until is responds again.
     ; Returns:
     ;   A - 0
     ; Alters:
-    ;   A, BC, DE, HL
+    ;   A
 eeprom_write_poll:
-    ; Read a dummy byte from the device, only to see if it responds
-    ; Parameters:
-    ;   A - 7-bit device address
-    ;   HL - Buffer to store the bytes read
-    ;   BC - Size of the buffer
-    ld bc, 1
-_eeprom_write_poll_loop:
+    ; Only send the device address, it will be acknowledged once the write is over
     ld a, I2C_EEPROM_ADDRESS
-    ld hl, _eeprom_buffer
-    call i2c_read_device
+    call i2c_probe_device
     or a
-    jr nz, _eeprom_write_poll_loop
+    jr nz, eeprom_write_poll
     ret
 
 
@@ -483,6 +505,8 @@ eeprom_ioctl:
 _eeprom_buffer: DEFS 2
 _eeprom_offset: DEFS 2
 _eeprom_end: DEFS 1
+    ; Non-zero if the EEPROM may still be writing a page internally
+_eeprom_busy: DEFS 1
 
     SECTION KERNEL_DRV_VECTORS
 _eeprom_driver:
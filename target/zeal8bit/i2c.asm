@@ -2,6 +2,7 @@
 ;
 ; SPDX-License-Identifier: Apache-2.0
 
+        INCLUDE "osconfig.asm"
         INCLUDE "errors_h.asm"
         INCLUDE "drivers_h.asm"
         INCLUDE "pio_h.asm"
@@ -334,6 +335,14 @@ i2c_invalid_param:
         ; Alters:
         ;   A, DE
 i2c_send_byte:
+    IF CONFIG_TARGET_I2C_FAST_MODE
+        ; E is altered anyway, use it to save the byte to send
+        ld e, a
+        ld a, (_i2c_fast)
+        or a
+        ld a, e
+        jp nz, _i2c_send_byte_fast
+    ENDIF
         push bc
         ld b, 8
         ld c, PINS_DEFAULT_STATE
@@ -415,6 +424,14 @@ _i2c_send_byte_loop:
         ; Returns:
         ;   A - Byte received
 i2c_receive_byte:
+    IF CONFIG_TARGET_I2C_FAST_MODE
+        ; D is altered anyway, use it to save the ACK/NACK
+        ld d, a
+        ld a, (_i2c_fast)
+        or a
+        ld a, d
+        jp nz, _i2c_receive_byte_fast
+    ENDIF
         push bc
         push hl
         ld b, 8
@@ -485,14 +502,168 @@ _i2c_receive_byte_loop:
         ret
 
 
-        ; Perform a START on the bus. SCL MUST be high when calling this routine
+    IF CONFIG_TARGET_I2C_FAST_MODE
+        ; Fast-mode version of i2c_send_byte, fully unrolled.
+        ; Each bit takes 66 T-states, at 10MHz, this gives a ~150kHz clock with SCL
+        ; high for ~1.8us and low for ~4.8us, which respects fast-mode timings.
+        ; Parameters:
+        ;   A - Byte to send
+        ; Returns:
+        ;   A - SDA Pin state
+        ;   NZ Flag - NACK
+        ;   Z Flag - ACK received
+        ; Alters:
+        ;   A, DE
+_i2c_send_byte_fast:
+        ; The carry is directly added to the pins state below
+        ASSERT(IO_I2C_SDA_OUT_PIN == 0)
+        push bc
+        ld e, a
+        ld c, PINS_DEFAULT_STATE
+        ; Start with SCL and SDA low
+        ld a, c
+    REPT 8
+        ; Set SCL low, keep SDA to the current value
+        out (IO_PIO_SYSTEM_DATA), a
+        ; Put the next bit to send in SDA
+        sla e
+        ld a, c
+        adc 0
+        out (IO_PIO_SYSTEM_DATA), a
+        ; Set SCL high, SDA must not change
+        or 1 << IO_I2C_SCL_OUT_PIN
+        out (IO_PIO_SYSTEM_DATA), a
+        and ~(1 << IO_I2C_SCL_OUT_PIN)
+    ENDR
+        ; Set SCL low without modifying SDA, then release SDA to read the ACK
+        out (IO_PIO_SYSTEM_DATA), a
+        ld a, PINS_DEFAULT_STATE | (1 << IO_I2C_SDA_OUT_PIN)
+        out (IO_PIO_SYSTEM_DATA), a
+        ld a, PINS_DEFAULT_STATE | (1 << IO_I2C_SDA_OUT_PIN) | (1 << IO_I2C_SCL_OUT_PIN)
+        out (IO_PIO_SYSTEM_DATA), a
+        ; Read the reply from the device
+        in a, (IO_PIO_SYSTEM_DATA)
+        and SDA_INPUT_MASK
+        pop bc
+        ret
+
+
+        ; Fast-mode version of i2c_receive_byte, fully unrolled.
+        ; Each bit takes 60 T-states, SCL is low for ~1.6us and high for ~4.4us at 10MHz.
         ; Parameters:
+        ;   A - 0: ACK, 1: NACK
+        ; Returns:
+        ;   A - Byte received
+_i2c_receive_byte_fast:
+        ASSERT(IO_I2C_SDA_IN_PIN == 2)
+        push bc
+        push hl
+        ld d, a
+        ld c, IO_PIO_SYSTEM_DATA
+        ld l, PINS_DEFAULT_STATE | (1 << IO_I2C_SDA_OUT_PIN)
+        ld h, PINS_DEFAULT_STATE | (1 << IO_I2C_SDA_OUT_PIN) | (1 << IO_I2C_SCL_OUT_PIN)
+    REPT 8
+        ; Set SCL low and SDA high (high impedance)
+        out (c), l
+        ; Make sure SCL stays low for at least 1.3us
+        nop
+        out (c), h
+        ; Shift the SDA input pin into E
+        in a, (c)
+        rrca
+        rrca
+        rrca
+        rl e
+    ENDR
+        ; SDA is in high-impedance here, set clock to low first
+        out (c), l
+        ; Output the ACK/NACK on SDA, while SCL is still low
+        ld a, d
+        or PINS_DEFAULT_STATE
+        out (c), a
+        or 1 << IO_I2C_SCL_OUT_PIN
+        out (c), a
+        ld a, e
+        pop hl
+        pop bc
+        ret
+
+
+        ; Select the speed of the transaction that is about to start out of the device address.
+        ; Parameters:
+        ;   A - Device address, shifted left, with the R/W bit
+        ; Returns:
         ;   None
+        ; Alters:
+        ;   C
+_i2c_select_speed:
+        ld c, a
+        push hl
+        ; The fast device is stored as address + 1, so that 0 means no device
+        srl a
+        inc a
+        ld hl, _i2c_fast_device
+        sub (hl)
+        ld hl, _i2c_fast
+        ld (hl), 0
+        jr nz, _i2c_select_speed_end
+        inc (hl)
+_i2c_select_speed_end:
+        ld a, c
+        pop hl
+        ret
+
+
+        ; Register the device that supports fast-mode, all the transactions with this device
+        ; will be performed with fast-mode timings. The other devices stay in standard mode.
+        ; Parameters:
+        ;   A - 7-bit device address
+        ; Returns:
+        ;   None
+        ; Alters:
+        ;   A
+        PUBLIC i2c_set_fast_device
+i2c_set_fast_device:
+        inc a
+        ld (_i2c_fast_device), a
+        ret
+    ENDIF
+
+
+        ; Check whether a device acknowledges its address on the bus, without transferring
+        ; any byte. This can be used to poll a busy device.
+        ; Parameters:
+        ;   A - 7-bit device address
+        ; Returns:
+        ;   A - 0: Device responded
+        ;       non-zero: No device responded
+        ; Alters:
+        ;   A
+        PUBLIC i2c_probe_device
+i2c_probe_device:
+        push bc
+        push de
+        ; Making the write device address in A (left shift + 0)
+        sla a
+        call i2c_perform_start
+        call i2c_send_byte
+        call i2c_perform_stop
+        pop de
+        pop bc
+        ret
+
+
+        ; Perform a START on the bus. SCL MUST be high when calling this routine
+        ; Parameters:
+        ;   A - Device address, only used to select the speed of the transaction
         ; Returns:
         ;   None
         ; Alters:
         ;   C
 i2c_perform_start:
+    IF CONFIG_TARGET_I2C_FAST_MODE
+        call _i2c_select_speed
+    ENDIF
         ld c, a
         ; Output a start bit by setting SDA to LOW. SCL must remain HIGH.
         ld a, PINS_DEFAULT_STATE | (1 << IO_I2C_SCL_OUT_PIN) | (0 << IO_I2C_SDA_OUT_PIN)
@@ -788,6 +959,12 @@ _i2c_write_read_device_end:
         SECTION DRIVER_BSS
 _i2c_dev_addr: DEFS 1
 _driver_buffer: DEFS 32
+    IF CONFIG_TARGET_I2C_FAST_MODE
+        ; Address + 1 of the device supporting fast-mode, 0 if none
+_i2c_fast_device: DEFS 1
+        ; Non-zero if the current transaction is in fast-mode
+_i2c_fast: DEFS 1
+    ENDIF
 
         SECTION KERNEL_DRV_VECTORS
 NEW_DRIVER_STRUCT("I2C0", \
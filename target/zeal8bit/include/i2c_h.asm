@@ -82,4 +82,26 @@
         ;   A, BC, DE, HL
         EXTERN i2c_write_double_buffer
 
+
+        ; Check whether a device acknowledges its address on the bus, without transferring
+        ; any byte. This can be used to poll a busy device.
+        ; Parameters:
+        ;   A - 7-bit device address
+        ; Returns:
+        ;   A - 0: Device responded
+        ;       non-zero: No device responded
+        ; Alters:
+        ;   A
+        EXTERN i2c_probe_device
+
+
+        ; Register the device that supports fast-mode, all the transactions with this device
+        ; will be performed with fast-mode timings. The other devices stay in standard mode.
+        ; Only available if CONFIG_TARGET_I2C_FAST_MODE is enabled.
+        ; Parameters:
+        ;   A - 7-bit device address
+        ; Alters:
+        ;   A
+        EXTERN i2c_set_fast_device
+
         ENDIF
\ No newline at end of file
@@ -11,7 +11,9 @@
         INCLUDE "stdout_h.asm"
         INCLUDE "drivers/keyboard_h.asm"
 
-        DEFC KB_FIFO_SIZE = 16
+        DEFC KB_FIFO_SIZE = CONFIG_TARGET_KEYBOARD_FIFO_SIZE
+        ; The number of values in the FIFO is stored on 8 bits, a 256-byte FIFO holds 255 values
+        DEFC KB_FIFO_CAPACITY = KB_FIFO_SIZE - KB_FIFO_SIZE / 256
         DEFC KB_INTERNAL_BUFFER_SIZE = 255
 
         ; Raw or cooked
@@ -22,12 +24,22 @@
         EXTERN zos_sys_reserve_page_1
         EXTERN zos_sys_restore_pages
         EXTERN zos_vfs_set_stdin
+    IF CONFIG_KERNEL_TARGET_HAS_MMU
+        EXTERN zos_sys_remap_de_page_2
+    ENDIF
+    IF CONFIG_TARGET_ENABLE_VIDEO
+        ; The bytes received are stamped with the V-blank counter, in milliseconds
+        EXTERN vblank_count
+    ENDIF
 
         ; Implementation dependent, can be PS/2 or parallel or I2C
         EXTERN keyboard_impl_modifiers
         EXTERN keyboard_impl_init
         EXTERN keyboard_impl_next_key
         EXTERN strlen
+    IF CONFIG_KERNEL_JOBS
+        EXTERN zos_job_yield
+    ENDIF
 
         ; Get the number the characters in the FIFO in register A and set the flags
         MACRO KB_FIFO_SIZE
@@ -71,6 +83,8 @@ keyboard_seek:
         ;       A, BC, DE, HL
 keyboard_ioctl:
         ld a, c
+        cp KB_CMD_GET_OVERFLOW
+        jr z, _keyboard_ioctl_overflow
         cp KB_CMD_SET_MODE
         jr nz, _keyboard_invalid_parameter
         ; Check if the current mode is the same as the new one
@@ -89,6 +103,22 @@ keyboard_ioctl:
 _keyboard_invalid_parameter:
         ld a, ERR_INVALID_PARAMETER
         ret
+_keyboard_ioctl_overflow:
+        ; The counter is updated by the interrupt handler, get it and reset it atomically
+        ld hl, 0
+        ENTER_CRITICAL()
+        ld bc, (kb_fifo_overflow)
+        ld (kb_fifo_overflow), hl
+        EXIT_CRITICAL()
+    IF CONFIG_KERNEL_TARGET_HAS_MMU
+        call zos_sys_remap_de_page_2
+    ENDIF
+        ex de, hl
+        ld (hl), c
+        inc hl
+        ld (hl), b
+        xor a
+        ret
 
 
         ; Calculate the minimum between HL and BC and store it in BC
@@ -492,6 +522,82 @@ _keyboard_extended_down_arrow:
         jp _keyboard_read_ignore
 
 
+        ; Read the pending key events from the keyboard FIFO as kb_event_t structures, which
+        ; include the time each key was received at.
+        ; Parameters:
+        ;       DE - Destination buffer.
+        ;       BC - Size to read in bytes. Guaranteed to be equal to or smaller than 16KB.
+        ;            Bigger than 0.
+        ; Returns:
+        ;       A  - ERR_SUCCESS if success, error code else
+        ;       BC - Number of bytes read, can be 0 is non-blocking mode
+        ; Alters:
+        ;       This function can alter any register.
+keyboard_read_events:
+        ; Calculate the number of events that fit in the buffer, at most 255
+        ASSERT(kb_event_end_t == 4)
+        srl b
+        rr c
+        srl b
+        rr c
+        ld a, b
+        or a
+        jr z, _keyboard_read_events_count
+        ld c, 0xff
+_keyboard_read_events_count:
+        ld a, c
+        or a
+        jr z, _keyboard_read_events_invalid
+        ; Remaining events is C, written events is B
+        ld b, 0
+_keyboard_read_events_loop:
+        push bc
+        ld a, 1
+        call keyboard_next_key
+        or a
+        jr z, _keyboard_read_events_no_more_keys
+        ex de, hl
+        ld (hl), a
+        inc hl
+        ; KB_EVENT_RELEASED has the same value as KB_EVT_RELEASED
+        ld a, b
+        and KB_EVT_RELEASED
+        ld (hl), a
+        inc hl
+        ; Time at which the last byte of the event was received
+        ld bc, (kb_last_time)
+        ld (hl), c
+        inc hl
+        ld (hl), b
+        inc hl
+        ex de, hl
+        pop bc
+        inc b
+        dec c
+        jr z, _keyboard_read_events_end
+        ; Only wait for the first event, return the ones that are already in the FIFO
+        ld a, (kb_fifo_size)
+        or a
+        jr nz, _keyboard_read_events_loop
+        jr _keyboard_read_events_end
+_keyboard_read_events_no_more_keys:
+        pop bc
+_keyboard_read_events_end:
+        ; Return the number of bytes written in BC
+        ld l, b
+        ld h, 0
+        add hl, hl
+        add hl, hl
+        ld b, h
+        ld c, l
+        xor a
+        ret
+_keyboard_read_events_invalid:
+        ld bc, 0
+        ld a, ERR_INVALID_PARAMETER
+        ret
+
+
         ; Read from the keyboard FIFO directly and return the numbers of bytes
         ; written.
         ; Parameters:
@@ -504,6 +610,9 @@ _keyboard_extended_down_arrow:
         ; Alters:
         ;       This function can alter any register.
 keyboard_read_raw:
+        ld a, (kb_mode)
+        and KB_READ_EVENTS
+        jp nz, keyboard_read_events
         ; To speed up the loop, if B is not 0, set C to 0xff. The keyboard FIFO
         ; is not that big.
         ld a, b
@@ -576,8 +685,16 @@ keyboard_next_key:
         ld a, (kb_mode)
         ; Result is zero in blocking mode
         and KB_READ_NON_BLOCK
+    IF CONFIG_KERNEL_JOBS
+        jr nz, keyboard_next_key_none
+        ; Blocking mode, let the other jobs run while waiting for a key
+        call zos_job_yield
+        jr keyboard_next_key
+keyboard_next_key_none:
+    ELSE
         ; If in blocking mode (0), try again
         jr z, keyboard_next_key
+    ENDIF
         ; Non-blocking mode, we can return 0
         xor a
         ret
@@ -598,7 +715,9 @@ keyboard_fifo_size:
         ret
 
 
-        ; Enqeue a value in the keyboard FIFO. If the FIFO is empty, A will not be 0
+        ; Enqeue a value in the keyboard FIFO. If the FIFO is full, the oldest value is dropped.
+        ; The value is stamped with the current V-blank counter. This routine is called from
+        ; the interrupt handler, keep it short.
         ; Parameters:
         ;       A - Value to enqueue in the FIFO
         ; Returns:
@@ -609,6 +728,19 @@ keyboard_fifo_size:
 keyboard_enqueue:
         ld hl, (kb_fifo_wr)
         ld (hl), a
+    IF CONFIG_TARGET_ENABLE_VIDEO
+        ; The timestamp is stored in two arrays that follow the FIFO
+        push bc
+        ld bc, KB_FIFO_SIZE
+        add hl, bc
+        ld a, (vblank_count)
+        ld (hl), a
+        add hl, bc
+        ld a, (vblank_count + 1)
+        ld (hl), a
+        pop bc
+        ld hl, (kb_fifo_wr)
+    ENDIF
         ; Increment HL. We know that HL is aligned on KB_FIFO_SIZE.
         ; So L can be incremented alone, but keep the upper bit like
         ; they are in the FIFO address
@@ -623,7 +755,7 @@ keyboard_enqueue:
         ld (kb_fifo_wr), a
         ; Check if the size needs update (i.e. FIFO not full)
         ld a, (kb_fifo_size)
-        cp KB_FIFO_SIZE
+        cp KB_FIFO_CAPACITY
         ; In case the FIFO is full, we need to push read cursor forward
         jr z, _keyboard_queue_next_read
         ; Else, simply increment the size
@@ -631,8 +763,16 @@ keyboard_enqueue:
         ld (kb_fifo_size), a
         ret
 _keyboard_queue_next_read:
-        ld a, l
+        ; Drop the oldest value, increment the read cursor the same way
+        ld a, (kb_fifo_rd)
+        inc a
+        and KB_FIFO_SIZE - 1
+        add kb_fifo & 0xff
         ld (kb_fifo_rd), a
+        ; Count the value lost
+        ld hl, (kb_fifo_overflow)
+        inc hl
+        ld (kb_fifo_overflow), hl
         ret
 
         ; Dequeue a value from the FIFO. If the FIFO is empty, 0 will be returned in
@@ -665,6 +805,20 @@ _keyboard_dequeue_notempty:
         ; pointer to read, and because we are the only reader of the FIFO
         ; no need to do this in a critical section.
         ld hl, (kb_fifo_rd)
+    IF CONFIG_TARGET_ENABLE_VIDEO
+        ; Keep the time at which the value was received
+        push de
+        push hl
+        ld de, KB_FIFO_SIZE
+        add hl, de
+        ld a, (hl)
+        ld (kb_last_time), a
+        add hl, de
+        ld a, (hl)
+        ld (kb_last_time + 1), a
+        pop hl
+        pop de
+    ENDIF
         ld h, (hl)
         ; Increment L, the same way we did in enqueue
         inc l
@@ -683,6 +837,10 @@ _keyboard_dequeue_notempty:
 kb_fifo_wr: DEFS 2
 kb_fifo_rd: DEFS 2
 kb_fifo_size: DEFS 1
+        ; Number of values dropped because the FIFO was full
+kb_fifo_overflow: DEFS 2
+        ; Time at which the last value dequeued was received
+kb_last_time: DEFS 2
 
         ; Make sure these two always follow eachother
 kb_mode:  DEFS 1    ; Lo
@@ -696,8 +854,12 @@ kb_buffer_size: DEFS 1
 kb_buffer_cursor: DEFS 1
 
         SECTION DRIVER_BSS_ALIGN16
-        ALIGN 16
+        ALIGN KB_FIFO_SIZE
 kb_fifo: DEFS KB_FIFO_SIZE
+    IF CONFIG_TARGET_ENABLE_VIDEO
+        ; Lowest and highest bytes of the time at which each value of the FIFO was received
+kb_fifo_time: DEFS 2 * KB_FIFO_SIZE
+    ENDIF
         ; The FIFO size must be a power of two, and be less or equal to 256
         ASSERT(KB_FIFO_SIZE != 0 && KB_FIFO_SIZE <= 256)
         ASSERT((KB_FIFO_SIZE & (KB_FIFO_SIZE - 1)) == 0)
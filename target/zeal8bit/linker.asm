@@ -31,4 +31,7 @@
         ; MMU is initialized before the kernel erases the BSS, thus we cannot
         ; store MMU data inside the BSS, create a new section that won't be erased
         ; by the kernel.
-        SECTION NOINIT_DATA
\ No newline at end of file
+        SECTION NOINIT_DATA
+        ; Opened files allocated on demand, from the end of the kernel RAM sections up to
+        ; the kernel stack (see KERNEL_OPENED_FILES_POOL). This section must be the last one.
+        SECTION KERNEL_POOL
\ No newline at end of file
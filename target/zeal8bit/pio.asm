@@ -67,6 +67,15 @@ interrupt_pio_handler:
         ; Push the rest of the registers (may be on the user program stack)
         push hl
         push bc
+    IF CONFIG_TARGET_ENABLE_PROFILER
+        ; Get the interrupted PC before mapping the kernel RAM, the stack may be in page 3
+        ld hl, 8
+        add hl, sp
+        ld a, (hl)
+        inc hl
+        ld h, (hl)
+        ld l, a
+    ENDIF
         ; The kernel RAM may NOT BE MAPPED, we have to map it here
         MMU_GET_PAGE_NUMBER(MMU_PAGE_3)
         ; Save former page in D, we need it to restore it
@@ -76,6 +85,12 @@ interrupt_pio_handler:
     IF CONFIG_TARGET_ENABLE_VIDEO
         ; Check if a V-blank interrupt occurred
         bit IO_VBLANK_PIN, e
+    IF CONFIG_TARGET_ENABLE_PROFILER
+        EXTERN profiler_sample
+        ; Sample the interrupted PC (HL) first, the V-blank routine alters HL
+        call z, profiler_sample
+        bit IO_VBLANK_PIN, e
+    ENDIF
         ; All the bits are active-low!
         call z, video_vblank_isr
     ENDIF ; CONFIG_TARGET_ENABLE_VIDEO
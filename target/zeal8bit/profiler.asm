@@ -0,0 +1,294 @@
+; SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+;
+; SPDX-License-Identifier: Apache-2.0
+
+        INCLUDE "osconfig.asm"
+        INCLUDE "mmu_h.asm"
+        INCLUDE "errors_h.asm"
+        INCLUDE "drivers_h.asm"
+        INCLUDE "drivers/profiler_h.asm"
+
+        EXTERN zos_sys_reserve_page_1
+        EXTERN zos_sys_restore_pages
+
+        ; The profiler samples the interrupted PC on each V-blank interrupt and counts it in a
+        ; histogram, stored in a dedicated RAM page. The page has the following layout:
+        ;   - PROF_BUCKETS_OFF: one 16-bit counter per 16-byte block of the virtual address space
+        ;   - PROF_PAGES_OFF: one 16-bit counter per physical page the PC was in
+        ;   - PROF_HEADER_OFF: header, magic, version, log2 of the block size and number of samples
+        ; All the counters saturate at 0xFFFF, the number of samples is a 32-bit value.
+        ; The histogram is dumped by reading the driver, from the beginning of the page to the
+        ; end of the header.
+
+        ; Virtual address the histogram page is mapped at when accessed
+        DEFC PROF_VIRT_ADDR = 0x4000
+
+        SECTION KERNEL_DRV_TEXT
+profiler_init:
+        xor a
+        ld (prof_page), a
+        ld (prof_running), a
+        ret
+
+
+profiler_deinit:
+        ld a, (prof_page)
+        or a
+        call nz, _profiler_free
+        xor a
+        ret
+
+
+        ; Open the profiler, the histogram will be read from the beginning
+        ; Parameters:
+        ;       BC - Name of the file to open
+        ;       A  - Flags
+        ; Returns:
+        ;       A - ERR_SUCCESS
+profiler_open:
+        ld hl, 0
+        ld (prof_read_pos), hl
+profiler_close:
+        xor a
+        ret
+
+
+        ; Perform an I/O requested by the user application.
+        ; Parameters:
+        ;       B - Dev number the I/O request is performed on.
+        ;       C - Command number, PROF_CMD_*
+        ;       DE - 16-bit parameter, unused.
+        ; Returns:
+        ;       A - ERR_SUCCESS on success, error code else
+        ; Alters:
+        ;       A, BC, DE, HL
+profiler_ioctl:
+        ld a, c
+        cp PROF_CMD_START
+        jr z, _profiler_start
+        cp PROF_CMD_STOP
+        jr z, _profiler_stop
+        cp PROF_CMD_FREE
+        jr z, _profiler_free
+        ld a, ERR_INVALID_PARAMETER
+        ret
+
+        ; Clear the histogram and start sampling, allocate the page if not done yet
+_profiler_start:
+        call _profiler_stop
+        ld a, (prof_page)
+        or a
+        jr nz, _profiler_start_clear
+        MMU_ALLOC_PAGE()
+        or a
+        ret nz
+        ld a, b
+        ld (prof_page), a
+_profiler_start_clear:
+        ld b, a
+        MMU_GET_PAGE_NUMBER(MMU_PAGE_1)
+        ld c, a
+        ld a, b
+        MMU_SET_PAGE_NUMBER(MMU_PAGE_1)
+        ; Clear the counters and the header
+        ld hl, PROF_VIRT_ADDR
+        ld de, PROF_VIRT_ADDR + 1
+        ld (hl), 0
+        push bc
+        ld bc, PROF_DUMP_SIZE - 1
+        ldir
+        pop bc
+        ld hl, PROF_VIRT_ADDR + PROF_HEADER_OFF
+        ld (hl), PROF_MAGIC & 0xff
+        inc hl
+        ld (hl), PROF_MAGIC >> 8
+        inc hl
+        ld (hl), PROF_VERSION
+        inc hl
+        ld (hl), PROF_BUCKET_SHIFT
+        ld a, c
+        MMU_SET_PAGE_NUMBER(MMU_PAGE_1)
+        ; Start sampling, the page number in `prof_running` is used by the interrupt handler
+        ld a, b
+        ld (prof_running), a
+        ld hl, 0
+        ld (prof_read_pos), hl
+        xor a
+        ret
+
+_profiler_stop:
+        xor a
+        ld (prof_running), a
+        ret
+
+        ; Stop sampling and give the page back to the system
+_profiler_free:
+        call _profiler_stop
+        ld a, (prof_page)
+        or a
+        ret z
+        MMU_FREE_PAGE()
+        xor a
+        ld (prof_page), a
+        ret
+
+
+        ; Read the histogram, the histogram page must have been allocated.
+        ; Parameters:
+        ;       DE - Destination buffer.
+        ;       BC - Size to read in bytes.
+        ; Returns:
+        ;       A  - ERR_SUCCESS on success, error code else
+        ;       BC - Number of bytes read, 0 once the whole histogram has been read
+        ; Alters:
+        ;       A, BC, DE, HL
+profiler_read:
+        ld a, (prof_page)
+        or a
+        jr z, _profiler_read_empty
+        ; BC = min(BC, PROF_DUMP_SIZE - pos)
+        push de
+        ld hl, (prof_read_pos)
+        ex de, hl
+        ld hl, PROF_DUMP_SIZE
+        or a
+        sbc hl, de
+        ; HL is the number of remaining bytes
+        sbc hl, bc
+        jr nc, _profiler_read_size
+        add hl, bc
+        ld b, h
+        ld c, l
+_profiler_read_size:
+        pop de
+        ld a, b
+        or c
+        ret z
+        ; Make sure the user buffer is not in page 1, the histogram will be mapped there
+        call zos_sys_reserve_page_1
+        push hl
+        MMU_GET_PAGE_NUMBER(MMU_PAGE_1)
+        push af
+        ld a, (prof_page)
+        MMU_SET_PAGE_NUMBER(MMU_PAGE_1)
+        ld hl, (prof_read_pos)
+        push hl
+        push bc
+        add hl, bc
+        ld (prof_read_pos), hl
+        pop bc
+        pop hl
+        push bc
+        ld a, h
+        add PROF_VIRT_ADDR >> 8
+        ld h, a
+        ldir
+        pop bc
+        pop af
+        MMU_SET_PAGE_NUMBER(MMU_PAGE_1)
+        pop hl
+        call zos_sys_restore_pages
+        xor a
+        ret
+_profiler_read_empty:
+        ld bc, 0
+        ret
+
+
+        ; Routine called on every V-blank interrupt, the kernel RAM is mapped in page 3.
+        ; Parameters:
+        ;       HL - Interrupted PC
+        ;       D - Page that was mapped in page 3 when the interrupt occurred
+        ; Returns:
+        ;       None
+        ; Alters:
+        ;       A, BC, HL, must not alter DE
+        PUBLIC profiler_sample
+profiler_sample:
+        ld a, (prof_running)
+        or a
+        ret z
+        ld c, a
+        ; Get the physical page the PC is in, the top two bits of the address give the page
+        ; index, which is what the MMU expects when reading it
+        ld a, h
+        cp 0xc0
+        ld a, d
+        jr nc, _profiler_sample_page
+        ld a, h
+        in a, (MMU_PAGE_0)
+_profiler_sample_page:
+        ld b, a
+        MMU_GET_PAGE_NUMBER(MMU_PAGE_1)
+        push af
+        ld a, c
+        MMU_SET_PAGE_NUMBER(MMU_PAGE_1)
+        ; Address of the counter: PROF_VIRT_ADDR + (PC >> PROF_BUCKET_SHIFT) * 2
+        REPT PROF_BUCKET_SHIFT - 1
+        srl h
+        rr l
+        ENDR
+        res 0, l
+        ld a, h
+        or PROF_VIRT_ADDR >> 8
+        ld h, a
+        call _profiler_inc
+        ; Counter of the physical page
+        ld l, b
+        ld h, 0
+        add hl, hl
+        ld bc, PROF_VIRT_ADDR + PROF_PAGES_OFF
+        add hl, bc
+        call _profiler_inc
+        ; 32-bit number of samples
+        ld hl, PROF_VIRT_ADDR + PROF_HEADER_OFF + prof_hdr_samples_t
+        inc (hl)
+        jr nz, _profiler_sample_end
+        inc hl
+        inc (hl)
+        jr nz, _profiler_sample_end
+        inc hl
+        inc (hl)
+        jr nz, _profiler_sample_end
+        inc hl
+        inc (hl)
+_profiler_sample_end:
+        pop af
+        MMU_SET_PAGE_NUMBER(MMU_PAGE_1)
+        ret
+
+        ; Increment the 16-bit counter pointed by HL, saturate at 0xFFFF
+_profiler_inc:
+        inc (hl)
+        ret nz
+        inc hl
+        inc (hl)
+        ret nz
+        dec (hl)
+        dec hl
+        dec (hl)
+        ret
+
+
+        ; The following functions don't make sense for the profiler
+profiler_write:
+profiler_seek:
+        ld a, ERR_NOT_SUPPORTED
+        ret
+
+
+        SECTION DRIVER_BSS
+        ; Physical page of the histogram, 0 if not allocated
+prof_page: DEFS 1
+        ; Same as `prof_page` when sampling, 0 else
+prof_running: DEFS 1
+prof_read_pos: DEFS 2
+
+
+        SECTION KERNEL_DRV_VECTORS
+NEW_DRIVER_STRUCT("PROF", \
+                  profiler_init, \
+                  profiler_read, profiler_write, \
+                  profiler_open, profiler_close, \
+                  profiler_seek, profiler_ioctl, \
+                  profiler_deinit)
@@ -9,6 +9,7 @@
         INCLUDE "vfs_h.asm"
         INCLUDE "disks_h.asm"
         INCLUDE "interrupt_h.asm"
+        INCLUDE "strutils_h.asm"
     IF CONFIG_ENABLE_EMULATION_HOSTFS
         INCLUDE "fs/hostfs_h.asm"
     ENDIF
@@ -18,11 +19,8 @@
 romdisk_init:
     IF CONFIG_ENABLE_EMULATION_HOSTFS
         ; Check if the host's file system layer is present.
-        ld a, OP_WHOAMI
-        out (IO_OPERATION), a
-        in a, (IO_OPERATION)
-        ; Arbitrary value returned by the host FS layer
-        cp 0xd3
+        call zos_fs_hostfs_probe
+        or a
         jr nz, _no_hostfs
 
         ; Register a HostFS, no need to create a new file for that
@@ -168,7 +166,7 @@ _romdisk_read_to_page1:
         inc a
         MMU_SET_PAGE_NUMBER(MMU_PAGE_2)
 _romdisk_copy_no_remap:
-        ldir
+        call memcpy
         pop bc
         ; Map back the MMU config
         ld a, (_romdisk_mmu_conf)
@@ -210,7 +208,7 @@ _romdisk_read_to_page2:
         inc a
         MMU_SET_PAGE_NUMBER(MMU_PAGE_1)
 _romdisk_copy_no_remap_1:
-        ldir
+        call memcpy
         pop bc
         ld a, (_romdisk_mmu_conf)
         MMU_SET_PAGE_NUMBER(MMU_PAGE_1)
@@ -282,7 +280,7 @@ _romdisk_copy_if_cross_boundary:
         ; BC has now the first size to copy, HL has the "new size" to return.
         ; Store the new size on the stack and get the original address
         ex (sp), hl
-        ldir
+        call memcpy
         ; Perform the copy, BC is 0 now, give to it the size to return
         pop bc
         ; HL is now pointing to the next MMU page, so it's either 0x8000 or 0xC000,
@@ -43,7 +43,30 @@
 
 
     SECTION KERNEL_DRV_TEXT
+  IF CONFIG_KERNEL_LAZY_DISK_PROBE
 tf_init:
+    ; Do not initialize the card on boot, mount the disk right away and let
+    ; the kernel call tf_probe on the first access.
+    ld a, TF_DISK_LETTER
+    ld e, FS_ZEALFS
+    ld hl, _tf_driver
+    ld bc, tf_probe
+    call zos_disks_mount_lazy
+    or a
+    ret nz
+    ld a, ERR_DRIVER_HIDDEN
+    ret
+
+    ; Probe routine, called by the kernel the first time the disk is accessed.
+    ; Initialize the card and look for the ZealFS partition.
+    ; Returns:
+    ;   A - ERR_SUCCESS if the card and the partition were found, error code else
+    ; Alters:
+    ;   A, BC, DE, HL
+tf_probe:
+  ELSE
+tf_init:
+  ENDIF
     ; Map the SPI controller
     ld a, SPI_CONTROLLER_IDX
     out (IO_MAPPER_BANK), a
@@ -96,6 +119,11 @@ tf_init:
     ex de, hl
     call zos_log_info
 
+  IF CONFIG_KERNEL_LAZY_DISK_PROBE
+    ; The disk is already mounted, nothing else to do
+    xor a
+    ret
+  ELSE
     ; Register the disk as ZealFS v2
     ld a, TF_DISK_LETTER
     ; Put the file system in E (rawtable)
@@ -107,6 +135,7 @@ tf_init:
     ; directly used by users as a block device (yet?).
     ld a, ERR_DRIVER_HIDDEN
     ret
+  ENDIF
 
 _addr:
     DEFM "LBA ", FORMAT_U8_HEX, FORMAT_U8_HEX, FORMAT_U8_HEX, FORMAT_U8_HEX, "\n", 0
@@ -640,7 +669,7 @@ tf_card_write_block:
     push hl
     ld de, rd_buf
     ld bc, 512
-    ldir
+    call memcpy
 @no_cache_update:
     pop bc
     pop de
@@ -915,7 +944,7 @@ tf_read_not_aligned:
     ; Get the size to read from the stack but keep it on the stack
     pop bc
     push bc
-    ldir
+    call memcpy
     pop bc
     ; Subtract this amount of bytes to the remaining buffer size
     ld hl, (_tf_total_size)
@@ -1111,7 +1140,7 @@ tf_write:
     ; Get the size to transfer from the user buffer to the temporary buffer
     pop bc
     push bc
-    ldir
+    call memcpy
     pop bc
     ; HL contains the rest of the data to write to the TF card
     ld (_tf_buffer), hl
@@ -12,6 +12,9 @@
         INCLUDE "drivers/video_text_h.asm"
 
         EXTERN zos_sys_remap_de_page_2
+    IF CONFIG_KERNEL_JOBS
+        EXTERN zos_job_yield
+    ENDIF
 
         MACRO DEFAULT_BG_COLOR _
             DEFM "16"
@@ -361,6 +364,11 @@ _uart_clear_str_end:
         ; Alters:
         ;       This function can alter any register.
 uart_read:
+    IF CONFIG_KERNEL_JOBS
+        ; The reception is performed with the interrupts disabled, let the other jobs run
+        ; before waiting for the incoming bytes
+        call zos_job_yield
+    ENDIF
         ; Prepare the buffer to receive in HL
         ex de, hl
         ; Put the baudrate in D
@@ -51,6 +51,10 @@ ifdef CONFIG_TARGET_ENABLE_TFCARD
 	SRCS += tf.asm
 endif
 
+ifdef CONFIG_TARGET_ENABLE_PROFILER
+	SRCS += profiler.asm
+endif
+
 DISK_PATH := $(ZOS_PATH)/romdisk/init/disk.img
 INIT_PATH := $(if $(CONFIG_ROMDISK_INCLUDE_INIT_BIN),$(ZOS_PATH)/romdisk/init/build/init.bin,)
 
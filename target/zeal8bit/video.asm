@@ -14,6 +14,7 @@
     EXTERN zos_sys_reserve_page_1
     EXTERN zos_sys_restore_pages
     EXTERN zos_sys_remap_de_page_2
+    EXTERN zos_sys_remap_user_pages
     EXTERN zos_vfs_set_stdout
 
 
@@ -364,6 +365,256 @@ _video_vram_set_loop:
     ret
 
 
+    ; Copy a rectangle of characters, and optionally of colors, straight into the text VRAM.
+    ; The coordinates are relative to the visible screen, the current scroll value is taken
+    ; into account. The cursor is not moved.
+    ; Parameters:
+    ;   DE - Address of the blit_t structure
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, ERR_INVALID_PARAMETER if the rectangle is not on screen
+    ; Alters:
+    ;   A, BC, DE, HL
+_video_ioctl_blit:
+    ; Copy the structure, the user pages are going to be remapped
+    call zos_sys_remap_de_page_2
+    ex de, hl
+    ld de, video_blit
+    ld bc, blit_end_t
+    ldir
+    call zos_sys_remap_user_pages
+_video_blit:
+    ; Check that the rectangle is not empty and fits on screen
+    ld a, (video_blit + blit_w_t)
+    dec a
+    cp VID_640480_X_MAX
+    jp nc, _video_invalid_param
+    ld hl, video_blit + blit_x_t
+    add (hl)
+    jp c, _video_invalid_param
+    cp VID_640480_X_MAX
+    jp nc, _video_invalid_param
+    ld a, (video_blit + blit_h_t)
+    dec a
+    cp VID_640480_Y_MAX
+    jp nc, _video_invalid_param
+    inc hl
+    add (hl)
+    jp c, _video_invalid_param
+    cp VID_640480_Y_MAX
+    jp nc, _video_invalid_param
+    ; Get the row, in VRAM, of the first line: (y + scroll) % VID_640480_Y_MAX
+    MAP_TEXT_CTRL()
+    in a, (IO_TEXT_SCROLL_Y)
+    add (hl)
+    cp VID_640480_Y_MAX
+    jr c, _video_blit_row
+    sub VID_640480_Y_MAX
+_video_blit_row:
+    ld (video_blit_vram_row), a
+    ld hl, (video_blit + blit_chars_t)
+    ld de, 0
+    ld a, (video_blit + blit_fill_t)
+    call _video_blit_plane
+    ; The colors are 0x1000 bytes after the characters
+    ld hl, (video_blit + blit_colors_t)
+    ld de, 0x1000
+    ld a, (video_blit + blit_color_t)
+    call _video_blit_plane
+    ; Map back the user pages that were replaced by the VRAM
+    call zos_sys_remap_user_pages
+    xor a
+    ret
+
+
+    ; Copy (or fill) the rectangle described in `video_blit` to one plane of the VRAM
+    ; Parameters:
+    ;   HL - Source buffer, NULL to fill the rectangle with A
+    ;   DE - Offset of the plane in the VRAM
+    ;   A - Value to fill the rectangle with if HL is NULL
+    ; Alters:
+    ;   A, BC, DE, HL
+_video_blit_plane:
+    ld (video_blit_value), a
+    ; The previous plane may have replaced a user page with the VRAM
+    call zos_sys_remap_user_pages
+    ; Map the VRAM in page 1, or page 2 if the source buffer is in page 1
+    ld a, h
+    or l
+    jr z, _video_blit_plane_page_1
+    ex de, hl
+    call zos_sys_remap_de_page_2
+    ex de, hl
+    KERNEL_MMU_PAGE_OF_VIRT_ADDR(h)
+    dec a
+    jr nz, _video_blit_plane_page_1
+    MMU_MAP_PHYS_ADDR(MMU_PAGE_2, VID_MEM_LAYER0_ADDR)
+    ld a, 0x80
+    jr _video_blit_plane_mapped
+_video_blit_plane_page_1:
+    MMU_MAP_PHYS_ADDR(MMU_PAGE_1, VID_MEM_LAYER0_ADDR)
+    ld a, 0x40
+_video_blit_plane_mapped:
+    add d
+    ld d, a
+    ; Destination address: DE + row * 80 + x
+    push hl
+    ld a, (video_blit_vram_row)
+    ld l, a
+    ld h, 0
+    ASSERT(VID_640480_X_MAX == 80)
+    add hl, hl
+    add hl, hl
+    add hl, hl
+    add hl, hl
+    ld b, h
+    ld c, l
+    add hl, hl
+    add hl, hl
+    add hl, bc
+    ld a, (video_blit + blit_x_t)
+    ADD_HL_A()
+    add hl, de
+    ex de, hl
+    pop hl
+    ; C is the VRAM row, B the number of lines to copy
+    ld a, (video_blit_vram_row)
+    ld c, a
+    ld a, (video_blit + blit_h_t)
+    ld b, a
+_video_blit_plane_loop:
+    push bc
+    ld a, (video_blit + blit_w_t)
+    ld c, a
+    ld a, h
+    or l
+    jr nz, _video_blit_plane_copy
+    ; Fill the line: write the first byte and copy it over the rest of the line
+    ld a, (video_blit_value)
+    ld (de), a
+    ld h, d
+    ld l, e
+    inc de
+    dec c
+    call _video_ldi_c
+    ld hl, 0
+    jr _video_blit_plane_next
+_video_blit_plane_copy:
+    call _video_ldi_c
+_video_blit_plane_next:
+    ; Go to the next line, DE += 80 - w
+    ld a, (video_blit + blit_w_t)
+    neg
+    add VID_640480_X_MAX
+    ex de, hl
+    ADD_HL_A()
+    ex de, hl
+    pop bc
+    ; The last line of the VRAM is followed by the first one
+    inc c
+    ld a, c
+    cp VID_640480_Y_MAX
+    jr nz, _video_blit_plane_wrapped
+    ld c, 0
+    ex de, hl
+    push bc
+    ld bc, -VID_640480_TOTAL
+    add hl, bc
+    pop bc
+    ex de, hl
+_video_blit_plane_wrapped:
+    djnz _video_blit_plane_loop
+    ret
+
+
+    ; Copy C bytes, at most 80, from HL to DE with unrolled LDI instructions
+    ; Parameters:
+    ;   HL - Source
+    ;   DE - Destination
+    ;   C - Number of bytes to copy
+    ; Returns:
+    ;   HL - Source + C
+    ;   DE - Destination + C
+    ; Alters:
+    ;   A, BC, DE, HL
+_video_ldi_c:
+    ld a, c
+    or a
+    ret z
+    ; Jump C instructions before the end of the LDI block
+    push hl
+    ld hl, _video_ldi_end
+    ld b, 0
+    sbc hl, bc
+    sbc hl, bc
+    ex (sp), hl
+    ret
+    REPT VID_640480_X_MAX
+    ldi
+    ENDR
+_video_ldi_end:
+    ret
+
+
+    ; Scroll the content of the screen by E lines thanks to the hardware scroll register.
+    ; The cursor keeps its position on screen and the lines revealed are cleared.
+    ; Parameters:
+    ;   E - Signed number of lines, positive to move the content up, negative to move it down.
+    ; Returns:
+    ;   A - ERR_SUCCESS on success, ERR_INVALID_PARAMETER if E is out of the screen
+    ; Alters:
+    ;   A, BC, DE, HL
+_video_ioctl_scroll:
+    ld a, e
+    or a
+    ret z
+    jp p, _video_ioctl_scroll_positive
+    neg
+_video_ioctl_scroll_positive:
+    cp VID_640480_Y_MAX
+    jp nc, _video_invalid_param
+    ; Number of lines to clear
+    ld (video_blit + blit_h_t), a
+    MAP_TEXT_CTRL()
+    in a, (IO_TEXT_SCROLL_Y)
+    call _video_add_lines
+    out (IO_TEXT_SCROLL_Y), a
+    in a, (IO_TEXT_CURS_Y)
+    call _video_add_lines
+    out (IO_TEXT_CURS_Y), a
+    ; Clear the lines revealed: at the bottom if the content moved up, at the top else
+    ld hl, 0
+    ld (video_blit + blit_chars_t), hl
+    ld (video_blit + blit_colors_t), hl
+    ld (video_blit + blit_fill_t), hl
+    ld (video_blit + blit_x_t), hl
+    ld a, VID_640480_X_MAX
+    ld (video_blit + blit_w_t), a
+    ld a, e
+    or a
+    jp m, _video_blit
+    ld a, VID_640480_Y_MAX
+    sub e
+    ld (video_blit + blit_y_t), a
+    jp _video_blit
+
+    ; Add E lines to the line A, modulo the number of lines
+    ; Parameters:
+    ;   A - Line, in [0;VID_640480_Y_MAX[
+    ;   E - Signed number of lines, in ]-VID_640480_Y_MAX;VID_640480_Y_MAX[
+    ; Returns:
+    ;   A - New line
+_video_add_lines:
+    add e
+    jp m, _video_add_lines_negative
+    cp VID_640480_Y_MAX
+    ret c
+    sub VID_640480_Y_MAX
+    ret
+_video_add_lines_negative:
+    add VID_640480_Y_MAX
+    ret
+
+
 _video_ioctl_cmd_table:
     DEFW _video_ioctl_get_attr
     DEFW _video_ioctl_get_area
@@ -373,6 +624,8 @@ _video_ioctl_cmd_table:
     DEFW _video_ioctl_set_colors
     DEFW _video_ioctl_clear_screen
     DEFW _video_ioctl_reset_screen
+    DEFW _video_ioctl_blit
+    DEFW _video_ioctl_scroll
 
 
     ; Write function, called every time user application needs to output chars
@@ -539,6 +792,10 @@ video_vblank_isr:
     ld bc, 16
     add hl, bc
     ld (vblank_count), hl
+  IF CONFIG_KERNEL_DATE_CACHE
+    ; The kernel interpolates the date from this counter, notify it on overflow
+    jp c, zos_date_cache_invalidate
+  ENDIF
     ret
 
     ;======================================================================;
@@ -650,6 +907,55 @@ print_buffer:
     ld a, b
     or c
     ret z
+    ld a, (de)
+    cp ' '
+    jr c, _print_buffer_char
+    ; Printable characters that fit on the current line can't trigger any scroll, thanks
+    ; to IO_TEXT_WAIT_ON_WRAP_BIT, output them all at once with OTIR.
+    in a, (IO_TEXT_CURS_X)
+    sub VID_640480_X_MAX
+    jr z, _print_buffer_char
+    neg
+    ; A is the number of columns left on the line, limit it to BC
+    ld h, a
+    ld a, b
+    or a
+    jr nz, _print_buffer_limit
+    ld a, c
+    cp h
+    jr nc, _print_buffer_limit
+    ld h, c
+_print_buffer_limit:
+    ; Count the printable characters, at most H, in L
+    push de
+    ld l, 0
+_print_buffer_count:
+    ld a, (de)
+    cp ' '
+    jr c, _print_buffer_output
+    inc de
+    inc l
+    ld a, l
+    cp h
+    jr nz, _print_buffer_count
+_print_buffer_output:
+    pop de
+    ; BC -= L
+    ld a, c
+    sub l
+    ld c, a
+    jr nc, _print_buffer_no_carry
+    dec b
+_print_buffer_no_carry:
+    push bc
+    ld b, l
+    ld c, IO_TEXT_PRINT_CHAR
+    ex de, hl
+    otir
+    ex de, hl
+    pop bc
+    jp print_buffer
+_print_buffer_char:
     ld a, (de)
     call print_char
     inc de
@@ -760,8 +1066,13 @@ _erase_line_loop:
 
 
     SECTION DRIVER_BSS
+    ; Also used by the keyboard driver to stamp the keys received
+    PUBLIC vblank_count
 vblank_count:  DEFS 2
 mmu_page_back: DEFS 1
+video_blit: DEFS blit_end_t
+video_blit_vram_row: DEFS 1
+video_blit_value: DEFS 1
 
 
     SECTION KERNEL_DRV_VECTORS
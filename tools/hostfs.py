@@ -0,0 +1,367 @@
+#!/usr/bin/env python3
+
+#
+# SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+#
+# SPDX-License-Identifier: Apache-2.0
+
+# Reference implementation of the host side of the host file system (hostfs), serving a local
+# directory to Zeal 8-bit OS running in an emulator. Both versions of the protocol, described in
+# `include/fs/hostfs_h.asm`, are supported.
+#
+# The emulator forwards the accesses to the I/O ports 0xC0-0xCF to an instance of `HostFS` and
+# gives it two routines to access the Z80 memory through the current MMU configuration:
+#
+#   fs = HostFS("/path/to/dir", read_mem, write_mem)
+#   # in the I/O write handler
+#   fs.io_write(port, value)
+#   # in the I/O read handler
+#   value = fs.io_read(port)
+#
+# where `read_mem(address, length)` returns `bytes` and `write_mem(address, data)` writes them,
+# both with 16-bit virtual addresses. The operations are executed synchronously, the status is
+# never busy.
+
+import errno
+import os
+import struct
+import time
+
+IO_ARG0_REG  = 0xC0
+IO_OPERATION = 0xCF
+
+OP_WHOAMI  = 0
+OP_OPEN    = 1
+OP_STAT    = 2
+OP_READ    = 3
+OP_WRITE   = 4
+OP_CLOSE   = 5
+OP_OPENDIR = 6
+OP_READDIR = 7
+OP_MKDIR   = 8
+OP_RM      = 9
+OP_V2      = 0x80
+
+WHOAMI_MAGIC = 0xd3
+VERSION_2    = 2
+
+ERR_SUCCESS           = 0
+ERR_FAILURE           = 1
+ERR_NOT_SUPPORTED     = 3
+ERR_NO_SUCH_ENTRY     = 4
+ERR_INVALID_PARAMETER = 6
+ERR_INVALID_PATH      = 11
+ERR_ALREADY_EXIST     = 15
+ERR_READ_ONLY         = 18
+ERR_CANNOT_REGISTER   = 20
+ERR_NO_MORE_ENTRIES   = 21
+ERR_NOT_A_DIR         = 23
+ERR_NOT_A_FILE        = 24
+ERR_DIR_NOT_EMPTY     = 26
+
+ERRNO_TO_ERR = {
+    errno.ENOENT:    ERR_NO_SUCH_ENTRY,
+    errno.EEXIST:    ERR_ALREADY_EXIST,
+    errno.EACCES:    ERR_READ_ONLY,
+    errno.EROFS:     ERR_READ_ONLY,
+    errno.ENOTDIR:   ERR_NOT_A_DIR,
+    errno.EISDIR:    ERR_NOT_A_FILE,
+    errno.ENOTEMPTY: ERR_DIR_NOT_EMPTY,
+}
+
+# Opening flags, as defined in `vfs_h.asm`
+O_WRONLY = 1
+O_RDWR   = 2
+O_TRUNC  = 4
+O_CREAT  = 16
+
+STAT_FLAGS_IS_FILE = 1
+STAT_FLAGS_IS_DIR  = 0
+
+NAME_LENGTH     = 16
+DIR_ENTRY_SIZE  = 1 + NAME_LENGTH
+# Offset of the fields in the kernel opened file structure, used by the first version only
+OPN_FILE_OFF    = 8
+OPN_FILE_USR    = 12
+
+# Parameter block of the second version
+BLOCK_FMT       = "<BBHIBH"
+BLOCK_SIZE      = struct.calcsize(BLOCK_FMT)
+IOV_FMT         = "<HH"
+IOV_SIZE        = struct.calcsize(IOV_FMT)
+READDIR_STAT    = 1 << 0
+
+MAX_DESCRIPTORS = 256
+
+
+def to_bcd(value):
+    return ((value // 10) << 4) | (value % 10)
+
+
+def date_bytes(mtime):
+    t = time.localtime(mtime)
+    return bytes([
+        to_bcd(t.tm_year // 100), to_bcd(t.tm_year % 100),
+        to_bcd(t.tm_mon), to_bcd(t.tm_mday),
+        # Sunday is 1
+        to_bcd((t.tm_wday + 1) % 7 + 1),
+        to_bcd(t.tm_hour), to_bcd(t.tm_min), to_bcd(t.tm_sec),
+    ])
+
+
+def name_bytes(name):
+    return name.encode("ascii", "replace")[:NAME_LENGTH].ljust(NAME_LENGTH, b"\0")
+
+
+class Descriptor:
+    def __init__(self, path, fd=None):
+        self.path = path
+        self.fd = fd
+        # Entries of a directory, listed when opened, and cursor of the first version
+        self.entries = None
+        self.cursor = 0
+
+    @property
+    def is_dir(self):
+        return self.fd is None
+
+
+class HostFS:
+    def __init__(self, root, read_mem, write_mem):
+        self.root = os.path.realpath(root)
+        self.read_mem = read_mem
+        self.write_mem = write_mem
+        self.args = bytearray(8)
+        self.status = 0
+        self.descriptors = [None] * MAX_DESCRIPTORS
+
+    # ---------------------------- I/O ports ---------------------------- #
+
+    def io_write(self, port, value):
+        port &= 0xff
+        if IO_ARG0_REG <= port < IO_ARG0_REG + len(self.args):
+            self.args[port - IO_ARG0_REG] = value & 0xff
+        elif port == IO_OPERATION:
+            self.status = self.execute(value & 0xff)
+
+    def io_read(self, port):
+        port &= 0xff
+        if IO_ARG0_REG <= port < IO_ARG0_REG + len(self.args):
+            return self.args[port - IO_ARG0_REG]
+        if port == IO_OPERATION:
+            return self.status
+        return 0xff
+
+    def arg16(self, index):
+        return self.args[index] | (self.args[index + 1] << 8)
+
+    def set_arg16(self, index, value):
+        self.args[index] = value & 0xff
+        self.args[index + 1] = (value >> 8) & 0xff
+
+    def execute(self, op):
+        try:
+            if op == OP_WHOAMI:
+                if self.args[0] >= VERSION_2:
+                    self.args[1] = VERSION_2
+                return WHOAMI_MAGIC
+            if op & OP_V2:
+                return self.execute_v2(op & ~OP_V2)
+            return self.execute_v1(op)
+        except OSError as e:
+            return ERRNO_TO_ERR.get(e.errno, ERR_FAILURE)
+
+    # ---------------------------- Helpers ---------------------------- #
+
+    def read_string(self, address):
+        data = bytearray()
+        while len(data) < 256:
+            byte = self.read_mem((address + len(data)) & 0xffff, 1)[0]
+            if byte == 0:
+                break
+            data.append(byte)
+        return data.decode("ascii", "replace")
+
+    def resolve(self, address):
+        """Get the host path of the absolute path given by the kernel, it must stay in the root."""
+        path = os.path.normpath(os.path.join(self.root, self.read_string(address).lstrip("/")))
+        if path != self.root and not path.startswith(self.root + os.sep):
+            raise OSError(errno.ENOENT, "outside of the root")
+        return path
+
+    def allocate(self, desc):
+        for i, entry in enumerate(self.descriptors):
+            if entry is None:
+                self.descriptors[i] = desc
+                return i
+        return None
+
+    def descriptor(self, index):
+        desc = self.descriptors[index]
+        if desc is None:
+            raise OSError(errno.EBADF, "invalid descriptor")
+        return desc
+
+    def list_dir(self, path):
+        entries = []
+        for name in sorted(os.listdir(path)):
+            # Names that don't fit in the entries can't be opened by the kernel
+            if len(name) > NAME_LENGTH:
+                continue
+            entries.append(name)
+        return entries
+
+    def open_path(self, path, flags):
+        """Open a file or a directory, returns the descriptor index, or an error code."""
+        if os.path.isdir(path):
+            desc = Descriptor(path)
+            desc.entries = self.list_dir(path)
+        else:
+            access = os.O_RDONLY
+            if flags & O_RDWR:
+                access = os.O_RDWR
+            elif flags & O_WRONLY:
+                access = os.O_WRONLY
+            if flags & O_TRUNC:
+                access |= os.O_TRUNC
+            if flags & O_CREAT:
+                access |= os.O_CREAT
+            desc = Descriptor(path, os.open(path, access, 0o644))
+        index = self.allocate(desc)
+        if index is None:
+            self.close_desc(desc)
+            return None
+        return index
+
+    def close_desc(self, desc):
+        if desc.fd is not None:
+            os.close(desc.fd)
+
+    def stat_bytes(self, desc, with_size):
+        """Size (optional), date and name of an opened entry"""
+        st = os.stat(desc.path) if desc.is_dir else os.fstat(desc.fd)
+        name = "/" if desc.path == self.root else os.path.basename(desc.path)
+        data = date_bytes(st.st_mtime) + name_bytes(name)
+        if with_size:
+            size = 0 if desc.is_dir else st.st_size
+            data = struct.pack("<I", size & 0xffffffff) + data
+        return data
+
+    def entry_bytes(self, desc, name, with_stat):
+        path = os.path.join(desc.path, name)
+        st = os.stat(path)
+        is_dir = os.path.isdir(path)
+        flags = STAT_FLAGS_IS_DIR if is_dir else STAT_FLAGS_IS_FILE
+        if not with_stat:
+            return bytes([flags]) + name_bytes(name)
+        size = 0 if is_dir else st.st_size
+        return bytes([flags]) + struct.pack("<I", size & 0xffffffff) + date_bytes(st.st_mtime) + name_bytes(name)
+
+    def transfer(self, desc, op, offset, vectors):
+        """Read or write all the vectors from the given offset, returns the number of bytes transferred"""
+        if desc.is_dir:
+            raise OSError(errno.EISDIR, "not a file")
+        total = 0
+        for address, length in vectors:
+            if op == OP_READ:
+                data = os.pread(desc.fd, length, offset + total)
+                self.write_mem(address, data)
+                count = len(data)
+            else:
+                count = os.pwrite(desc.fd, self.read_mem(address, length), offset + total)
+            total += count
+            if count < length:
+                break
+        return total
+
+    # ---------------------------- First version ---------------------------- #
+
+    def execute_v1(self, op):
+        if op == OP_OPEN or op == OP_OPENDIR:
+            path = self.resolve(self.arg16(1))
+            if op == OP_OPENDIR and not os.path.isdir(path):
+                return ERR_NOT_A_DIR
+            index = self.open_path(path, self.args[0] if op == OP_OPEN else 0)
+            if index is None:
+                return ERR_CANNOT_REGISTER
+            desc = self.descriptors[index]
+            size = 0 if desc.is_dir else os.fstat(desc.fd).st_size
+            self.args[0:4] = struct.pack("<I", size & 0xffffffff)
+            self.args[4] = index
+            self.args[5] = 1 if desc.is_dir else 0
+            return ERR_SUCCESS
+        if op == OP_STAT:
+            desc = self.descriptor(self.args[2])
+            # The kernel gives the date field for files and the size field for directories
+            self.write_mem(self.arg16(0), self.stat_bytes(desc, desc.is_dir))
+            return ERR_SUCCESS
+        if op == OP_READ or op == OP_WRITE:
+            opened = self.read_mem(self.arg16(0), OPN_FILE_USR + 1)
+            offset = struct.unpack_from("<I", opened, OPN_FILE_OFF)[0]
+            desc = self.descriptor(opened[OPN_FILE_USR])
+            count = self.transfer(desc, op, offset, [(self.arg16(2), self.arg16(4))])
+            self.set_arg16(4, count)
+            return ERR_SUCCESS
+        if op == OP_CLOSE:
+            desc = self.descriptor(self.args[0])
+            self.descriptors[self.args[0]] = None
+            self.close_desc(desc)
+            return ERR_SUCCESS
+        if op == OP_READDIR:
+            desc = self.descriptor(self.args[2])
+            if not desc.is_dir:
+                return ERR_NOT_A_DIR
+            if desc.cursor >= len(desc.entries):
+                return ERR_NO_MORE_ENTRIES
+            self.write_mem(self.arg16(0), self.entry_bytes(desc, desc.entries[desc.cursor], False))
+            desc.cursor += 1
+            return ERR_SUCCESS
+        if op == OP_MKDIR:
+            os.mkdir(self.resolve(self.arg16(1)))
+            return ERR_SUCCESS
+        if op == OP_RM:
+            path = self.resolve(self.arg16(1))
+            if os.path.isdir(path):
+                os.rmdir(path)
+            else:
+                os.remove(path)
+            return ERR_SUCCESS
+        return ERR_NOT_SUPPORTED
+
+    # ---------------------------- Second version ---------------------------- #
+
+    def execute_v2(self, op):
+        address = self.arg16(0)
+        fd, flags, addr, offset, count, length = struct.unpack(BLOCK_FMT, self.read_mem(address, BLOCK_SIZE))
+
+        if op == OP_OPEN:
+            index = self.open_path(self.resolve(addr), flags)
+            if index is None:
+                return ERR_CANNOT_REGISTER
+            desc = self.descriptors[index]
+            size = 0 if desc.is_dir else os.fstat(desc.fd).st_size
+            self.write_mem(address, struct.pack(BLOCK_FMT, index, 1 if desc.is_dir else 0, addr,
+                                                size & 0xffffffff, count, length))
+            return ERR_SUCCESS
+        if op == OP_STAT:
+            # Descriptor based, no need to resolve the path again
+            self.write_mem(addr, self.stat_bytes(self.descriptor(fd), True))
+            return ERR_SUCCESS
+        if op == OP_READ or op == OP_WRITE:
+            raw = self.read_mem((address + BLOCK_SIZE) & 0xffff, count * IOV_SIZE)
+            vectors = [struct.unpack_from(IOV_FMT, raw, i * IOV_SIZE) for i in range(count)]
+            total = self.transfer(self.descriptor(fd), op, offset, vectors)
+            self.write_mem(address, struct.pack(BLOCK_FMT, fd, flags, addr, offset, count, total))
+            return ERR_SUCCESS
+        if op == OP_READDIR:
+            desc = self.descriptor(fd)
+            if not desc.is_dir:
+                return ERR_NOT_A_DIR
+            # The offset is the index of the first entry to return, nothing is kept between calls
+            names = desc.entries[offset:offset + count]
+            data = b"".join(self.entry_bytes(desc, name, flags & READDIR_STAT) for name in names)
+            self.write_mem(addr, data)
+            self.write_mem(address, struct.pack(BLOCK_FMT, fd, flags, addr, offset, len(names), length))
+            return ERR_SUCCESS if names else ERR_NO_MORE_ENTRIES
+        # The other operations keep the form of the first version
+        return self.execute_v1(op)
@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+
+#
+# SPDX-FileCopyrightText: 2026 Zeal 8-bit Computer <contact@zeal8bit.com>
+#
+# SPDX-License-Identifier: Apache-2.0
+
+# Symbolize a histogram dumped from the PC-sampling profiler driver (`cp #PROF B:/prof.bin`)
+# thanks to the map files generated by the build: the kernel `os.map` and the programs'
+# map files (`-m` option of z88dk-z80asm, or sdcc's map files).
+
+import argparse
+import re
+import struct
+import sys
+
+PROF_MAGIC       = 0x505a
+PROF_PAGES_COUNT = 256
+PROF_HEADER_FMT  = "<HBBI"
+
+# z88dk-z80asm map line: `symbol = $4000 ; addr, public, , module, section, file:line`
+Z80ASM_LINE = re.compile(r"^\s*(\S+)\s*=\s*\$([0-9A-Fa-f]+)\s*;\s*addr")
+# sdcc (sdld) map line: `     00004000  _main    main`
+SDLD_LINE   = re.compile(r"^\s+(?:C:)?([0-9A-Fa-f]{8})\s+(\S+)")
+
+
+def load_map(path):
+    symbols = []
+    with open(path, "r", errors="replace") as f:
+        for line in f:
+            m = Z80ASM_LINE.match(line)
+            if m:
+                symbols.append((int(m.group(2), 16), m.group(1)))
+                continue
+            m = SDLD_LINE.match(line)
+            if m:
+                symbols.append((int(m.group(1), 16), m.group(2)))
+    return symbols
+
+
+def load_dump(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    header_size = struct.calcsize(PROF_HEADER_FMT)
+    if len(data) < header_size:
+        sys.exit(f"Error: {path} is too small to be a profiler dump")
+    magic, version, shift, samples = struct.unpack_from(PROF_HEADER_FMT, data, len(data) - header_size)
+    if magic != PROF_MAGIC or version != 1:
+        sys.exit(f"Error: {path} is not a profiler dump (magic 0x{magic:04x}, version {version})")
+    buckets_count = 0x10000 >> shift
+    expected = (buckets_count + PROF_PAGES_COUNT) * 2 + header_size
+    if len(data) != expected:
+        sys.exit(f"Error: {path} has {len(data)} bytes, {expected} expected")
+    buckets = struct.unpack_from(f"<{buckets_count}H", data, 0)
+    pages = struct.unpack_from(f"<{PROF_PAGES_COUNT}H", data, buckets_count * 2)
+    return shift, samples, buckets, pages
+
+
+def symbolize(symbols, address):
+    # Look for the closest symbol below the address, `symbols` is sorted
+    lo, hi = 0, len(symbols)
+    while lo < hi:
+        mid = (lo + hi) // 2
+        if symbols[mid][0] <= address:
+            lo = mid + 1
+        else:
+            hi = mid
+    if lo == 0:
+        return "?"
+    return symbols[lo - 1][1]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Zeal 8-bit OS profiler dump symbolizer")
+    parser.add_argument("dump", help="Histogram read from the PROF driver")
+    parser.add_argument("maps", nargs="*", help="Map files of the kernel and the programs that ran")
+    parser.add_argument("-n", "--top", type=int, default=20, help="Number of entries to show (default: 20)")
+    parser.add_argument("-b", "--buckets", action="store_true", help="Show the hottest address blocks too")
+    args = parser.parse_args()
+
+    shift, samples, buckets, pages = load_dump(args.dump)
+    symbols = []
+    for path in args.maps:
+        symbols.extend(load_map(path))
+    symbols.sort()
+
+    total = sum(buckets)
+    print(f"{samples} samples, {total} counted, {1 << shift}-byte blocks")
+    if total == 0:
+        return
+
+    # Sum the blocks per symbol, a block is attributed to the symbol it starts in
+    per_symbol = {}
+    for i, count in enumerate(buckets):
+        if count:
+            name = symbolize(symbols, i << shift)
+            per_symbol[name] = per_symbol.get(name, 0) + count
+
+    print("\n  samples      %  symbol")
+    for name, count in sorted(per_symbol.items(), key=lambda e: -e[1])[:args.top]:
+        print(f"  {count:7}  {100 * count / total:5.1f}  {name}")
+
+    if args.buckets:
+        print("\n  samples      %  address  symbol")
+        hottest = sorted(((c, i) for i, c in enumerate(buckets) if c), reverse=True)[:args.top]
+        for count, i in hottest:
+            address = i << shift
+            print(f"  {count:7}  {100 * count / total:5.1f}  0x{address:04x}   {symbolize(symbols, address)}")
+
+    print("\n  samples      %  physical page")
+    for count, page in sorted(((c, p) for p, c in enumerate(pages) if c), reverse=True):
+        print(f"  {count:7}  {100 * count / total:5.1f}  0x{page:02x} (0x{page << 14:06x})")
+
+
+if __name__ == "__main__":
+    main()